@@ -0,0 +1,228 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_BINARY_H
+#define QYAML_BINARY_H
+
+#include <QByteArray>
+#include <QIODevice>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include "instrument.h"
+
+namespace QYaml {
+
+/*!
+   \brief Binary data to be written as a line wrapped !!binary block
+   scalar.
+
+   Emitting a QByteArray or QPixmap writes its base64 text as a single
+   double quoted line, which for a large image can be megabytes long.
+   WrappedBinary writes a literal block instead, one line per lineLength
+   characters:
+
+   \code
+   image: !!binary |
+     iVBORw0KGgoAAAANSUhEUgAAAEAAAABACAYAAACqaXHeAAAABHNCSVQICAgIfAhkiAAAAAlwSFlz
+     AAAOxAAADsQBlSsOGwAAABl0RVh0U29mdHdhcmUAd3d3Lmlua3NjYXBlLm9yZ5vuPBoAAAAhdEVY
+   \endcode
+
+   This only wraps the lines, it does not save memory. YAML::Emitter has no
+   way to write a scalar in pieces, so text() builds the whole wrapped text,
+   about 4/3 of the source size, and the emitter then copies it into its
+   output. A QIODevice source is read in chunks, which saves holding the
+   source itself, but the peak is still about the same as emitting a
+   QByteArray. The QByteArray, QPixmap and QImage converters read the
+   wrapped form directly.
+
+   \code
+   out << YAML::Key << "image" << YAML::Value << QYaml::WrappedBinary(png);
+
+   QFile file(path);
+   file.open(QIODevice::ReadOnly);
+   out << YAML::Key << "archive" << YAML::Value << QYaml::WrappedBinary(&file);
+   \endcode
+*/
+class WrappedBinary
+{
+public:
+  enum
+  {
+    DefaultLineLength = 76
+  };
+
+  WrappedBinary(const QByteArray& data, int lineLength = DefaultLineLength)
+    : m_data(data.constData())
+    , m_size(std::size_t(data.size()))
+    , m_device(nullptr)
+    , m_lineLength(lineLength) {}
+
+  WrappedBinary(const char* data, std::size_t size, int lineLength = DefaultLineLength)
+    : m_data(data)
+    , m_size(size)
+    , m_device(nullptr)
+    , m_lineLength(lineLength) {}
+
+  /*!
+     \brief Reads device from its current position to the end when the
+     value is emitted.
+  */
+  explicit WrappedBinary(QIODevice* device, int lineLength = DefaultLineLength)
+    : m_data(nullptr)
+    , m_size(0)
+    , m_device(device)
+    , m_lineLength(lineLength) {}
+
+  /*!
+     \brief The number of source bytes per line.
+  */
+  std::size_t lineBytes() const { return std::size_t(std::max(m_lineLength / 4, 1)) * 3; }
+
+  /*!
+     \brief The wrapped base64 text, lines separated by '\n' with no final
+     line break. The whole text is built in memory.
+  */
+  std::string text() const {
+    std::string out;
+
+    if (!m_device) {
+      out.reserve(textSize(m_size));
+      append(m_data, m_size, out);
+      return out;
+    }
+
+    if (!m_device->isSequential()) {
+      out.reserve(textSize(std::size_t(std::max<qint64>(m_device->size() - m_device->pos(), 0))));
+    }
+
+    // a whole number of lines per chunk, so lines never straddle chunks.
+    QByteArray chunk(int(lineBytes() * 1024), Qt::Uninitialized);
+
+    for (;;) {
+      int filled = 0;
+
+      while (filled < chunk.size()) {
+        const qint64 read = m_device->read(chunk.data() + filled, chunk.size() - filled);
+
+        if (read <= 0) {
+          break;
+        }
+
+        filled += int(read);
+      }
+
+      append(chunk.constData(), std::size_t(filled), out);
+
+      if (filled < chunk.size()) {
+        return out;
+      }
+    }
+  }
+
+private:
+  std::size_t textSize(std::size_t size) const {
+    if (size == 0) {
+      return 0;
+    }
+
+    const std::size_t lines = (size + lineBytes() - 1) / lineBytes();
+    return (size + 2) / 3 * 4 + lines - 1;
+  }
+
+  void append(const char* data, std::size_t size, std::string& out) const {
+    const std::size_t perLine = lineBytes();
+
+    for (std::size_t offset = 0; offset < size; offset += perLine) {
+      if (!out.empty()) {
+        out += '\n';
+      }
+
+      encodeLine(reinterpret_cast<const unsigned char*>(data + offset),
+                 std::min(perLine, size - offset),
+                 out);
+    }
+  }
+
+  static void encodeLine(const unsigned char* in, std::size_t size, std::string& out) {
+    static const char alphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const std::size_t start = out.size();
+    out.resize(start + (size + 2) / 3 * 4);
+    char* p = &out[start];
+    std::size_t i = 0;
+
+    for (; i + 3 <= size; i += 3) {
+      const unsigned value = (unsigned(in[i]) << 16) | (unsigned(in[i + 1]) << 8) | in[i + 2];
+      *p++ = alphabet[(value >> 18) & 63];
+      *p++ = alphabet[(value >> 12) & 63];
+      *p++ = alphabet[(value >> 6) & 63];
+      *p++ = alphabet[value & 63];
+    }
+
+    if (i < size) {
+      const bool two = (size - i == 2);
+      const unsigned value = (unsigned(in[i]) << 16) | (two ? unsigned(in[i + 1]) << 8 : 0);
+      *p++ = alphabet[(value >> 18) & 63];
+      *p++ = alphabet[(value >> 12) & 63];
+      *p++ = two ? alphabet[(value >> 6) & 63] : '=';
+      *p++ = '=';
+    }
+  }
+
+  const char* m_data;
+  std::size_t m_size;
+  QIODevice* m_device;
+  int m_lineLength;
+};
+
+} // end of namespace QYaml
+
+namespace YAML {
+
+inline Emitter& operator<<(Emitter& emitter, const QYaml::WrappedBinary& v)
+{
+  QYAML_PROBE("WrappedBinary::emit");
+
+  const std::string text = v.text();
+  QYAML_PROBE_BYTES(text.size());
+
+  emitter << SecondaryTag("binary");
+
+  // an empty literal block would not survive a round trip.
+  if (text.empty()) {
+    return emitter << DoubleQuoted << text;
+  }
+
+  return emitter << Literal << text;
+}
+
+} // end of namespace YAML
+
+#endif // QYAML_BINARY_H
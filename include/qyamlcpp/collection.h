@@ -27,152 +27,447 @@
 #define COLLECTION_H
 
 #include <QFont>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QMultiHash>
+#include <QMultiMap>
 #include <QObject>
 #include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QVariant>
 #include <QVector>
 
-#include <list>
-#include <map>
-#include <vector>
-
+#include "config.h"
+#include "instrument.h"
 #include "node.h"
 #include "yaml-cpp/yaml.h"
 
-namespace YAML {
+namespace QYaml {
+namespace detail {
 
-template<class T>
-struct convert<QList<T>>
+/*
+   A YAML mapping cannot repeat a key, so the multi containers map each key
+   to a sequence of its values,
+
+   key: [newest, ..., oldest]
+
+   in the order values() returns them. Equal keys are next to each other in
+   both containers, so each group is written in one pass.
+*/
+template<class Container>
+inline YAML::Node encodeMulti(const Container& rhs)
 {
-  static Node encode(const QList<T>& rhs) {
-    Node node(NodeType::Sequence);
+  YAML::Node node(YAML::NodeType::Map);
+  typename Container::const_iterator it = rhs.constBegin();
+
+  while (it != rhs.constEnd()) {
+    const typename Container::key_type& key = it.key();
+    YAML::Node values(YAML::NodeType::Sequence);
 
-    std::list<T> slist = rhs.toStdList();
-    node = slist;
+    do {
+      values.push_back(it.value());
+      ++it;
+    } while (it != rhs.constEnd() && it.key() == key);
 
-    return node;
+    node.force_insert(key, values);
   }
 
-  static bool decode(const Node& node, QList<T>& rhs) {
-    if (!node.IsSequence()) {
+  return node;
+}
+
+/*
+   Adds the entries of an encodeMulti() mapping to rhs. insert() puts a value
+   in front of the others for its key, so each sequence is inserted back to
+   front.
+*/
+template<class Container>
+inline bool decodeMulti(const YAML::Node& node, Container& rhs)
+{
+  typedef typename Container::key_type Key;
+  typedef typename Container::mapped_type Value;
+
+  QVector<Value> values;
+
+  for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+    if (!it->second.IsSequence()) {
       return false;
     }
 
-    std::list<T> slist = node.as<std::list<T>>();
-    rhs = QList<T>::fromStdList(slist);
+    const Key key = it->first.as<Key>();
+    values.clear();
+    values.reserve(int(it->second.size()));
 
-    return true;
+    for (YAML::const_iterator value = it->second.begin(); value != it->second.end();
+         ++value) {
+      values.append(value->as<Value>());
+    }
+
+    for (int i = values.size() - 1; i >= 0; --i) {
+      rhs.insert(key, values.at(i));
+    }
   }
+
+  return true;
+}
+
+} // end of namespace detail
+} // end of namespace QYaml
+
+namespace YAML {
+
+/*
+   The container converters iterate the node directly rather than going
+   through the std:: container converters, which would build a complete
+   std:: copy of the data first. Destination containers are reserved up
+   front where the type allows it.
+*/
+template<class T>
+struct convert<QList<T>>
+{
+  static Node encode(const QList<T>& rhs);
+  static bool decode(const Node& node, QList<T>& rhs);
 };
 
+template<class T>
+Node convert<QList<T>>::encode(const QList<T>& rhs)
+{
+  QYAML_TYPED_PROBE("encode", QList<T>);
+
+  Node node(NodeType::Sequence);
+
+  for (const T& value : rhs) {
+    node.push_back(value);
+  }
+
+  return node;
+}
+
+template<class T>
+bool convert<QList<T>>::decode(const Node& node, QList<T>& rhs)
+{
+  QYAML_TYPED_PROBE("decode", QList<T>);
+
+  if (!node.IsSequence()) {
+    return false;
+  }
+
+  rhs.clear();
+  rhs.reserve(int(node.size()));
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    rhs.append(it->as<T>());
+  }
+
+  return true;
+}
+
 template<class T>
 inline void operator>>(const Node& node, QList<T>& q)
 {
-  std::list<T> slist;
-  slist = node.as<std::list<T>>();
-  q = QList<T>::fromStdList(slist);
+  q = node.as<QList<T>>();
 }
 
 template<class K, class V>
 struct convert<QMap<K, V>>
 {
-  static Node encode(const QMap<K, V>& rhs) {
-    Node node(NodeType::Map);
+  static Node encode(const QMap<K, V>& rhs);
+  static bool decode(const Node& node, QMap<K, V>& rhs);
+};
 
-    std::map<K, V> smap = rhs.toStdMap();
-    node = smap;
+template<class K, class V>
+Node convert<QMap<K, V>>::encode(const QMap<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("encode", QMap<K, V>);
+
+  Node node(NodeType::Map);
 
-    return node;
+  // QMap keys are unique, so there is no need to search for them first.
+  for (typename QMap<K, V>::const_iterator it = rhs.constBegin();
+       it != rhs.constEnd(); ++it) {
+    node.force_insert(it.key(), it.value());
   }
 
-  static bool decode(const Node& node, QMap<K, V>& rhs) {
-    if (!node.IsMap()) {
-      return false;
-    }
+  return node;
+}
 
-    std::map<K, V> smap = node.as<std::map<K, V>>();
-    rhs = QMap<K, V>(smap);
+template<class K, class V>
+bool convert<QMap<K, V>>::decode(const Node& node, QMap<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("decode", QMap<K, V>);
 
-    return true;
+  if (!node.IsMap()) {
+    return false;
+  }
+
+  rhs.clear();
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    rhs.insert(it->first.as<K>(), it->second.as<V>());
   }
-};
+
+  return true;
+}
 
 template<class K, class V>
 inline void operator>>(const Node& node, QMap<K, V>& q)
 {
-  std::map<K, V> smap;
-  smap = node.as<std::map<K, V>>();
-  q = QMap<K, V>(smap);
+  q = node.as<QMap<K, V>>();
 }
 
 // template <>
 template<class T>
 struct convert<QVector<T>>
 {
-  static Node encode(const QVector<T>& rhs) {
-    Node node(NodeType::Sequence);
+  static Node encode(const QVector<T>& rhs);
+  static bool decode(const Node& node, QVector<T>& rhs);
+};
 
-    std::vector<T> svector = rhs.toStdVector();
-    node = svector;
+template<class T>
+Node convert<QVector<T>>::encode(const QVector<T>& rhs)
+{
+  QYAML_TYPED_PROBE("encode", QVector<T>);
 
-    return node;
+  Node node(NodeType::Sequence);
+
+  for (const T& value : rhs) {
+    node.push_back(value);
   }
 
-  static bool decode(const Node& node, QVector<T>& rhs) {
-    if (!node.IsSequence()) {
-      return false;
-    }
+  return node;
+}
 
-    std::vector<T> svector = node.as<std::vector<T>>();
-    rhs = QVector<T>::fromStdVector(svector);
+template<class T>
+bool convert<QVector<T>>::decode(const Node& node, QVector<T>& rhs)
+{
+  QYAML_TYPED_PROBE("decode", QVector<T>);
 
-    return true;
+  if (!node.IsSequence()) {
+    return false;
   }
-};
+
+  rhs.clear();
+  rhs.reserve(int(node.size()));
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    rhs.append(it->as<T>());
+  }
+
+  return true;
+}
 
 template<class T>
 inline void operator>>(const Node& node, QVector<T>& q)
 {
-  std::vector<T> svector;
-  svector = node.as<std::vector<T>>();
-  q = QVector<T>::fromStdVector(svector);
+  q = node.as<QVector<T>>();
 }
 
 // template <>
 template<class T>
 struct convert<QSet<T>>
 {
-  static Node encode(const QSet<T>& rhs) {
-    Node node(NodeType::Sequence);
+  static Node encode(const QSet<T>& rhs);
+  static bool decode(const Node& node, QSet<T>& rhs);
+};
+
+template<class T>
+Node convert<QSet<T>>::encode(const QSet<T>& rhs)
+{
+  QYAML_TYPED_PROBE("encode", QSet<T>);
 
-    std::list<T> slist = rhs.toList();
-    node = slist;
+  Node node(NodeType::Sequence);
 
-    return node;
+  for (const T& value : rhs) {
+    node.push_back(value);
   }
 
-  static bool decode(const Node& node, QSet<T>& rhs) {
-    if (!node.IsSequence()) {
-      return false;
-    }
+  return node;
+}
 
-    std::list<T> slist = node.as<std::list<T>>();
-    rhs = QSet<T>::fromList(QList<T>::fromStdList(slist));
+template<class T>
+bool convert<QSet<T>>::decode(const Node& node, QSet<T>& rhs)
+{
+  QYAML_TYPED_PROBE("decode", QSet<T>);
 
-    return true;
+  if (!node.IsSequence()) {
+    return false;
   }
-};
+
+  rhs.clear();
+  rhs.reserve(int(node.size()));
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    rhs.insert(it->as<T>());
+  }
+
+  return true;
+}
 
 template<class T>
 inline void operator>>(const Node& node, QSet<T>& q)
 {
-  std::list<T> slist = node.as<std::list<T>>();
-  q = QSet<T>::fromList(QList<T>::fromStdList(slist));
+  q = node.as<QSet<T>>();
+}
+
+template<class K, class V>
+struct convert<QHash<K, V>>
+{
+  static Node encode(const QHash<K, V>& rhs);
+  static bool decode(const Node& node, QHash<K, V>& rhs);
+};
+
+template<class K, class V>
+Node convert<QHash<K, V>>::encode(const QHash<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("encode", QHash<K, V>);
+
+  Node node(NodeType::Map);
+
+  for (typename QHash<K, V>::const_iterator it = rhs.constBegin();
+       it != rhs.constEnd(); ++it) {
+    node.force_insert(it.key(), it.value());
+  }
+
+  return node;
+}
+
+template<class K, class V>
+bool convert<QHash<K, V>>::decode(const Node& node, QHash<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("decode", QHash<K, V>);
+
+  if (!node.IsMap()) {
+    return false;
+  }
+
+  rhs.clear();
+  rhs.reserve(int(node.size()));
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    rhs.insert(it->first.as<K>(), it->second.as<V>());
+  }
+
+  return true;
+}
+
+template<class K, class V>
+inline void operator>>(const Node& node, QHash<K, V>& q)
+{
+  q = node.as<QHash<K, V>>();
+}
+
+template<class K, class V>
+struct convert<QMultiHash<K, V>>
+{
+  static Node encode(const QMultiHash<K, V>& rhs);
+  static bool decode(const Node& node, QMultiHash<K, V>& rhs);
+};
+
+template<class K, class V>
+Node convert<QMultiHash<K, V>>::encode(const QMultiHash<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("encode", QMultiHash<K, V>);
+
+  return QYaml::detail::encodeMulti(rhs);
+}
+
+template<class K, class V>
+bool convert<QMultiHash<K, V>>::decode(const Node& node, QMultiHash<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("decode", QMultiHash<K, V>);
+
+  if (!node.IsMap()) {
+    return false;
+  }
+
+  // at least one entry per key.
+  rhs.clear();
+  rhs.reserve(int(node.size()));
+
+  return QYaml::detail::decodeMulti(node, rhs);
+}
+
+template<class K, class V>
+inline void operator>>(const Node& node, QMultiHash<K, V>& q)
+{
+  q = node.as<QMultiHash<K, V>>();
+}
+
+template<class K, class V>
+struct convert<QMultiMap<K, V>>
+{
+  static Node encode(const QMultiMap<K, V>& rhs);
+  static bool decode(const Node& node, QMultiMap<K, V>& rhs);
+};
+
+template<class K, class V>
+Node convert<QMultiMap<K, V>>::encode(const QMultiMap<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("encode", QMultiMap<K, V>);
+
+  return QYaml::detail::encodeMulti(rhs);
 }
 
+template<class K, class V>
+bool convert<QMultiMap<K, V>>::decode(const Node& node, QMultiMap<K, V>& rhs)
+{
+  QYAML_TYPED_PROBE("decode", QMultiMap<K, V>);
+
+  if (!node.IsMap()) {
+    return false;
+  }
+
+  rhs.clear();
+
+  return QYaml::detail::decodeMulti(node, rhs);
+}
+
+template<class K, class V>
+inline void operator>>(const Node& node, QMultiMap<K, V>& q)
+{
+  q = node.as<QMultiMap<K, V>>();
+}
+
+/*
+   QStringList is a QList<QString>, so it shares that converter, but
+   node.as<QStringList>() needs a convert<QStringList> of its own.
+*/
+template<>
+struct convert<QStringList>
+{
+  static Node encode(const QStringList& rhs) {
+    return convert<QList<QString>>::encode(rhs);
+  }
+
+  static bool decode(const Node& node, QStringList& rhs) {
+    return convert<QList<QString>>::decode(node, rhs);
+  }
+};
+
+inline void operator>>(const Node& node, QStringList& q)
+{
+  q = node.as<QStringList>();
+}
+
+#if defined(QYAMLCPP_COMPILED_LIB)
+// the most used instantiations are compiled once, in src/collection.cpp.
+extern template struct convert<QList<int>>;
+extern template struct convert<QList<double>>;
+extern template struct convert<QList<QString>>;
+extern template struct convert<QVector<int>>;
+extern template struct convert<QVector<double>>;
+extern template struct convert<QVector<QString>>;
+extern template struct convert<QSet<int>>;
+extern template struct convert<QSet<QString>>;
+extern template struct convert<QMap<QString, int>>;
+extern template struct convert<QMap<QString, QString>>;
+extern template struct convert<QMap<QString, QVariant>>;
+extern template struct convert<QHash<QString, int>>;
+extern template struct convert<QHash<QString, QString>>;
+extern template struct convert<QHash<QString, QVariant>>;
+#endif
+
 } // end of namespace YAML
 
 #endif // COLLECTION_H
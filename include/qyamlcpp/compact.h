@@ -0,0 +1,1110 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_COMPACT_H
+#define QYAML_COMPACT_H
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QColor>
+#include <QFile>
+#include <QFont>
+#include <QImage>
+#include <QList>
+#include <QMap>
+#include <QPixmap>
+#include <QPoint>
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QSet>
+#include <QSize>
+#include <QSizeF>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <cstring>
+#include <istream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+
+#include "collection.h"
+#include "intern.h"
+#include "node.h"
+#include "scalar.h"
+#include "streambuf.h"
+
+namespace QYaml {
+
+class CompactDocument;
+class CompactNode;
+
+/*!
+   \brief Converts a CompactNode to T.
+
+   This is the compact document equivalent of YAML::convert<T>. Types without
+   a specialisation fall back to building a YAML::Node for the subtree and
+   using YAML::convert<T>, so anything yaml-cpp can decode still works.
+*/
+template<class T, class Enable = void>
+struct compact_convert;
+
+/*!
+   \brief A lightweight handle to a node stored in a CompactDocument.
+
+   CompactNode is two words wide and is passed by value. It mirrors the
+   read only part of the YAML::Node interface so that code can be moved
+   between the two backends. A handle is only valid while the document
+   it came from is alive.
+*/
+class CompactNode
+{
+public:
+  CompactNode()
+    : m_document(nullptr)
+    , m_index(0) {}
+
+  bool IsDefined() const { return m_document != nullptr; }
+  bool IsNull() const { return Type() == YAML::NodeType::Null; }
+  bool IsScalar() const { return Type() == YAML::NodeType::Scalar; }
+  bool IsSequence() const { return Type() == YAML::NodeType::Sequence; }
+  bool IsMap() const { return Type() == YAML::NodeType::Map; }
+
+  inline YAML::NodeType::value Type() const;
+  inline const std::string& Tag() const;
+
+  /*!
+     \brief The number of items in a sequence or key/value pairs in a map.
+  */
+  inline std::size_t size() const;
+
+  /*!
+     \brief The UTF-8 scalar text, which is not null terminated.
+
+     For plain scalars this points straight into the source buffer.
+  */
+  inline const char* data() const;
+  inline std::size_t length() const;
+
+  /*!
+     \brief Returns a copy of the scalar text.
+  */
+  std::string Scalar() const { return std::string(data(), length()); }
+
+  /*!
+     \brief Returns the sequence item at index.
+  */
+  inline CompactNode operator[](int index) const;
+
+  /*!
+     \brief Returns the map value for key or an undefined node.
+
+     The lookup is a scan over the keys but compares the stored bytes
+     directly, so no key strings are created.
+  */
+  inline CompactNode operator[](const char* key) const;
+  CompactNode operator[](const std::string& key) const {
+    return find(key.data(), key.size());
+  }
+  CompactNode operator[](const QString& key) const {
+    const QByteArray utf8 = key.toUtf8();
+    return find(utf8.constData(), std::size_t(utf8.size()));
+  }
+  inline CompactNode find(const char* key, std::size_t size) const;
+
+  /*!
+     \brief Returns the key or value of the map entry at index.
+  */
+  inline CompactNode key(int index) const;
+  inline CompactNode value(int index) const;
+
+  template<class T>
+  T as() const {
+    T rhs;
+
+    if (!IsDefined() || !compact_convert<T>::decode(*this, rhs)) {
+      throw YAML::TypedBadConversion<T>(YAML::Mark::null_mark());
+    }
+
+    return rhs;
+  }
+
+  template<class T>
+  T as(const T& fallback) const {
+    T rhs;
+
+    if (!IsDefined() || !compact_convert<T>::decode(*this, rhs)) {
+      return fallback;
+    }
+
+    return rhs;
+  }
+
+  /*!
+     \brief Builds an equivalent YAML::Node for this subtree.
+  */
+  inline YAML::Node toNode() const;
+
+  bool operator==(const CompactNode& other) const {
+    return m_document == other.m_document && m_index == other.m_index;
+  }
+  bool operator!=(const CompactNode& other) const { return !(*this == other); }
+
+private:
+  friend class CompactDocument;
+
+  CompactNode(const CompactDocument* document, quint32 index)
+    : m_document(document)
+    , m_index(index) {}
+
+  inline CompactNode child(quint32 position) const;
+
+  const CompactDocument* m_document;
+  quint32 m_index;
+};
+
+/*!
+   \brief A read only YAML document stored in a handful of contiguous arrays.
+
+   A YAML::Node tree allocates a node, a node_ref, a node_data and their
+   shared_ptr control blocks for every value. CompactDocument instead
+   stores each node as a twelve byte entry in one vector, refers to
+   children by index and keeps scalar text as slices of the source buffer.
+   Only scalars whose text differs from the source (quoted, escaped or
+   folded scalars) are copied into a separate string pool. Destroying the
+   document, or calling clear(), frees everything at once.
+
+   Documents are built from yaml-cpp parser events, so the accepted syntax
+   is exactly the one YAML::Load() accepts. A stream containing several
+   documents is held in a single arena with one root per document.
+
+   Offsets are 32 bit so a single source is limited to 4 GB.
+
+   \code
+   QYaml::CompactDocument doc = QYaml::CompactDocument::LoadFile(filename);
+   QRect rect = doc.root()["position"].as<QRect>();
+   QColor color = doc.root()["normal_color"].as<QColor>();
+   \endcode
+*/
+class CompactDocument
+{
+public:
+  CompactDocument() = default;
+  CompactDocument(CompactDocument&&) = default;
+  CompactDocument& operator=(CompactDocument&&) = default;
+  CompactDocument(const CompactDocument&) = delete;
+  CompactDocument& operator=(const CompactDocument&) = delete;
+
+  /*!
+     \brief Parses every document in input.
+
+     The input is shared, not copied, and plain scalars point into it.
+
+     @throws {@link ParserException} if it is malformed.
+  */
+  static CompactDocument Load(const QByteArray& input) {
+    CompactDocument document;
+    document.m_source = input;
+
+    ByteArrayStreamBuf buffer(document.m_source);
+    std::istream stream(&buffer);
+    YAML::Parser parser(stream);
+    Builder builder(document);
+
+    while (parser.HandleNextDocument(builder)) {
+    }
+
+    document.squeeze();
+    return document;
+  }
+
+  /*!
+     \brief Parses every document in the input QString.
+
+     @throws {@link ParserException} if it is malformed.
+  */
+  static CompactDocument Load(const QString& input) {
+    return Load(input.toUtf8());
+  }
+
+  /*!
+     \brief Loads a file, returning an empty document if it cannot be read.
+  */
+  static CompactDocument LoadFile(const QString& filename) {
+    QFile file(filename);
+    return LoadFile(file);
+  }
+
+  /*!
+     \brief Loads a file, returning an empty document if it cannot be read.
+  */
+  static CompactDocument LoadFile(QFile& file) {
+    if (!file.exists()) {
+      return CompactDocument();
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+      return CompactDocument();
+    }
+
+    return Load(file.readAll());
+  }
+
+  int documentCount() const { return int(m_roots.size()); }
+
+  /*!
+     \brief Returns the root node of the given document, or an undefined
+     node if there is no such document.
+  */
+  CompactNode root(int document = 0) const {
+    if (document < 0 || document >= documentCount()) {
+      return CompactNode();
+    }
+
+    return CompactNode(this, m_roots[std::size_t(document)]);
+  }
+
+  std::size_t nodeCount() const { return m_nodes.size(); }
+
+  /*!
+     \brief The heap memory held by the document, including the source.
+  */
+  std::size_t memoryUsage() const {
+    return m_nodes.capacity() * sizeof(Entry) +
+           m_links.capacity() * sizeof(quint32) +
+           m_roots.capacity() * sizeof(quint32) + std::size_t(m_source.size()) +
+           std::size_t(m_strings.capacity());
+  }
+
+  /*!
+     \brief Releases the arena. Any CompactNode handles become invalid.
+  */
+  void clear() {
+    m_source = QByteArray();
+    m_strings = QByteArray();
+    std::vector<Entry>().swap(m_nodes);
+    std::vector<quint32>().swap(m_links);
+    std::vector<quint32>().swap(m_roots);
+    std::vector<std::string>().swap(m_tags);
+  }
+
+  YAML::Node toNode(int document = 0) const { return root(document).toNode(); }
+
+private:
+  friend class CompactNode;
+
+  enum Flag
+  {
+    Pooled = 0x01, // scalar text lives in m_strings rather than m_source
+    Flow = 0x02,   // collection was written in flow style
+  };
+
+  struct Entry
+  {
+    quint8 type;    // YAML::NodeType::value
+    quint8 flags;   // Flag
+    quint16 tag;    // index into m_tags
+    quint32 offset; // scalar: byte offset, collection: first entry in m_links
+    quint32 length; // scalar: byte length, collection: number of links
+  };
+
+  class Builder : public YAML::EventHandler
+  {
+  public:
+    explicit Builder(CompactDocument& document)
+      : m_document(document)
+      , m_hasRoot(false) {
+      m_document.m_tags.push_back(std::string());
+      m_tagIndex.emplace(std::string(), 0);
+    }
+
+    void OnDocumentStart(const YAML::Mark&) override {
+      m_anchors.clear();
+      m_hasRoot = false;
+    }
+
+    void OnDocumentEnd() override {
+      if (!m_hasRoot) {
+        add(YAML::NodeType::Null, 0, 0);
+      }
+    }
+
+    void OnNull(const YAML::Mark&, YAML::anchor_t anchor) override {
+      quint32 index = add(YAML::NodeType::Null, 0, 0);
+      anchored(anchor, index);
+    }
+
+    void OnAlias(const YAML::Mark&, YAML::anchor_t anchor) override {
+      // aliases simply link to the anchored node again, as yaml-cpp does.
+      if (anchor < m_anchors.size()) {
+        attach(m_anchors[anchor]);
+      } else {
+        add(YAML::NodeType::Null, 0, 0);
+      }
+    }
+
+    void OnScalar(const YAML::Mark& mark,
+                  const std::string& tag,
+                  YAML::anchor_t anchor,
+                  const std::string& value) override {
+      quint32 index = add(YAML::NodeType::Scalar, tagIndex(tag), 0);
+      Entry& entry = m_document.m_nodes[index];
+      const QByteArray& source = m_document.m_source;
+      const std::size_t size = value.size();
+
+      if (mark.pos >= 0 &&
+          std::size_t(mark.pos) + size <= std::size_t(source.size()) &&
+          std::memcmp(source.constData() + mark.pos, value.data(), size) == 0) {
+        entry.offset = quint32(mark.pos);
+      } else {
+        entry.flags |= Pooled;
+        entry.offset = quint32(m_document.m_strings.size());
+        m_document.m_strings.append(value.data(), int(size));
+      }
+
+      entry.length = quint32(size);
+      anchored(anchor, index);
+    }
+
+    void OnSequenceStart(const YAML::Mark&,
+                         const std::string& tag,
+                         YAML::anchor_t anchor,
+                         YAML::EmitterStyle::value style) override {
+      open(YAML::NodeType::Sequence, tag, anchor, style);
+    }
+
+    void OnSequenceEnd() override { close(); }
+
+    void OnMapStart(const YAML::Mark&,
+                    const std::string& tag,
+                    YAML::anchor_t anchor,
+                    YAML::EmitterStyle::value style) override {
+      open(YAML::NodeType::Map, tag, anchor, style);
+    }
+
+    void OnMapEnd() override { close(); }
+
+  private:
+    struct Frame
+    {
+      quint32 node;
+      std::size_t start;
+    };
+
+    quint32 add(YAML::NodeType::value type, quint16 tag, quint8 flags) {
+      Entry entry;
+      entry.type = quint8(type);
+      entry.flags = flags;
+      entry.tag = tag;
+      entry.offset = 0;
+      entry.length = 0;
+
+      quint32 index = quint32(m_document.m_nodes.size());
+      m_document.m_nodes.push_back(entry);
+      attach(index);
+      return index;
+    }
+
+    void attach(quint32 index) {
+      if (m_frames.empty()) {
+        m_document.m_roots.push_back(index);
+        m_hasRoot = true;
+      } else {
+        m_pending.push_back(index);
+      }
+    }
+
+    void anchored(YAML::anchor_t anchor, quint32 index) {
+      if (anchor == 0) {
+        return;
+      }
+
+      if (anchor >= m_anchors.size()) {
+        m_anchors.resize(anchor + 1, 0);
+      }
+
+      m_anchors[anchor] = index;
+    }
+
+    void open(YAML::NodeType::value type,
+              const std::string& tag,
+              YAML::anchor_t anchor,
+              YAML::EmitterStyle::value style) {
+      quint8 flags = (style == YAML::EmitterStyle::Flow) ? quint8(Flow) : 0;
+      quint32 index = add(type, tagIndex(tag), flags);
+      anchored(anchor, index);
+
+      Frame frame;
+      frame.node = index;
+      frame.start = m_pending.size();
+      m_frames.push_back(frame);
+    }
+
+    // Children are collected on a single scratch stack while the collection
+    // is open, then copied to m_links as one contiguous run. Nested
+    // collections close first so their runs never interleave.
+    void close() {
+      Frame frame = m_frames.back();
+      m_frames.pop_back();
+
+      Entry& entry = m_document.m_nodes[frame.node];
+      entry.offset = quint32(m_document.m_links.size());
+      entry.length = quint32(m_pending.size() - frame.start);
+
+      m_document.m_links.insert(m_document.m_links.end(),
+                                m_pending.begin() + std::ptrdiff_t(frame.start),
+                                m_pending.end());
+      m_pending.resize(frame.start);
+    }
+
+    quint16 tagIndex(const std::string& tag) {
+      auto it = m_tagIndex.find(tag);
+
+      if (it != m_tagIndex.end()) {
+        return it->second;
+      }
+
+      if (m_document.m_tags.size() > 0xFFFF) {
+        return 0;
+      }
+
+      quint16 index = quint16(m_document.m_tags.size());
+      m_document.m_tags.push_back(tag);
+      m_tagIndex.emplace(tag, index);
+      return index;
+    }
+
+    CompactDocument& m_document;
+    std::vector<Frame> m_frames;
+    std::vector<quint32> m_pending;
+    std::vector<quint32> m_anchors;
+    std::unordered_map<std::string, quint16> m_tagIndex;
+    bool m_hasRoot;
+  };
+
+  void squeeze() {
+    m_nodes.shrink_to_fit();
+    m_links.shrink_to_fit();
+    m_roots.shrink_to_fit();
+    m_strings.squeeze();
+  }
+
+  const Entry& entry(quint32 index) const { return m_nodes[index]; }
+
+  QByteArray m_source;
+  QByteArray m_strings;
+  std::vector<Entry> m_nodes;
+  std::vector<quint32> m_links;
+  std::vector<quint32> m_roots;
+  std::vector<std::string> m_tags;
+};
+
+/* = CompactNode
+   ======================================================================================*/
+inline YAML::NodeType::value CompactNode::Type() const
+{
+  if (!m_document) {
+    return YAML::NodeType::Undefined;
+  }
+
+  return YAML::NodeType::value(m_document->entry(m_index).type);
+}
+
+inline const std::string& CompactNode::Tag() const
+{
+  static const std::string empty;
+
+  if (!m_document) {
+    return empty;
+  }
+
+  return m_document->m_tags[m_document->entry(m_index).tag];
+}
+
+inline std::size_t CompactNode::size() const
+{
+  if (IsSequence()) {
+    return m_document->entry(m_index).length;
+  }
+
+  if (IsMap()) {
+    return m_document->entry(m_index).length / 2;
+  }
+
+  return 0;
+}
+
+inline const char* CompactNode::data() const
+{
+  if (!IsScalar()) {
+    return "";
+  }
+
+  const CompactDocument::Entry& entry = m_document->entry(m_index);
+  const QByteArray& storage = (entry.flags & CompactDocument::Pooled)
+                                ? m_document->m_strings
+                                : m_document->m_source;
+  return storage.constData() + entry.offset;
+}
+
+inline std::size_t CompactNode::length() const
+{
+  if (!IsScalar()) {
+    return 0;
+  }
+
+  return m_document->entry(m_index).length;
+}
+
+inline CompactNode CompactNode::child(quint32 position) const
+{
+  return CompactNode(m_document, m_document->m_links[position]);
+}
+
+inline CompactNode CompactNode::operator[](int index) const
+{
+  if (!IsSequence() || index < 0 || std::size_t(index) >= size()) {
+    return CompactNode();
+  }
+
+  return child(m_document->entry(m_index).offset + quint32(index));
+}
+
+inline CompactNode CompactNode::operator[](const char* key) const
+{
+  return find(key, std::strlen(key));
+}
+
+inline CompactNode CompactNode::find(const char* key, std::size_t size) const
+{
+  if (!IsMap()) {
+    return CompactNode();
+  }
+
+  const CompactDocument::Entry& entry = m_document->entry(m_index);
+
+  for (quint32 i = 0; i < entry.length; i += 2) {
+    CompactNode candidate = child(entry.offset + i);
+
+    if (candidate.length() == size && candidate.IsScalar() &&
+        std::memcmp(candidate.data(), key, size) == 0) {
+      return child(entry.offset + i + 1);
+    }
+  }
+
+  return CompactNode();
+}
+
+inline CompactNode CompactNode::key(int index) const
+{
+  if (!IsMap() || index < 0 || std::size_t(index) >= size()) {
+    return CompactNode();
+  }
+
+  return child(m_document->entry(m_index).offset + quint32(index) * 2);
+}
+
+inline CompactNode CompactNode::value(int index) const
+{
+  if (!IsMap() || index < 0 || std::size_t(index) >= size()) {
+    return CompactNode();
+  }
+
+  return child(m_document->entry(m_index).offset + quint32(index) * 2 + 1);
+}
+
+inline YAML::Node CompactNode::toNode() const
+{
+  YAML::Node node;
+
+  switch (Type()) {
+    case YAML::NodeType::Undefined:
+    case YAML::NodeType::Null:
+      node = YAML::Node(YAML::NodeType::Null);
+      break;
+
+    case YAML::NodeType::Scalar:
+      node = YAML::Node(Scalar());
+      break;
+
+    case YAML::NodeType::Sequence:
+      node = YAML::Node(YAML::NodeType::Sequence);
+
+      for (std::size_t i = 0; i < size(); ++i) {
+        node.push_back((*this)[int(i)].toNode());
+      }
+
+      break;
+
+    case YAML::NodeType::Map:
+      node = YAML::Node(YAML::NodeType::Map);
+
+      for (std::size_t i = 0; i < size(); ++i) {
+        node.force_insert(key(int(i)).toNode(), value(int(i)).toNode());
+      }
+
+      break;
+  }
+
+  if (!Tag().empty()) {
+    node.SetTag(Tag());
+  }
+
+  if (IsDefined() &&
+      (m_document->entry(m_index).flags & CompactDocument::Flow)) {
+    node.SetStyle(YAML::EmitterStyle::Flow);
+  }
+
+  return node;
+}
+
+/*!
+   \brief Copies the value of node to rhs, in the style of the YAML::Node
+   operator>> overloads.
+
+   @throws {@link TypedBadConversion} if the node cannot be converted.
+*/
+template<class T>
+inline void operator>>(const CompactNode& node, T& rhs)
+{
+  if (!node.IsDefined() || !compact_convert<T>::decode(node, rhs)) {
+    throw YAML::TypedBadConversion<T>(YAML::Mark::null_mark());
+  }
+}
+
+/* = fallback
+   ======================================================================================*/
+template<class T, class Enable>
+struct compact_convert
+{
+  static bool decode(const CompactNode& node, T& rhs) {
+    return YAML::convert<T>::decode(node.toNode(), rhs);
+  }
+};
+
+/* = arithmetic and strings
+   ======================================================================================*/
+template<class T>
+struct compact_convert<
+  T,
+  typename std::enable_if<std::is_integral<T>::value &&
+                          !std::is_same<T, bool>::value &&
+                          !std::is_same<T, char>::value>::type>
+{
+  static bool decode(const CompactNode& node, T& rhs) {
+    return node.IsScalar() &&
+           Scalar::toInteger(node.data(), node.length(), rhs);
+  }
+};
+
+template<class T>
+struct compact_convert<
+  T,
+  typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+  static bool decode(const CompactNode& node, T& rhs) {
+    double value;
+
+    if (!node.IsScalar() ||
+        !Scalar::toDouble(node.data(), node.length(), value)) {
+      return false;
+    }
+
+    rhs = T(value);
+    return true;
+  }
+};
+
+template<>
+struct compact_convert<bool>
+{
+  static bool decode(const CompactNode& node, bool& rhs) {
+    return node.IsScalar() && Scalar::toBool(node.data(), node.length(), rhs);
+  }
+};
+
+template<>
+struct compact_convert<std::string>
+{
+  static bool decode(const CompactNode& node, std::string& rhs) {
+    if (!node.IsScalar()) {
+      return false;
+    }
+
+    rhs.assign(node.data(), node.length());
+    return true;
+  }
+};
+
+/* = QString
+   ======================================================================================*/
+template<>
+struct compact_convert<QString>
+{
+  static bool decode(const CompactNode& node, QString& rhs) {
+    if (!node.IsScalar()) {
+      return false;
+    }
+
+    rhs = internedString(node.data(), node.length());
+    return true;
+  }
+};
+
+/* = QVariant
+   ======================================================================================*/
+template<>
+struct compact_convert<QVariant>
+{
+  static bool decode(const CompactNode& node, QVariant& rhs) {
+    if (!node.IsScalar()) {
+      return false;
+    }
+
+    rhs = QVariant(QString::fromUtf8(node.data(), int(node.length())));
+    return true;
+  }
+};
+
+/* = QByteArray
+   ======================================================================================*/
+template<>
+struct compact_convert<QByteArray>
+{
+  static bool decode(const CompactNode& node, QByteArray& rhs) {
+    return node.IsScalar() &&
+           Scalar::decodeBase64(node.data(), node.length(), rhs);
+  }
+};
+
+/* = QBuffer
+   ======================================================================================*/
+template<>
+struct compact_convert<QBuffer>
+{
+  static bool decode(const CompactNode& node, QBuffer& rhs) {
+    QByteArray array;
+
+    if (!compact_convert<QByteArray>::decode(node, array)) {
+      return false;
+    }
+
+    rhs.setData(array);
+    return true;
+  }
+};
+
+/* = QColor
+   ======================================================================================*/
+template<>
+struct compact_convert<QColor>
+{
+  static bool decode(const CompactNode& node, QColor& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    int red = node["red"].as<int>();
+    int green = node["green"].as<int>();
+    int blue = node["blue"].as<int>();
+    int alpha = node["alpha"].as<int>();
+    rhs = QColor(red, green, blue, alpha);
+
+    return true;
+  }
+};
+
+/* = QFont
+   ======================================================================================*/
+template<>
+struct compact_convert<QFont>
+{
+  static bool decode(const CompactNode& node, QFont& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    rhs.setFamily(node["family"].as<QString>());
+    rhs.setBold(node["bold"].as<bool>());
+    rhs.setCapitalization(
+      QFont::Capitalization(node["capitalization"].as<int>()));
+    rhs.setFixedPitch(node["fixedpitch"].as<bool>());
+    rhs.setHintingPreference(
+      QFont::HintingPreference(node["hinting preference"].as<int>()));
+    rhs.setItalic(node["italic"].as<bool>());
+    rhs.setKerning(node["kerning"].as<bool>());
+    rhs.setLetterSpacing(
+      QFont::SpacingType(node["letter spacing type"].as<int>()),
+      node["letter spacing"].as<double>());
+    rhs.setOverline(node["overline"].as<bool>());
+    // not recommended to use pixelSize()
+    rhs.setPointSize(node["point size"].as<int>());
+    rhs.setStretch(node["stretch"].as<int>());
+    rhs.setStrikeOut(node["strikeout"].as<bool>());
+    rhs.setStyle(QFont::Style(node["style"].as<int>()));
+    rhs.setStyleHint(QFont::StyleHint(node["style hint"].as<int>()));
+    rhs.setStyleName(node["style name"].as<QString>());
+    rhs.setStyleStrategy(
+      QFont::StyleStrategy(node["style strategy"].as<int>()));
+    rhs.setUnderline(node["underline"].as<bool>());
+    rhs.setWeight(QFont::Weight(node["weight"].as<int>()));
+    rhs.setWordSpacing(node["word spacing"].as<int>());
+
+    return true;
+  }
+};
+
+/* = QPoint, QPointF
+   ======================================================================================*/
+template<>
+struct compact_convert<QPoint>
+{
+  static bool decode(const CompactNode& node, QPoint& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    rhs = QPoint(node["x"].as<int>(), node["y"].as<int>());
+    return true;
+  }
+};
+
+template<>
+struct compact_convert<QPointF>
+{
+  static bool decode(const CompactNode& node, QPointF& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    rhs = QPointF(node["x"].as<qreal>(), node["y"].as<qreal>());
+    return true;
+  }
+};
+
+/* = QRect, QRectF
+   ======================================================================================*/
+template<>
+struct compact_convert<QRect>
+{
+  static bool decode(const CompactNode& node, QRect& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    rhs = QRect(node["left"].as<int>(),
+                node["top"].as<int>(),
+                node["width"].as<int>(),
+                node["height"].as<int>());
+    return true;
+  }
+};
+
+template<>
+struct compact_convert<QRectF>
+{
+  static bool decode(const CompactNode& node, QRectF& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    rhs = QRectF(node["left"].as<qreal>(),
+                 node["top"].as<qreal>(),
+                 node["width"].as<qreal>(),
+                 node["height"].as<qreal>());
+    return true;
+  }
+};
+
+/* = QSize, QSizeF
+   ======================================================================================*/
+template<>
+struct compact_convert<QSize>
+{
+  static bool decode(const CompactNode& node, QSize& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    rhs = QSize(node["width"].as<int>(), node["height"].as<int>());
+    return true;
+  }
+};
+
+template<>
+struct compact_convert<QSizeF>
+{
+  static bool decode(const CompactNode& node, QSizeF& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    rhs = QSizeF(node["width"].as<qreal>(), node["height"].as<qreal>());
+    return true;
+  }
+};
+
+/* = QPixmap, QImage
+   ======================================================================================*/
+template<>
+struct compact_convert<QPixmap>
+{
+  static bool decode(const CompactNode& node, QPixmap& rhs) {
+    QByteArray array;
+
+    if (!compact_convert<QByteArray>::decode(node, array)) {
+      return false;
+    }
+
+    QPixmap pixmap;
+    bool res = pixmap.loadFromData(array, "PNG");
+
+    if (res) {
+      rhs = pixmap;
+    }
+
+    return res;
+  }
+};
+
+template<>
+struct compact_convert<QImage>
+{
+  static bool decode(const CompactNode& node, QImage& rhs) {
+    QByteArray array;
+
+    if (!compact_convert<QByteArray>::decode(node, array)) {
+      return false;
+    }
+
+    QImage image;
+    bool res = image.loadFromData(array, "PNG");
+
+    if (res) {
+      rhs = image;
+    }
+
+    return res;
+  }
+};
+
+/* = collections
+   ======================================================================================*/
+template<class T>
+struct compact_convert<QList<T>>
+{
+  static bool decode(const CompactNode& node, QList<T>& rhs) {
+    if (!node.IsSequence()) {
+      return false;
+    }
+
+    const int size = int(node.size());
+    rhs.clear();
+    rhs.reserve(size);
+
+    for (int i = 0; i < size; ++i) {
+      rhs.append(node[i].as<T>());
+    }
+
+    return true;
+  }
+};
+
+template<>
+struct compact_convert<QStringList>
+{
+  static bool decode(const CompactNode& node, QStringList& rhs) {
+    return compact_convert<QList<QString>>::decode(node, rhs);
+  }
+};
+
+template<class T>
+struct compact_convert<QVector<T>>
+{
+  static bool decode(const CompactNode& node, QVector<T>& rhs) {
+    if (!node.IsSequence()) {
+      return false;
+    }
+
+    const int size = int(node.size());
+    rhs.clear();
+    rhs.reserve(size);
+
+    for (int i = 0; i < size; ++i) {
+      rhs.append(node[i].as<T>());
+    }
+
+    return true;
+  }
+};
+
+template<class T>
+struct compact_convert<QSet<T>>
+{
+  static bool decode(const CompactNode& node, QSet<T>& rhs) {
+    if (!node.IsSequence()) {
+      return false;
+    }
+
+    const int size = int(node.size());
+    rhs.clear();
+    rhs.reserve(size);
+
+    for (int i = 0; i < size; ++i) {
+      rhs.insert(node[i].as<T>());
+    }
+
+    return true;
+  }
+};
+
+template<class K, class V>
+struct compact_convert<QMap<K, V>>
+{
+  static bool decode(const CompactNode& node, QMap<K, V>& rhs) {
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    const int size = int(node.size());
+    rhs.clear();
+
+    for (int i = 0; i < size; ++i) {
+      rhs.insert(node.key(i).as<K>(), node.value(i).as<V>());
+    }
+
+    return true;
+  }
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_COMPACT_H
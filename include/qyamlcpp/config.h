@@ -0,0 +1,41 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_CONFIG_H
+#define QYAML_CONFIG_H
+
+/*
+   By default qyamlcpp is header only and every function is defined inline in
+   the headers. The qyamlcpp_compiled target defines QYAMLCPP_COMPILED_LIB
+   for itself and its users, the function bodies in the *-inl.h headers are
+   then compiled once into the library from src/ and the headers only
+   declare them.
+*/
+#if defined(QYAMLCPP_COMPILED_LIB)
+#define QYAMLCPP_INLINE
+#else
+#define QYAMLCPP_INLINE inline
+#endif
+
+#endif // QYAML_CONFIG_H
@@ -0,0 +1,494 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_DIFF_H
+#define QYAML_DIFF_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "hash.h"
+#include "instrument.h"
+#include "path.h"
+
+namespace QYaml {
+
+/*!
+   \brief A YAML::Node tree with a hash of every subtree.
+
+   Built once per loaded document. Comparing two HashedTrees skips any
+   subtrees whose hashes match without looking inside them, so diff() costs
+   roughly the size of the change rather than the size of the document. Map
+   hashes do not depend on key order.
+
+   The tree holds handles to the document's nodes, so editing the document
+   afterwards leaves the hashes out of date.
+*/
+class HashedTree
+{
+public:
+  HashedTree() = default;
+
+  explicit HashedTree(const YAML::Node& root) {
+    m_entries.push_back(Entry(std::string(), root));
+    fill(0);
+  }
+
+  YAML::Node root() const {
+    return m_entries.empty() ? YAML::Node(YAML::NodeType::Undefined)
+                             : m_entries.front().node;
+  }
+
+  quint64 hash() const { return m_entries.empty() ? 0 : m_entries.front().hash; }
+
+private:
+  friend class TreeDiff;
+
+  enum Marker : quint64
+  {
+    NullMarker = 0x6e756c6cULL,
+    ScalarMarker = 0x7363616cULL,
+    SequenceMarker = 0x73657175ULL,
+    MapMarker = 0x6d617070ULL
+  };
+
+  // Entries are stored flat, the children of a node are contiguous and map
+  // children are sorted by key so two maps can be merged in one pass.
+  struct Entry
+  {
+    Entry(const std::string& k, const YAML::Node& n)
+      : key(k)
+      , node(n)
+      , hash(0)
+      , first(0)
+      , count(0) {}
+
+    Entry(const Entry&) = default;
+
+    // std::sort assigns entries, and assigning a YAML::Node would overwrite
+    // the document rather than rebind the handle.
+    Entry& operator=(const Entry& other) {
+      key = other.key;
+      node.reset(other.node);
+      hash = other.hash;
+      first = other.first;
+      count = other.count;
+      return *this;
+    }
+
+    std::string key;
+    YAML::Node node;
+    quint64 hash;
+    int first;
+    int count;
+  };
+
+  static bool keyLess(const Entry& lhs, const Entry& rhs) { return lhs.key < rhs.key; }
+
+  static quint64 combine(quint64 marker, quint64 count, quint64 value) {
+    const quint64 words[2] = { count, value };
+    return XXHash64::hash(reinterpret_cast<const char*>(words), sizeof(words), marker);
+  }
+
+  // Works on indices and a copy of the node handle, as push_back may move
+  // the entries. Children are filled after all of them have been added.
+  void fill(int index) {
+    const YAML::Node node = m_entries[std::size_t(index)].node;
+    const int first = int(m_entries.size());
+    int count = 0;
+    quint64 hash = 0;
+
+    switch (node.Type()) {
+      case YAML::NodeType::Map: {
+        for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+          m_entries.push_back(Entry(
+            it->first.IsScalar() ? it->first.Scalar() : YAML::Dump(it->first),
+            it->second));
+        }
+
+        std::sort(m_entries.begin() + first, m_entries.end(), &keyLess);
+        count = int(m_entries.size()) - first;
+        quint64 sum = 0;
+
+        for (int i = first; i < first + count; ++i) {
+          fill(i);
+          const Entry& child = m_entries[std::size_t(i)];
+          sum += XXHash64::hash(child.key.data(), child.key.size(), child.hash);
+        }
+
+        hash = combine(MapMarker, quint64(count), sum);
+        break;
+      }
+
+      case YAML::NodeType::Sequence: {
+        for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+          m_entries.push_back(Entry(std::string(), *it));
+        }
+
+        count = int(m_entries.size()) - first;
+        XXHash64 sequence(SequenceMarker);
+
+        for (int i = first; i < first + count; ++i) {
+          fill(i);
+          const quint64 child = m_entries[std::size_t(i)].hash;
+          sequence.addData(reinterpret_cast<const char*>(&child), sizeof(child));
+        }
+
+        hash = combine(SequenceMarker, quint64(count), sequence.result());
+        break;
+      }
+
+      case YAML::NodeType::Scalar: {
+        // the tag tells "1" apart from 1.
+        const std::string& tag = node.Tag();
+        const std::string& scalar = node.Scalar();
+        const quint64 tagSize = tag.size();
+        XXHash64 value(ScalarMarker);
+        value.addData(reinterpret_cast<const char*>(&tagSize), sizeof(tagSize));
+        value.addData(tag.data(), tag.size());
+        value.addData(scalar.data(), scalar.size());
+        hash = value.result();
+        break;
+      }
+
+      default:
+        hash = combine(NullMarker, 0, 0);
+        break;
+    }
+
+    Entry& entry = m_entries[std::size_t(index)];
+    entry.hash = hash;
+    entry.first = first;
+    entry.count = count;
+  }
+
+  std::vector<Entry> m_entries;
+};
+
+/*!
+   \brief One difference between two documents.
+
+   path holds the map keys, and sequence indices as numbers, from the root
+   to the changed node, so it can be passed straight to QYaml::Path. before
+   is undefined for Added and after is undefined for Removed.
+*/
+struct Change
+{
+  enum Kind
+  {
+    Added,
+    Removed,
+    Modified
+  };
+
+  Change()
+    : kind(Modified) {}
+
+  Change(Kind k, const QStringList& p, const YAML::Node& b, const YAML::Node& a)
+    : kind(k)
+    , path(p)
+    , before(b)
+    , after(a) {}
+
+  Change(const Change&) = default;
+
+  Change& operator=(const Change& other) {
+    kind = other.kind;
+    path = other.path;
+    before.reset(other.before);
+    after.reset(other.after);
+    return *this;
+  }
+
+  Kind kind;
+  QStringList path;
+  YAML::Node before;
+  YAML::Node after;
+};
+
+typedef QVector<Change> ChangeList;
+
+class TreeDiff
+{
+public:
+  TreeDiff(const HashedTree& before, const HashedTree& after, ChangeList& changes)
+    : m_before(before.m_entries)
+    , m_after(after.m_entries)
+    , m_changes(changes) {}
+
+  void run() {
+    if (m_before.empty() || m_after.empty()) {
+      if (!m_before.empty()) {
+        removed(m_before.front().node);
+      } else if (!m_after.empty()) {
+        added(m_after.front().node);
+      }
+
+      return;
+    }
+
+    compare(0, 0);
+  }
+
+private:
+  typedef HashedTree::Entry Entry;
+
+  void added(const YAML::Node& node) {
+    m_changes.append(
+      Change(Change::Added, m_path, YAML::Node(YAML::NodeType::Undefined), node));
+  }
+
+  void removed(const YAML::Node& node) {
+    m_changes.append(
+      Change(Change::Removed, m_path, node, YAML::Node(YAML::NodeType::Undefined)));
+  }
+
+  void compare(int before, int after) {
+    const Entry& lhs = m_before[std::size_t(before)];
+    const Entry& rhs = m_after[std::size_t(after)];
+
+    if (lhs.hash == rhs.hash) {
+      return;
+    }
+
+    const YAML::NodeType::value type = lhs.node.Type();
+
+    if (type != rhs.node.Type() ||
+        (type != YAML::NodeType::Map && type != YAML::NodeType::Sequence)) {
+      m_changes.append(Change(Change::Modified, m_path, lhs.node, rhs.node));
+      return;
+    }
+
+    if (type == YAML::NodeType::Map) {
+      compareMaps(lhs, rhs);
+    } else {
+      compareSequences(lhs, rhs);
+    }
+  }
+
+  void compareMaps(const Entry& lhs, const Entry& rhs) {
+    int i = lhs.first;
+    int j = rhs.first;
+    const int lhsEnd = lhs.first + lhs.count;
+    const int rhsEnd = rhs.first + rhs.count;
+
+    while (i < lhsEnd || j < rhsEnd) {
+      const Entry* left = i < lhsEnd ? &m_before[std::size_t(i)] : nullptr;
+      const Entry* right = j < rhsEnd ? &m_after[std::size_t(j)] : nullptr;
+
+      if (left && (!right || left->key < right->key)) {
+        m_path.append(QString::fromStdString(left->key));
+        removed(left->node);
+        ++i;
+      } else if (right && (!left || right->key < left->key)) {
+        m_path.append(QString::fromStdString(right->key));
+        added(right->node);
+        ++j;
+      } else {
+        m_path.append(QString::fromStdString(left->key));
+        compare(i++, j++);
+      }
+
+      m_path.removeLast();
+    }
+  }
+
+  void compareSequences(const Entry& lhs, const Entry& rhs) {
+    const int common = std::min(lhs.count, rhs.count);
+
+    for (int k = 0; k < std::max(lhs.count, rhs.count); ++k) {
+      m_path.append(QString::number(k));
+
+      if (k < common) {
+        compare(lhs.first + k, rhs.first + k);
+      } else if (k < lhs.count) {
+        removed(m_before[std::size_t(lhs.first + k)].node);
+      } else {
+        added(m_after[std::size_t(rhs.first + k)].node);
+      }
+
+      m_path.removeLast();
+    }
+  }
+
+  const std::vector<Entry>& m_before;
+  const std::vector<Entry>& m_after;
+  ChangeList& m_changes;
+  QStringList m_path;
+};
+
+/*!
+   \brief The changes that turn before into after.
+
+   A modified scalar, or a node whose type changed, is reported at its own
+   path. Added and removed map entries and sequence items are reported at
+   theirs, without listing their contents.
+*/
+inline ChangeList diff(const HashedTree& before, const HashedTree& after)
+{
+  QYAML_PROBE("QYaml::diff");
+  ChangeList changes;
+  TreeDiff(before, after, changes).run();
+  return changes;
+}
+
+inline ChangeList diff(const YAML::Node& before, const YAML::Node& after)
+{
+  return diff(HashedTree(before), HashedTree(after));
+}
+
+/*!
+   \brief Ties document paths to Qt values, so a reload only re-runs the
+   converters whose values changed.
+
+   \code
+   QYaml::Bindings bindings;
+   bindings.bind("editor/background", &m_background);
+   bindings.bind<QFont>("editor/font", [this](const QFont& font) { setFont(font); });
+
+   QYaml::HashedTree current(YAML::LoadFile(path));
+   bindings.apply(current.root());
+
+   // later, when the file changes
+   QYaml::HashedTree reloaded(YAML::LoadFile(path));
+   bindings.patch(QYaml::diff(current, reloaded), reloaded.root());
+   current = std::move(reloaded);
+   \endcode
+
+   A binding is updated if a change is at, above or below its path. If its
+   node was removed, or cannot be converted, the bound value is left alone.
+*/
+class Bindings
+{
+public:
+  template<class T>
+  void bind(const QString& path, std::function<void(const T&)> setter) {
+    Binding binding;
+    binding.path = Path(path);
+    binding.segments = binding.path.segments();
+    binding.decode = [setter](const YAML::Node& node) {
+      T value;
+
+      if (!YAML::convert<T>::decode(node, value)) {
+        return false;
+      }
+
+      setter(value);
+      return true;
+    };
+
+    m_bindings.push_back(binding);
+  }
+
+  template<class T>
+  void bind(const QString& path, T* target) {
+    bind<T>(path, [target](const T& value) { *target = value; });
+  }
+
+  int size() const { return int(m_bindings.size()); }
+  void clear() { m_bindings.clear(); }
+
+  /*!
+     \brief Converts every bound value from root. Returns the number of
+     values set.
+  */
+  int apply(const YAML::Node& root) const {
+    int applied = 0;
+
+    for (const Binding& binding : m_bindings) {
+      applied += update(binding, root);
+    }
+
+    return applied;
+  }
+
+  /*!
+     \brief Converts only the bound values that changes touch, reading them
+     from root, the document the changes lead to. Returns the number of
+     values set.
+  */
+  int patch(const ChangeList& changes, const YAML::Node& root) const {
+    int applied = 0;
+
+    for (const Binding& binding : m_bindings) {
+      for (const Change& change : changes) {
+        if (overlaps(binding.segments, change.path)) {
+          applied += update(binding, root);
+          break;
+        }
+      }
+    }
+
+    return applied;
+  }
+
+private:
+  struct Binding
+  {
+    Path path;
+    QStringList segments;
+    std::function<bool(const YAML::Node&)> decode;
+  };
+
+  // true if either path is a prefix of the other.
+  static bool overlaps(const QStringList& lhs, const QStringList& rhs) {
+    const int common = std::min(lhs.size(), rhs.size());
+
+    for (int i = 0; i < common; ++i) {
+      if (lhs.at(i) != rhs.at(i)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  static int update(const Binding& binding, const YAML::Node& root) {
+    const YAML::Node node = binding.path.resolveNode(root);
+
+    if (!node.IsDefined()) {
+      return 0;
+    }
+
+    try {
+      return binding.decode(node) ? 1 : 0;
+    } catch (const YAML::Exception&) {
+      return 0;
+    }
+  }
+
+  std::vector<Binding> m_bindings;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_DIFF_H
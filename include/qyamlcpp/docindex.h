@@ -0,0 +1,576 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_DOCINDEX_H
+#define QYAML_DOCINDEX_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QMultiHash>
+#include <QSaveFile>
+#include <QString>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "multidoc.h"
+#include "streambuf.h"
+
+namespace QYaml {
+
+/*!
+   \brief A byte offset index of the documents in a multi document YAML
+   file, for loading single documents without parsing the rest.
+
+   build() scans the file once for document boundaries, and can also record
+   the value of one top-level key of each document. The value is read from
+   the document's "key: value" line and the document is only parsed when
+   the value is not a simple scalar. The index is saved next to the file as
+   fileName.qyidx, and load() rejects it if the file has changed size or
+   modification time since, or if it was built for a different key.
+
+   \code
+   QYaml::DocumentIndex index(archivePath);
+
+   if (!index.load("id")) {
+      index.build("id");
+      index.save();
+   }
+
+   YAML::Node last = index.loadDocument(index.count() - 1);
+   std::vector<YAML::Node> matches = index.loadByKey("4f1c9a");
+   \endcode
+
+   A document that uses %TAG handles declared by an earlier document is
+   loaded with those directives, as yaml-cpp keeps them from one document
+   to the next.
+
+   Loading reads through a QFile kept open by the index, so an index must
+   not be used from several threads at once.
+*/
+class DocumentIndex
+{
+public:
+  struct Entry
+  {
+    quint64 offset;
+    quint64 length;
+    // the directives inherited from an earlier document, if any.
+    quint64 directivesOffset;
+    quint64 directivesLength;
+    bool hasKey;
+    QString key;
+  };
+
+  explicit DocumentIndex(const QString& fileName)
+    : m_fileName(fileName)
+    , m_fileSize(0)
+    , m_file(fileName) {}
+
+  QString fileName() const { return m_fileName; }
+  QString indexFileName() const { return m_fileName + QStringLiteral(".qyidx"); }
+
+  /*!
+     \brief The top-level key whose values are indexed, empty if none.
+  */
+  QString keyName() const { return m_keyName; }
+
+  int count() const { return m_entries.size(); }
+  const Entry& entry(int index) const { return m_entries.at(index); }
+
+  /*!
+     \brief Scans the file, recording every document and, if keyName is not
+     empty, the value of that top-level key.
+  */
+  bool build(const QString& keyName = QString()) {
+    clear();
+    m_keyName = keyName;
+
+    QFile file(m_fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+      return false;
+    }
+
+    const qint64 size = file.size();
+    QByteArray contents;
+    const char* data = nullptr;
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+
+    if (mapped) {
+      data = reinterpret_cast<const char*>(mapped);
+    } else {
+      contents = file.readAll();
+      data = contents.constData();
+    }
+
+    const std::string key = keyName.toStdString();
+    const QVector<DocumentRange> ranges = documentRanges(data, std::size_t(size));
+    detail::DirectiveTracker directives(data, std::size_t(size));
+    m_entries.reserve(ranges.size());
+
+    for (const DocumentRange& range : ranges) {
+      const DocumentRange inherited = directives.inherited(range.offset);
+      Entry entry;
+      entry.offset = range.offset;
+      entry.length = range.length;
+      entry.directivesOffset = inherited.offset;
+      entry.directivesLength = inherited.length;
+      entry.hasKey = !key.empty() && findKey(data + range.offset, range.length, key, entry.key);
+      m_entries.append(entry);
+    }
+
+    if (mapped) {
+      file.unmap(mapped);
+    }
+
+    const QFileInfo info(m_fileName);
+    m_fileSize = info.size();
+    m_modified = info.lastModified();
+    rebuildKeys();
+    return true;
+  }
+
+  /*!
+     \brief Writes the index to indexFileName().
+  */
+  bool save() const {
+    QSaveFile file(indexFileName());
+
+    if (!file.open(QIODevice::WriteOnly)) {
+      return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint32(Magic) << quint32(Version) << qint64(m_fileSize)
+        << m_modified.toMSecsSinceEpoch() << m_keyName << qint32(m_entries.size());
+
+    for (const Entry& entry : m_entries) {
+      out << entry.offset << entry.length << entry.directivesOffset << entry.directivesLength
+          << entry.hasKey << entry.key;
+    }
+
+    return out.status() == QDataStream::Ok && file.commit();
+  }
+
+  /*!
+     \brief Reads the index from indexFileName(). Returns false if there is
+     none, or if the YAML file has changed since it was built.
+
+     The index may have been built for any key, or none; keyName() tells
+     which.
+  */
+  bool load() {
+    clear();
+
+    QFile file(indexFileName());
+    const QFileInfo info(m_fileName);
+
+    if (!info.exists() || !file.open(QIODevice::ReadOnly)) {
+      return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0, version = 0;
+    qint64 fileSize = 0, modified = 0;
+    qint32 count = 0;
+    in >> magic >> version >> fileSize >> modified >> m_keyName >> count;
+
+    if (in.status() != QDataStream::Ok || magic != Magic || version != Version ||
+        fileSize != info.size() ||
+        modified != info.lastModified().toMSecsSinceEpoch() || count < 0) {
+      clear();
+      return false;
+    }
+
+    m_entries.reserve(count);
+
+    for (qint32 i = 0; i < count; ++i) {
+      Entry entry;
+      in >> entry.offset >> entry.length >> entry.directivesOffset >> entry.directivesLength >>
+        entry.hasKey >> entry.key;
+      m_entries.append(entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+      clear();
+      return false;
+    }
+
+    m_fileSize = fileSize;
+    m_modified = info.lastModified();
+    rebuildKeys();
+    return true;
+  }
+
+  /*!
+     \brief Reads the index as load() does, but also returns false if it was
+     built for a key other than keyName.
+  */
+  bool load(const QString& keyName) {
+    if (!load()) {
+      return false;
+    }
+
+    if (m_keyName != keyName) {
+      clear();
+      return false;
+    }
+
+    return true;
+  }
+
+  void clear() {
+    m_entries.clear();
+    m_keys.clear();
+    m_keyName.clear();
+    m_fileSize = 0;
+    m_modified = QDateTime();
+  }
+
+  /*!
+     \brief The indices of the documents whose key has value, in file order.
+  */
+  QList<int> indicesOf(const QString& value) const {
+    QList<int> indices = m_keys.values(value);
+    std::sort(indices.begin(), indices.end());
+    return indices;
+  }
+
+  /*!
+     \brief Reads and parses document index only.
+
+     @throws {@link ParserException} if the document is malformed. Its mark
+     is relative to the start of the document.
+  */
+  YAML::Node loadDocument(int index) const {
+    if (index < 0 || index >= m_entries.size()) {
+      return YAML::Node(YAML::NodeType::Undefined);
+    }
+
+    const Entry& entry = m_entries.at(index);
+    const QByteArray directives = read(entry.directivesOffset, entry.directivesLength);
+    const QByteArray document = read(entry.offset, entry.length);
+
+    if (directives.isNull() || document.isNull()) {
+      return YAML::Node(YAML::NodeType::Undefined);
+    }
+
+    const QByteArray data = directives.isEmpty() ? document : directives + document;
+
+    try {
+      ByteArrayStreamBuf buffer(data);
+      std::istream stream(&buffer);
+      return YAML::Load(stream);
+    } catch (const YAML::ParserException&) {
+      detail::rethrowMoved(std::current_exception(),
+                           -qint64(directives.size()),
+                           -detail::lineCount(directives.constData(),
+                                              directives.constData() + directives.size()));
+      throw;
+    }
+  }
+
+  /*!
+     \brief Loads the documents whose indexed key has value.
+  */
+  std::vector<YAML::Node> loadByKey(const QString& value) const {
+    std::vector<YAML::Node> documents;
+
+    for (int index : indicesOf(value)) {
+      documents.push_back(loadDocument(index));
+    }
+
+    return documents;
+  }
+
+private:
+  enum : quint32
+  {
+    Magic = 0x5159494eu, // QYIN
+    Version = 2
+  };
+
+  // an empty, not null, array for a zero length.
+  QByteArray read(quint64 offset, quint64 length) const {
+    if (length == 0) {
+      return QByteArray("");
+    }
+
+    if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly)) {
+      return QByteArray();
+    }
+
+    if (!m_file.seek(qint64(offset))) {
+      return QByteArray();
+    }
+
+    QByteArray data = m_file.read(qint64(length));
+    return data.size() == int(length) ? data : QByteArray();
+  }
+
+  void rebuildKeys() {
+    m_keys.clear();
+    m_keys.reserve(m_entries.size());
+
+    for (int i = 0; i < m_entries.size(); ++i) {
+      if (m_entries.at(i).hasKey) {
+        m_keys.insert(m_entries.at(i).key, i);
+      }
+    }
+  }
+
+  // Looks for a "key: value" line at column 0 and reads a plain or simply
+  // quoted value from it. Anything else, such as a flow mapping document, a
+  // block or multi-line value, or a key line that may sit inside a quoted
+  // scalar left open by an earlier line, is parsed.
+  static bool findKey(const char* data, std::size_t size, const std::string& key, QString& value) {
+    const char* const end = data + size;
+    bool flowDocument = false;
+    char openQuote = 0;
+
+    for (const char* line = data; line < end; line = detail::nextLine(line, end)) {
+      const char* lineEnd = detail::nextLine(line, end);
+      const bool inQuote = openQuote != 0;
+      openQuote = scanQuotes(line, lineEnd, openQuote);
+
+      if (inQuote) {
+        if (matchKey(line, lineEnd, key)) {
+          return parseKey(data, size, key, value);
+        }
+
+        continue;
+      }
+
+      const char* start = line;
+
+      if (detail::isMarker(line, lineEnd, '-')) {
+        start += 3;
+
+        while (start < lineEnd && (*start == ' ' || *start == '\t')) {
+          ++start;
+        }
+      }
+
+      if (start < lineEnd && *start == '{') {
+        flowDocument = true;
+      }
+
+      const char* p = matchKey(line, lineEnd, key);
+
+      if (!p) {
+        continue;
+      }
+
+      while (p < lineEnd && (*p == ' ' || *p == '\t')) {
+        ++p;
+      }
+
+      if (!continues(lineEnd, end) && scalarValue(p, lineEnd, value)) {
+        return true;
+      }
+
+      return parseKey(data, size, key, value);
+    }
+
+    return flowDocument && parseKey(data, size, key, value);
+  }
+
+  // Returns the quote still open at the end of the line, given the one open
+  // at its start. A quote only opens where a scalar can start, so the
+  // apostrophe in a plain "don't" does not count.
+  static char scanQuotes(const char* p, const char* end, char quote) {
+    for (const char* start = p; p < end; ++p) {
+      if (quote == '"') {
+        if (*p == '\\') {
+          ++p;
+        } else if (*p == '"') {
+          quote = 0;
+        }
+      } else if (quote == '\'') {
+        if (*p == '\'' && p + 1 < end && p[1] == '\'') {
+          ++p;
+        } else if (*p == '\'') {
+          quote = 0;
+        }
+      } else if (*p == '#' && (p == start || p[-1] == ' ' || p[-1] == '\t')) {
+        break;
+      } else if ((*p == '"' || *p == '\'') &&
+                 (p == start || std::strchr(" \t[{,:-?", p[-1]))) {
+        quote = *p;
+      }
+    }
+
+    return quote;
+  }
+
+  // True if the lines after a value continue it: the next line that is not
+  // blank is indented and is not a comment.
+  static bool continues(const char* line, const char* end) {
+    for (; line < end; line = detail::nextLine(line, end)) {
+      const char* p = line;
+
+      while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+      }
+
+      if (p == end || *p == '\n' || *p == '\r') {
+        continue;
+      }
+
+      return p != line && *p != '#';
+    }
+
+    return false;
+  }
+
+  static const char* matchKey(const char* line, const char* end, const std::string& key) {
+    const std::size_t available = std::size_t(end - line);
+    const char* p = nullptr;
+
+    if (available > key.size() && std::memcmp(line, key.data(), key.size()) == 0) {
+      p = line + key.size();
+    } else if (available > key.size() + 2 && (line[0] == '"' || line[0] == '\'') &&
+               std::memcmp(line + 1, key.data(), key.size()) == 0 &&
+               line[key.size() + 1] == line[0]) {
+      p = line + key.size() + 2;
+    }
+
+    if (!p || p >= end || *p != ':') {
+      return nullptr;
+    }
+
+    ++p;
+    return (p == end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ? p : nullptr;
+  }
+
+  static bool scalarValue(const char* p, const char* end, QString& value) {
+    while (end > p && (end[-1] == '\n' || end[-1] == '\r')) {
+      --end;
+    }
+
+    if (p == end) {
+      return false;
+    }
+
+    if (*p == '\'') {
+      std::string text;
+
+      for (++p; p < end; ++p) {
+        if (*p == '\'') {
+          if (p + 1 < end && p[1] == '\'') {
+            text += '\'';
+            ++p;
+            continue;
+          }
+
+          value = QString::fromStdString(text);
+          return true;
+        }
+
+        text += *p;
+      }
+
+      return false;
+    }
+
+    // escapes are left to the parser.
+    if (*p == '"') {
+      const char* close = static_cast<const char*>(std::memchr(p + 1, '"', std::size_t(end - p - 1)));
+
+      if (!close || std::memchr(p + 1, '\\', std::size_t(close - p - 1))) {
+        return false;
+      }
+
+      value = QString::fromUtf8(p + 1, int(close - p - 1));
+      return true;
+    }
+
+    if (std::strchr("[{|>&*!%@`#", *p)) {
+      return false;
+    }
+
+    const char* valueEnd = p;
+
+    for (const char* q = p; q < end; ++q) {
+      if (*q == '#' && (q[-1] == ' ' || q[-1] == '\t')) {
+        break;
+      }
+
+      if (*q != ' ' && *q != '\t') {
+        valueEnd = q + 1;
+      }
+    }
+
+    value = QString::fromUtf8(p, int(valueEnd - p));
+    return true;
+  }
+
+  static bool parseKey(const char* data, std::size_t size, const std::string& key, QString& value) {
+    try {
+      ByteArrayStreamBuf buffer(data, size);
+      std::istream stream(&buffer);
+      const YAML::Node document = YAML::Load(stream);
+
+      if (!document.IsMap()) {
+        return false;
+      }
+
+      const YAML::Node node = document[key];
+
+      if (!node.IsScalar()) {
+        return false;
+      }
+
+      value = QString::fromStdString(node.Scalar());
+      return true;
+    } catch (const YAML::Exception&) {
+      return false;
+    }
+  }
+
+  QString m_fileName;
+  QString m_keyName;
+  qint64 m_fileSize;
+  QDateTime m_modified;
+  QVector<Entry> m_entries;
+  QMultiHash<QString, int> m_keys;
+  mutable QFile m_file;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_DOCINDEX_H
@@ -0,0 +1,393 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_EMITTER_INL_H
+#define QYAML_EMITTER_INL_H
+
+#include "emitter.h"
+
+namespace YAML {
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QString& v)
+{
+  QYAML_PROBE("QString::emit");
+
+  return emitter.Write(v.toStdString());
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QString& v)
+{
+  QYAML_PROBE("QString::emit");
+
+  return emitter.Write(v.toStdString());
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QStringList& v)
+{
+  QYAML_PROBE("QStringList::emit");
+
+  emitter << YAML::BeginSeq;
+
+  for (const QString& s : v) {
+    emitter << s;
+  }
+
+  emitter << YAML::EndSeq;
+
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QVariant& v)
+{
+  QYAML_PROBE("QVariant::emit");
+
+  return emitter.Write(v.toString().toStdString());
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QByteArray& v)
+{
+  QYAML_PROBE("QByteArray::emit");
+  QYAML_PROBE_BYTES(v.size());
+
+  size_t size = size_t(v.size());
+  const char* data = v.constData();
+  return emitter << YAML::Binary(reinterpret_cast<const unsigned char*>(data),
+                                 size_t(size));
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QBuffer& v)
+{
+  QYAML_PROBE("QBuffer::emit");
+
+  QByteArray data = v.buffer();
+  return emitter << data;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QPixmap& v)
+{
+  QYAML_PROBE("QPixmap::emit");
+
+  QByteArray array;
+  QBuffer buffer(&array);
+  buffer.open(QIODevice::WriteOnly);
+  v.save(&buffer, "PNG");
+  emitter << array;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QColor& v)
+{
+  QYAML_PROBE("QColor::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "red";
+  emitter << YAML::Value << v.red();
+  emitter << YAML::Key << "green";
+  emitter << YAML::Value << v.green();
+  emitter << YAML::Key << "blue";
+  emitter << YAML::Value << v.blue();
+  emitter << YAML::Key << "alpha";
+  emitter << YAML::Value << v.alpha();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QFont& v)
+{
+  QYAML_PROBE("QFont::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "family";
+  emitter << YAML::Value << v.family().toStdString();
+  emitter << YAML::Key << "bold";
+  emitter << YAML::Value << v.bold();
+  emitter << YAML::Key << "capitalization";
+  emitter << YAML::Value << v.capitalization();
+  emitter << YAML::Key << "fixedpitch";
+  emitter << YAML::Value << v.fixedPitch();
+  emitter << YAML::Key << "hinting preference";
+  emitter << YAML::Value << v.hintingPreference();
+  emitter << YAML::Key << "italic";
+  emitter << YAML::Value << v.italic();
+  emitter << YAML::Key << "kerning";
+  emitter << YAML::Value << v.kerning();
+  emitter << YAML::Key << "letter spacing";
+  emitter << YAML::Value << v.letterSpacing();
+  emitter << YAML::Key << "letter spacing type";
+  emitter << YAML::Value << v.letterSpacingType();
+  emitter << YAML::Key << "overline";
+  emitter << YAML::Value << v.overline();
+  // not recommended to use pixelSize()
+  emitter << YAML::Key << "point size";
+  emitter << YAML::Value << v.pointSize();
+  emitter << YAML::Key << "stretch";
+  emitter << YAML::Value << v.stretch();
+  emitter << YAML::Key << "strikeout";
+  emitter << YAML::Value << v.strikeOut();
+  emitter << YAML::Key << "style";
+  emitter << YAML::Value << v.style();
+  emitter << YAML::Key << "style hint";
+  emitter << YAML::Value << v.styleHint();
+  emitter << YAML::Key << "style name";
+  emitter << YAML::Value << v.styleName().toStdString();
+  emitter << YAML::Key << "style strategy";
+  emitter << YAML::Value << v.styleStrategy();
+  emitter << YAML::Key << "underline";
+  emitter << YAML::Value << v.underline();
+  emitter << YAML::Key << "weight";
+  emitter << YAML::Value << v.weight();
+  emitter << YAML::Key << "word spacing";
+  emitter << YAML::Value << v.wordSpacing();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QPoint& v)
+{
+  QYAML_PROBE("QPoint::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "x";
+  emitter << YAML::Value << v.x();
+  emitter << YAML::Key << "y";
+  emitter << YAML::Value << v.y();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QPointF& v)
+{
+  QYAML_PROBE("QPointF::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "x";
+  emitter << YAML::Value << v.x();
+  emitter << YAML::Key << "y";
+  emitter << YAML::Value << v.y();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QRect& v)
+{
+  QYAML_PROBE("QRect::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "left";
+  emitter << YAML::Value << v.left();
+  emitter << YAML::Key << "top";
+  emitter << YAML::Value << v.top();
+  emitter << YAML::Key << "width";
+  emitter << YAML::Value << v.width();
+  emitter << YAML::Key << "height";
+  emitter << YAML::Value << v.height();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QRectF& v)
+{
+  QYAML_PROBE("QRectF::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "left";
+  emitter << YAML::Value << v.left();
+  emitter << YAML::Key << "top";
+  emitter << YAML::Value << v.top();
+  emitter << YAML::Key << "width";
+  emitter << YAML::Value << v.width();
+  emitter << YAML::Key << "height";
+  emitter << YAML::Value << v.height();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QSize& v)
+{
+  QYAML_PROBE("QSize::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "width";
+  emitter << YAML::Value << v.width();
+  emitter << YAML::Key << "height";
+  emitter << YAML::Value << v.height();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, QSizeF& v)
+{
+  QYAML_PROBE("QSizeF::emit");
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "width";
+  emitter << YAML::Value << v.width();
+  emitter << YAML::Key << "height";
+  emitter << YAML::Value << v.height();
+  emitter << YAML::EndMap;
+  return emitter;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QDateTime& v)
+{
+  QYAML_PROBE("QDateTime::emit");
+
+  char buffer[QYaml::Iso8601::DateTimeLength];
+  const int length = QYaml::Iso8601::formatDateTime(v, buffer);
+
+  if (length == 0) {
+    return emitter << YAML::Null;
+  }
+
+  return emitter.Write(std::string(buffer, std::size_t(length)));
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QDate& v)
+{
+  QYAML_PROBE("QDate::emit");
+
+  char buffer[QYaml::Iso8601::DateLength];
+  const int length = QYaml::Iso8601::formatDate(v, buffer);
+
+  if (length == 0) {
+    return emitter << YAML::Null;
+  }
+
+  return emitter.Write(std::string(buffer, std::size_t(length)));
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QTime& v)
+{
+  QYAML_PROBE("QTime::emit");
+
+  char buffer[12];
+  const int length = QYaml::Iso8601::formatTime(v, buffer);
+
+  if (length == 0) {
+    return emitter << YAML::Null;
+  }
+
+  return emitter.Write(std::string(buffer, std::size_t(length)));
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QUuid& v)
+{
+  QYAML_PROBE("QUuid::emit");
+
+  const QByteArray text = v.toByteArray();
+  return emitter.Write(std::string(text.constData() + 1, std::size_t(text.size() - 2)));
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QUrl& v)
+{
+  QYAML_PROBE("QUrl::emit");
+
+  return emitter.Write(v.toString().toStdString());
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QLine& v)
+{
+  QYAML_PROBE("QLine::emit");
+
+  emitter << Flow << BeginSeq;
+  QYaml::Packed::write(emitter, v.x1());
+  QYaml::Packed::write(emitter, v.y1());
+  QYaml::Packed::write(emitter, v.x2());
+  QYaml::Packed::write(emitter, v.y2());
+  return emitter << EndSeq;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QLineF& v)
+{
+  QYAML_PROBE("QLineF::emit");
+
+  emitter << Flow << BeginSeq;
+  QYaml::Packed::write(emitter, v.x1());
+  QYaml::Packed::write(emitter, v.y1());
+  QYaml::Packed::write(emitter, v.x2());
+  QYaml::Packed::write(emitter, v.y2());
+  return emitter << EndSeq;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QPolygon& v)
+{
+  QYAML_PROBE("QPolygon::emit");
+
+  emitter << Flow << BeginSeq;
+
+  for (const QPoint& point : v) {
+    QYaml::Packed::write(emitter, point.x());
+    QYaml::Packed::write(emitter, point.y());
+  }
+
+  return emitter << EndSeq;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QPolygonF& v)
+{
+  QYAML_PROBE("QPolygonF::emit");
+
+  emitter << Flow << BeginSeq;
+
+  for (const QPointF& point : v) {
+    QYaml::Packed::write(emitter, point.x());
+    QYaml::Packed::write(emitter, point.y());
+  }
+
+  return emitter << EndSeq;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QTransform& v)
+{
+  QYAML_PROBE("QTransform::emit");
+
+  const qreal values[] = { v.m11(), v.m12(), v.m13(), v.m21(), v.m22(),
+                           v.m23(), v.m31(), v.m32(), v.m33() };
+  emitter << Flow << BeginSeq;
+
+  for (qreal value : values) {
+    QYaml::Packed::write(emitter, value);
+  }
+
+  return emitter << EndSeq;
+}
+
+QYAMLCPP_INLINE Emitter& operator<<(Emitter& emitter, const QMatrix4x4& v)
+{
+  QYAML_PROBE("QMatrix4x4::emit");
+
+  float values[16];
+  v.copyDataTo(values);
+  emitter << Flow << BeginSeq;
+
+  for (float value : values) {
+    QYaml::Packed::write(emitter, value);
+  }
+
+  return emitter << EndSeq;
+}
+
+} // end of namespace YAML
+
+#endif // QYAML_EMITTER_INL_H
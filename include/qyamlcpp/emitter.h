@@ -28,17 +28,37 @@
 #include <QBuffer>
 #include <QByteArray>
 #include <QColor>
+#include <QDate>
+#include <QDateTime>
 #include <QFont>
+#include <QHash>
+#include <QLine>
+#include <QLineF>
+#include <QMatrix4x4>
+#include <QMultiHash>
+#include <QMultiMap>
 #include <QPixmap>
 #include <QPoint>
 #include <QPointF>
+#include <QPolygon>
+#include <QPolygonF>
 #include <QRect>
 #include <QRectF>
 #include <QSize>
 #include <QSizeF>
 #include <QString>
+#include <QStringList>
+#include <QTime>
+#include <QTransform>
+#include <QUrl>
+#include <QUuid>
 #include <QVector>
 
+#include <type_traits>
+#include <utility>
+
+#include "config.h"
+#include "instrument.h"
 #include "node.h"
 #include "collection.h"
 #include <yaml-cpp/yaml.h>
@@ -46,222 +66,172 @@
 namespace YAML {
 
 template<class T>
-inline Emitter& operator<<(Emitter& emitter, const QList<T> v)
+inline Emitter& operator<<(Emitter& emitter, const QList<T>& v)
 {
+  QYAML_TYPED_PROBE("emit", QList<T>);
+
   Node node;
   node = v;
   return emitter << node;
 }
 
 template<class K, class V>
-inline Emitter& operator<<(Emitter& emitter, const QMap<K, V> v)
+inline Emitter& operator<<(Emitter& emitter, const QMap<K, V>& v)
 {
+  QYAML_TYPED_PROBE("emit", QMap<K, V>);
+
   Node node;
   node = v;
   return emitter << node;
 }
 
 template<class T>
-inline Emitter& operator<<(Emitter& emitter, const QVector<T> v)
+inline Emitter& operator<<(Emitter& emitter, const QVector<T>& v)
 {
+  QYAML_TYPED_PROBE("emit", QVector<T>);
+
   Node node;
   node = v;
   return emitter << node;
 }
 
-inline Emitter& operator<<(Emitter& emitter, QString& v)
-{
-  return emitter.Write(v.toStdString());
-}
-
-inline Emitter& operator<<(Emitter& emitter, const QString& v)
-{
-  return emitter.Write(v.toStdString());
-}
+Emitter& operator<<(Emitter& emitter, QString& v);
+Emitter& operator<<(Emitter& emitter, const QString& v);
+Emitter& operator<<(Emitter& emitter, const QStringList& v);
+Emitter& operator<<(Emitter& emitter, QVariant& v);
+Emitter& operator<<(Emitter& emitter, QByteArray& v);
+Emitter& operator<<(Emitter& emitter, QBuffer& v);
+Emitter& operator<<(Emitter& emitter, QPixmap& v);
+Emitter& operator<<(Emitter& emitter, QColor& v);
+Emitter& operator<<(Emitter& emitter, QFont& v);
+Emitter& operator<<(Emitter& emitter, QPoint& v);
+Emitter& operator<<(Emitter& emitter, QPointF& v);
+Emitter& operator<<(Emitter& emitter, QRect& v);
+Emitter& operator<<(Emitter& emitter, QRectF& v);
+Emitter& operator<<(Emitter& emitter, QSize& v);
+Emitter& operator<<(Emitter& emitter, QSizeF& v);
+Emitter& operator<<(Emitter& emitter, const QDateTime& v);
+Emitter& operator<<(Emitter& emitter, const QDate& v);
+Emitter& operator<<(Emitter& emitter, const QTime& v);
+Emitter& operator<<(Emitter& emitter, const QUuid& v);
+Emitter& operator<<(Emitter& emitter, const QUrl& v);
+Emitter& operator<<(Emitter& emitter, const QLine& v);
+Emitter& operator<<(Emitter& emitter, const QLineF& v);
+Emitter& operator<<(Emitter& emitter, const QPolygon& v);
+Emitter& operator<<(Emitter& emitter, const QPolygonF& v);
+Emitter& operator<<(Emitter& emitter, const QTransform& v);
+Emitter& operator<<(Emitter& emitter, const QMatrix4x4& v);
 
-inline Emitter& operator<<(Emitter& emitter, QStringList& v)
-{
-  std::list<std::string> list;
+} // end namespace YAML
 
-  emitter << YAML::BeginSeq;
+namespace QYaml {
+namespace detail {
 
-  for (QString s : v) {
-    emitter << s;
-  }
+// true if an Emitter overload takes a const T&.
+template<class T, class = void>
+struct IsStreamable : std::false_type
+{};
 
-  emitter << YAML::EndSeq;
+template<class T>
+struct IsStreamable<
+  T,
+  decltype(void(std::declval<YAML::Emitter&>() << std::declval<const T&>()))>
+  : std::true_type
+{};
 
-  return emitter;
+template<class T>
+inline void emitElement(YAML::Emitter& emitter, const T& value, std::true_type)
+{
+  emitter << value;
 }
 
-inline Emitter& operator<<(Emitter& emitter, QVariant& v)
+template<class T>
+inline void emitElement(YAML::Emitter& emitter, const T& value, std::false_type)
 {
-  return emitter.Write(v.toString().toStdString());
+  emitter << YAML::convert<T>::encode(value);
 }
 
-inline Emitter& operator<<(Emitter& emitter, QByteArray& v)
+/*
+   Writes value with its own Emitter overload where there is one, so only
+   the types without one are converted to a Node first.
+*/
+template<class T>
+inline void emitElement(YAML::Emitter& emitter, const T& value)
 {
-  size_t size = size_t(v.size());
-  const char* data = v.constData();
-  return emitter << YAML::Binary(reinterpret_cast<const unsigned char*>(data),
-                                 size_t(size));
+  emitElement(emitter, value, IsStreamable<T>());
 }
 
-inline Emitter& operator<<(Emitter& emitter, QBuffer& v)
+// the same layout as convert<QMultiHash> and convert<QMultiMap>.
+template<class Container>
+inline YAML::Emitter& emitMulti(YAML::Emitter& emitter, const Container& v)
 {
-  QByteArray data = v.buffer();
-  return emitter << data;
-}
+  emitter << YAML::BeginMap;
+  typename Container::const_iterator it = v.constBegin();
 
+  while (it != v.constEnd()) {
+    const typename Container::key_type& key = it.key();
+    emitter << YAML::Key;
+    emitElement(emitter, key);
+    emitter << YAML::Value << YAML::BeginSeq;
 
-inline Emitter& operator<<(Emitter& emitter, QPixmap& v)
-{
-  QByteArray array;
-  QBuffer buffer(&array);
-  buffer.open(QIODevice::WriteOnly);
-  v.save(&buffer, "PNG");
-  emitter << array;
-  return emitter;
-}
+    do {
+      emitElement(emitter, it.value());
+      ++it;
+    } while (it != v.constEnd() && it.key() == key);
 
-inline Emitter& operator<<(Emitter& emitter, QColor& v)
-{
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "red";
-  emitter << YAML::Value << v.red();
-  emitter << YAML::Key << "green";
-  emitter << YAML::Value << v.green();
-  emitter << YAML::Key << "blue";
-  emitter << YAML::Value << v.blue();
-  emitter << YAML::Key << "alpha";
-  emitter << YAML::Value << v.alpha();
-  emitter << YAML::EndMap;
-  return emitter;
-}
+    emitter << YAML::EndSeq;
+  }
 
-inline Emitter& operator<<(Emitter& emitter, QFont& v)
-{
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "family";
-  emitter << YAML::Value << v.family().toStdString();
-  emitter << YAML::Key << "bold";
-  emitter << YAML::Value << v.bold();
-  emitter << YAML::Key << "capitalization";
-  emitter << YAML::Value << v.capitalization();
-  emitter << YAML::Key << "fixedpitch";
-  emitter << YAML::Value << v.fixedPitch();
-  emitter << YAML::Key << "hinting preference";
-  emitter << YAML::Value << v.hintingPreference();
-  emitter << YAML::Key << "italic";
-  emitter << YAML::Value << v.italic();
-  emitter << YAML::Key << "kerning";
-  emitter << YAML::Value << v.kerning();
-  emitter << YAML::Key << "letter spacing";
-  emitter << YAML::Value << v.letterSpacing();
-  emitter << YAML::Key << "letter spacing type";
-  emitter << YAML::Value << v.letterSpacingType();
-  emitter << YAML::Key << "overline";
-  emitter << YAML::Value << v.overline();
-  // not recommended to use pixelSize()
-  emitter << YAML::Key << "point size";
-  emitter << YAML::Value << v.pointSize();
-  emitter << YAML::Key << "stretch";
-  emitter << YAML::Value << v.stretch();
-  emitter << YAML::Key << "strikeout";
-  emitter << YAML::Value << v.strikeOut();
-  emitter << YAML::Key << "style";
-  emitter << YAML::Value << v.style();
-  emitter << YAML::Key << "style hint";
-  emitter << YAML::Value << v.styleHint();
-  emitter << YAML::Key << "style name";
-  emitter << YAML::Value << v.styleName().toStdString();
-  emitter << YAML::Key << "style strategy";
-  emitter << YAML::Value << v.styleStrategy();
-  emitter << YAML::Key << "underline";
-  emitter << YAML::Value << v.underline();
-  emitter << YAML::Key << "weight";
-  emitter << YAML::Value << v.weight();
-  emitter << YAML::Key << "word spacing";
-  emitter << YAML::Value << v.wordSpacing();
-  emitter << YAML::EndMap;
-  return emitter;
+  return emitter << YAML::EndMap;
 }
 
-inline Emitter& operator<<(Emitter& emitter, QPoint& v)
-{
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "x";
-  emitter << YAML::Value << v.x();
-  emitter << YAML::Key << "y";
-  emitter << YAML::Value << v.y();
-  emitter << YAML::EndMap;
-  return emitter;
-}
+} // end of namespace detail
+} // end of namespace QYaml
 
-inline Emitter& operator<<(Emitter& emitter, QPointF& v)
-{
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "x";
-  emitter << YAML::Value << v.x();
-  emitter << YAML::Key << "y";
-  emitter << YAML::Value << v.y();
-  emitter << YAML::EndMap;
-  return emitter;
-}
+namespace YAML {
 
-inline Emitter& operator<<(Emitter& emitter, QRect& v)
+/*
+   The hash and multi container overloads write straight to the emitter
+   instead of building a Node of the whole container first.
+*/
+template<class K, class V>
+inline Emitter& operator<<(Emitter& emitter, const QHash<K, V>& v)
 {
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "left";
-  emitter << YAML::Value << v.left();
-  emitter << YAML::Key << "top";
-  emitter << YAML::Value << v.top();
-  emitter << YAML::Key << "width";
-  emitter << YAML::Value << v.width();
-  emitter << YAML::Key << "height";
-  emitter << YAML::Value << v.height();
-  emitter << YAML::EndMap;
-  return emitter;
-}
+  QYAML_TYPED_PROBE("emit", QHash<K, V>);
 
-inline Emitter& operator<<(Emitter& emitter, QRectF& v)
-{
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "left";
-  emitter << YAML::Value << v.left();
-  emitter << YAML::Key << "top";
-  emitter << YAML::Value << v.top();
-  emitter << YAML::Key << "width";
-  emitter << YAML::Value << v.width();
-  emitter << YAML::Key << "height";
-  emitter << YAML::Value << v.height();
-  emitter << YAML::EndMap;
-  return emitter;
+  emitter << BeginMap;
+
+  for (typename QHash<K, V>::const_iterator it = v.constBegin(); it != v.constEnd();
+       ++it) {
+    emitter << Key;
+    QYaml::detail::emitElement(emitter, it.key());
+    emitter << Value;
+    QYaml::detail::emitElement(emitter, it.value());
+  }
+
+  return emitter << EndMap;
 }
 
-inline Emitter& operator<<(Emitter& emitter, QSize& v)
+template<class K, class V>
+inline Emitter& operator<<(Emitter& emitter, const QMultiHash<K, V>& v)
 {
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "width";
-  emitter << YAML::Value << v.width();
-  emitter << YAML::Key << "height";
-  emitter << YAML::Value << v.height();
-  emitter << YAML::EndMap;
-  return emitter;
-}
+  QYAML_TYPED_PROBE("emit", QMultiHash<K, V>);
 
+  return QYaml::detail::emitMulti(emitter, v);
+}
 
-inline Emitter& operator<<(Emitter& emitter, QSizeF& v)
+template<class K, class V>
+inline Emitter& operator<<(Emitter& emitter, const QMultiMap<K, V>& v)
 {
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << "width";
-  emitter << YAML::Value << v.width();
-  emitter << YAML::Key << "height";
-  emitter << YAML::Value << v.height();
-  emitter << YAML::EndMap;
-  return emitter;
+  QYAML_TYPED_PROBE("emit", QMultiMap<K, V>);
+
+  return QYaml::detail::emitMulti(emitter, v);
 }
 
 } // end namespace YAML
 
+#if !defined(QYAMLCPP_COMPILED_LIB)
+#include "emitter-inl.h"
+#endif
+
 #endif // EMITTER_H
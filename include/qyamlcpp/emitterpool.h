@@ -0,0 +1,309 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_EMITTERPOOL_H
+#define QYAML_EMITTERPOOL_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+namespace QYaml {
+
+/*!
+   \brief A YAML::Emitter that is kept and reused for many small messages.
+
+   A new YAML::Emitter allocates its state stack and output string every
+   time. ReusableEmitter keeps one emitter writing into one QByteArray and
+   starts each message as a new document of the same stream. The "---"
+   yaml-cpp writes between documents is dropped, so the buffer holds exactly
+   the message and its capacity is kept from one message to the next.
+
+   \code
+   QYaml::ReusableEmitter out;
+
+   for (const Sample& sample : samples) {
+      YAML::Emitter& emitter = out.begin();
+      emitter << YAML::BeginMap;
+      emitter << YAML::Key << "pos" << YAML::Value << sample.pos;
+      emitter << YAML::EndMap;
+      socket->write(out.data());
+   }
+   \endcode
+
+   Each message must be a single complete node. Emitter settings such as
+   SetIndent() carry over to later messages. Not thread safe, use an
+   EmitterPool to share emitters between threads.
+*/
+class ReusableEmitter
+{
+public:
+  explicit ReusableEmitter(int capacity = 4096)
+    : m_stream(&m_buffer)
+    , m_capacity(capacity) {
+    m_buffer.reset(capacity, false);
+  }
+
+  ReusableEmitter(const ReusableEmitter&) = delete;
+  ReusableEmitter& operator=(const ReusableEmitter&) = delete;
+
+  /*!
+     \brief Starts a new message and returns the emitter to write it with.
+  */
+  YAML::Emitter& begin() {
+    if (!m_emitter || !m_emitter->good()) {
+      m_emitter.reset();
+      m_stream.clear();
+      m_buffer.reset(m_capacity, false);
+      m_emitter.reset(new YAML::Emitter(m_stream));
+    } else {
+      m_buffer.reset(m_capacity, m_emitter->size() > 0);
+    }
+
+    return *m_emitter;
+  }
+
+  /*!
+     \brief The message written since begin(). Valid until the next
+     begin().
+  */
+  const QByteArray& data() {
+    m_buffer.flush();
+    return m_buffer.data();
+  }
+
+  /*!
+     \brief The message written since begin(), sharing the buffer rather
+     than copying it. The buffer is only reused if the result has been
+     released by the next begin().
+  */
+  QByteArray finish() { return data(); }
+
+  bool good() const { return m_emitter && m_emitter->good(); }
+
+  QString lastError() const {
+    return m_emitter ? QString::fromStdString(m_emitter->GetLastError()) : QString();
+  }
+
+  /*!
+     \brief Writes value as a complete message.
+  */
+  template<class T>
+  QByteArray serialize(T&& value) {
+    begin() << value;
+    return finish();
+  }
+
+private:
+  class Buffer : public std::streambuf
+  {
+  public:
+    Buffer()
+      : m_start(0)
+      , m_held(0)
+      , m_skipping(false) {}
+
+    // drops the "\n---\n" (or "---\n") that starts every document after
+    // the first, if it is there.
+    void reset(int capacity, bool skipSeparator) {
+      m_data.resize(0);
+
+      if (m_data.capacity() < capacity) {
+        m_data.reserve(capacity);
+      }
+
+      m_start = 0;
+      m_held = 0;
+      m_skipping = skipSeparator;
+    }
+
+    void flush() {
+      if (m_skipping && m_held > m_start) {
+        m_data.append(separator() + m_start, m_held - m_start);
+      }
+
+      m_skipping = false;
+      m_held = 0;
+    }
+
+    const QByteArray& data() const { return m_data; }
+
+  protected:
+    int_type overflow(int_type c) override {
+      if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        const char ch = traits_type::to_char_type(c);
+        put(&ch, 1);
+      }
+
+      return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize count) override {
+      put(s, count);
+      return count;
+    }
+
+  private:
+    static const char* separator() { return "\n---\n"; }
+
+    void put(const char* s, std::streamsize count) {
+      while (m_skipping && count > 0) {
+        if (*s == separator()[m_held]) {
+          ++s;
+          --count;
+
+          if (++m_held == 5) {
+            m_skipping = false;
+            m_held = 0;
+          }
+
+        } else if (m_held == 0 && *s == '-') {
+          m_start = m_held = 1; // no leading line break, match the rest.
+
+        } else {
+          flush();
+        }
+      }
+
+      if (count > 0) {
+        m_data.append(s, int(count));
+      }
+    }
+
+    QByteArray m_data;
+    int m_start;
+    int m_held;
+    bool m_skipping;
+  };
+
+  Buffer m_buffer;
+  std::ostream m_stream;
+  std::unique_ptr<YAML::Emitter> m_emitter;
+  int m_capacity;
+};
+
+/*!
+   \brief A thread safe pool of ReusableEmitters.
+
+   \code
+   QByteArray message;
+   {
+      QYaml::EmitterPool::Lease out = QYaml::EmitterPool::global().acquire();
+      out->begin() << payload;
+      message = out->finish();
+   }
+   \endcode
+
+   An emitter goes back to the pool when its Lease is destroyed.
+*/
+class EmitterPool
+{
+public:
+  class Lease
+  {
+  public:
+    Lease(Lease&& other)
+      : m_pool(other.m_pool)
+      , m_emitter(other.m_emitter) {
+      other.m_emitter = nullptr;
+    }
+
+    ~Lease() {
+      if (m_emitter) {
+        m_pool->release(m_emitter);
+      }
+    }
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    ReusableEmitter& operator*() const { return *m_emitter; }
+    ReusableEmitter* operator->() const { return m_emitter; }
+
+  private:
+    friend class EmitterPool;
+
+    Lease(EmitterPool* pool, ReusableEmitter* emitter)
+      : m_pool(pool)
+      , m_emitter(emitter) {}
+
+    EmitterPool* m_pool;
+    ReusableEmitter* m_emitter;
+  };
+
+  explicit EmitterPool(int capacity = 4096)
+    : m_capacity(capacity) {}
+
+  ~EmitterPool() {
+    for (ReusableEmitter* emitter : m_free) {
+      delete emitter;
+    }
+  }
+
+  EmitterPool(const EmitterPool&) = delete;
+  EmitterPool& operator=(const EmitterPool&) = delete;
+
+  /*!
+     \brief A pool shared by the whole process. It is never destroyed.
+  */
+  static EmitterPool& global() {
+    static EmitterPool* pool = new EmitterPool;
+    return *pool;
+  }
+
+  Lease acquire() {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_free.empty()) {
+      locker.unlock();
+      return Lease(this, new ReusableEmitter(m_capacity));
+    }
+
+    ReusableEmitter* emitter = m_free.back();
+    m_free.pop_back();
+    return Lease(this, emitter);
+  }
+
+private:
+  void release(ReusableEmitter* emitter) {
+    QMutexLocker locker(&m_mutex);
+    m_free.push_back(emitter);
+  }
+
+  QMutex m_mutex;
+  std::vector<ReusableEmitter*> m_free;
+  int m_capacity;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_EMITTERPOOL_H
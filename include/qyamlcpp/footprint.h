@@ -0,0 +1,624 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_FOOTPRINT_H
+#define QYAML_FOOTPRINT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMetaType>
+#include <QMultiHash>
+#include <QMultiMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+namespace QYaml {
+
+/*!
+   \brief Estimated heap bytes of a YAML::Node subtree or a decoded Qt value.
+
+   nodeBytes covers the node objects, their allocation bookkeeping and the
+   child tables of maps and sequences, or the container structures of Qt
+   values. stringBytes is the heap held by scalar and tag text, or by
+   QStrings, and binaryBytes the text of !!binary scalars, or QByteArrays.
+   Text short enough for the small string buffer lives inside the node and
+   counts as node bytes.
+
+   The figures are estimates from the type sizes and container lengths, not
+   measured allocations. Implicitly shared Qt data and aliased YAML nodes
+   are counted at every use.
+*/
+struct Footprint
+{
+  Footprint()
+    : nodes(0)
+    , nodeBytes(0)
+    , stringBytes(0)
+    , binaryBytes(0) {}
+
+  quint64 nodes;
+  quint64 nodeBytes;
+  quint64 stringBytes;
+  quint64 binaryBytes;
+
+  quint64 total() const { return nodeBytes + stringBytes + binaryBytes; }
+
+  Footprint& operator+=(const Footprint& other) {
+    nodes += other.nodes;
+    nodeBytes += other.nodeBytes;
+    stringBytes += other.stringBytes;
+    binaryBytes += other.binaryBytes;
+    return *this;
+  }
+
+  QVariantMap toVariantMap() const {
+    QVariantMap map;
+    map.insert(QStringLiteral("nodes"), nodes);
+    map.insert(QStringLiteral("node bytes"), nodeBytes);
+    map.insert(QStringLiteral("string bytes"), stringBytes);
+    map.insert(QStringLiteral("binary bytes"), binaryBytes);
+    map.insert(QStringLiteral("total"), total());
+    return map;
+  }
+};
+
+namespace detail {
+
+enum
+{
+  // malloc's own header and rounding, per allocation.
+  AllocationOverhead = 2 * sizeof(void*),
+  // an atomic reference count and size fields, roughly the size of the
+  // shared headers of QList, QMap and QHash.
+  SharedHeader = 3 * sizeof(void*),
+  // the reference counts and vtable of a shared_ptr that owns a raw new.
+  ControlBlock = 3 * sizeof(void*),
+  // a red black tree node's colour and three links.
+  TreeNode = 4 * sizeof(void*)
+};
+
+/*
+   yaml-cpp allocates each node, its node_ref and its node_data separately,
+   each owned by a shared_ptr, and the memory holder keeps every node in a
+   std::set of shared_ptrs.
+*/
+inline quint64 yamlNodeBytes()
+{
+  return sizeof(YAML::detail::node) + sizeof(YAML::detail::node_ref) +
+         sizeof(YAML::detail::node_data) + 3 * (ControlBlock + 2 * AllocationOverhead) +
+         TreeNode + sizeof(std::shared_ptr<YAML::detail::node>) + AllocationOverhead;
+}
+
+// heap used by a std::string, none while it fits in the small string buffer.
+inline quint64 stringHeapBytes(const std::string& text)
+{
+  static const std::string::size_type inlineCapacity = std::string().capacity();
+
+  if (text.capacity() <= inlineCapacity) {
+    return 0;
+  }
+
+  return text.capacity() + 1 + AllocationOverhead;
+}
+
+// the child table of a sequence or map node, without the children.
+inline quint64 yamlSequenceBytes(const YAML::Node& node)
+{
+  return node.size() * sizeof(void*) + AllocationOverhead;
+}
+
+inline quint64 yamlMapBytes(const YAML::Node& node)
+{
+  return node.size() * 2 * sizeof(void*) + AllocationOverhead;
+}
+
+/*
+   The blocks a QList or QMap of size items allocates for itself, without
+   the heap data of the items. Shared by footprint() and FootprintReport so
+   the two agree.
+*/
+template<class T>
+inline Footprint listOverhead(int size)
+{
+  Footprint result;
+  result.nodes = quint64(size);
+  result.nodeBytes = SharedHeader + quint64(size) * sizeof(void*) + AllocationOverhead;
+
+  // QList stores large and non movable types behind a pointer.
+  if (QTypeInfo<T>::isLarge || QTypeInfo<T>::isStatic) {
+    result.nodeBytes += quint64(size) * (sizeof(T) + AllocationOverhead);
+  }
+
+  return result;
+}
+
+template<class K, class V>
+inline Footprint mapOverhead(int size)
+{
+  Footprint result;
+  result.nodes = quint64(size);
+  result.nodeBytes =
+    SharedHeader + AllocationOverhead +
+    quint64(size) * (3 * sizeof(void*) + sizeof(K) + sizeof(V) + AllocationOverhead);
+  return result;
+}
+
+inline bool isBinaryTag(const std::string& tag)
+{
+  return tag == "tag:yaml.org,2002:binary" || tag == "!!binary";
+}
+
+} // end of namespace detail
+
+/*!
+   \brief The footprint of a single YAML::Node and everything below it.
+*/
+inline Footprint footprint(const YAML::Node& node)
+{
+  Footprint result;
+
+  if (!node.IsDefined()) {
+    return result;
+  }
+
+  result.nodes = 1;
+  result.nodeBytes = detail::yamlNodeBytes();
+  result.stringBytes = detail::stringHeapBytes(node.Tag());
+
+  switch (node.Type()) {
+  case YAML::NodeType::Scalar:
+    if (detail::isBinaryTag(node.Tag())) {
+      result.binaryBytes += detail::stringHeapBytes(node.Scalar());
+    } else {
+      result.stringBytes += detail::stringHeapBytes(node.Scalar());
+    }
+    break;
+
+  case YAML::NodeType::Sequence:
+    result.nodeBytes += detail::yamlSequenceBytes(node);
+
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      result += footprint(*it);
+    }
+    break;
+
+  case YAML::NodeType::Map:
+    result.nodeBytes += detail::yamlMapBytes(node);
+
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      result += footprint(it->first);
+      result += footprint(it->second);
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  return result;
+}
+
+/* = Decoded Qt values
+   ======================================================================================*/
+inline Footprint footprint(const QString& value);
+inline Footprint footprint(const QByteArray& value);
+inline Footprint footprint(const QVariant& value);
+inline Footprint footprint(const QStringList& value);
+
+template<class T>
+Footprint footprint(const QList<T>& value);
+template<class T>
+Footprint footprint(const QVector<T>& value);
+template<class T>
+Footprint footprint(const QSet<T>& value);
+template<class K, class V>
+Footprint footprint(const QMap<K, V>& value);
+template<class K, class V>
+Footprint footprint(const QMultiMap<K, V>& value);
+template<class K, class V>
+Footprint footprint(const QHash<K, V>& value);
+template<class K, class V>
+Footprint footprint(const QMultiHash<K, V>& value);
+
+/*!
+   \brief Values with no heap data of their own, such as numbers and
+   QPointF, and types not listed here, count as nothing.
+*/
+template<class T>
+inline Footprint footprint(const T&)
+{
+  return Footprint();
+}
+
+inline Footprint footprint(const QString& value)
+{
+  Footprint result;
+
+  // literals and the shared empty string have no allocation.
+  if (value.capacity() > 0) {
+    result.stringBytes = sizeof(QArrayData) + (quint64(value.capacity()) + 1) * sizeof(QChar) +
+                         detail::AllocationOverhead;
+  }
+
+  return result;
+}
+
+inline Footprint footprint(const QByteArray& value)
+{
+  Footprint result;
+
+  if (value.capacity() > 0) {
+    result.binaryBytes =
+      sizeof(QArrayData) + quint64(value.capacity()) + 1 + detail::AllocationOverhead;
+  }
+
+  return result;
+}
+
+inline Footprint footprint(const QVariant& value)
+{
+  switch (value.userType()) {
+  case QMetaType::UnknownType:
+    return Footprint();
+
+  case QMetaType::QString:
+    return footprint(value.toString());
+
+  case QMetaType::QByteArray:
+    return footprint(value.toByteArray());
+
+  case QMetaType::QStringList:
+    return footprint(value.toStringList());
+
+  case QMetaType::QVariantList:
+    return footprint(value.toList());
+
+  case QMetaType::QVariantMap:
+    return footprint(value.toMap());
+
+  case QMetaType::QVariantHash:
+    return footprint(value.toHash());
+
+  default: {
+    // values bigger than the inline storage are held in a shared block.
+    Footprint result;
+    const int size = QMetaType::sizeOf(value.userType());
+
+    if (size > int(sizeof(double))) {
+      result.nodeBytes = quint64(size) + 2 * sizeof(void*) + detail::AllocationOverhead;
+    }
+
+    return result;
+  }
+  }
+}
+
+inline Footprint footprint(const QStringList& value)
+{
+  return footprint(static_cast<const QList<QString>&>(value));
+}
+
+template<class T>
+inline Footprint footprint(const QList<T>& value)
+{
+  Footprint result = detail::listOverhead<T>(value.size());
+
+  for (const T& item : value) {
+    result += footprint(item);
+  }
+
+  return result;
+}
+
+template<class T>
+inline Footprint footprint(const QVector<T>& value)
+{
+  Footprint result;
+  result.nodes = quint64(value.size());
+  result.nodeBytes = sizeof(QArrayData) + quint64(value.capacity()) * sizeof(T) +
+                     detail::AllocationOverhead;
+
+  for (const T& item : value) {
+    result += footprint(item);
+  }
+
+  return result;
+}
+
+template<class T>
+inline Footprint footprint(const QSet<T>& value)
+{
+  Footprint result;
+  result.nodes = quint64(value.size());
+  result.nodeBytes = detail::SharedHeader + quint64(value.capacity()) * sizeof(void*) +
+                     quint64(value.size()) *
+                       (2 * sizeof(void*) + sizeof(T) + detail::AllocationOverhead);
+
+  for (const T& item : value) {
+    result += footprint(item);
+  }
+
+  return result;
+}
+
+template<class K, class V>
+inline Footprint footprint(const QMap<K, V>& value)
+{
+  Footprint result = detail::mapOverhead<K, V>(value.size());
+
+  for (typename QMap<K, V>::const_iterator it = value.constBegin();
+       it != value.constEnd(); ++it) {
+    result += footprint(it.key());
+    result += footprint(it.value());
+  }
+
+  return result;
+}
+
+template<class K, class V>
+inline Footprint footprint(const QMultiMap<K, V>& value)
+{
+  return footprint(static_cast<const QMap<K, V>&>(value));
+}
+
+template<class K, class V>
+inline Footprint footprint(const QHash<K, V>& value)
+{
+  Footprint result;
+  result.nodes = quint64(value.size());
+  result.nodeBytes = detail::SharedHeader + quint64(value.capacity()) * sizeof(void*) +
+                     detail::AllocationOverhead +
+                     quint64(value.size()) * (2 * sizeof(void*) + sizeof(K) + sizeof(V) +
+                                              detail::AllocationOverhead);
+
+  for (typename QHash<K, V>::const_iterator it = value.constBegin();
+       it != value.constEnd(); ++it) {
+    result += footprint(it.key());
+    result += footprint(it.value());
+  }
+
+  return result;
+}
+
+template<class K, class V>
+inline Footprint footprint(const QMultiHash<K, V>& value)
+{
+  return footprint(static_cast<const QHash<K, V>&>(value));
+}
+
+/*!
+   \brief The footprint of one subtree, at a path QYaml::Path can resolve.
+*/
+struct SubtreeFootprint
+{
+  QString path;
+  int depth;
+  Footprint footprint;
+};
+
+/*!
+   \brief A breakdown of where the memory of a loaded document, or of a
+   decoded QVariant tree, goes.
+
+   Every map value and sequence item down to depth levels gets an entry with
+   the total for its whole subtree, so the entries overlap. Deeper levels
+   are still counted in their parents.
+
+   \code
+   YAML::Node config = YAML::LoadFile("scene.yaml");
+   QYaml::FootprintReport report = QYaml::FootprintReport::measure(config);
+
+   for (const QYaml::SubtreeFootprint& subtree : report.top(10)) {
+      qDebug() << subtree.path << subtree.footprint.total();
+   }
+   \endcode
+
+   An entry's path is its keys joined with '/', with sequence items given by
+   index, so it can be passed to QYaml::Path. Keys that are not scalars show
+   as "?".
+*/
+class FootprintReport
+{
+public:
+  static FootprintReport measure(const YAML::Node& root, int depth = 3) {
+    FootprintReport report;
+    report.m_depth = depth;
+    report.m_total = report.walk(root, QString(), 0);
+    return report;
+  }
+
+  static FootprintReport measure(const QVariant& root, int depth = 3) {
+    FootprintReport report;
+    report.m_depth = depth;
+    report.m_total = report.walk(root, QString(), 0);
+    return report;
+  }
+
+  const Footprint& total() const { return m_total; }
+
+  /*!
+     \brief Every recorded subtree, in document order.
+  */
+  const QVector<SubtreeFootprint>& subtrees() const { return m_subtrees; }
+
+  /*!
+     \brief The count largest subtrees by total bytes, largest first.
+  */
+  QVector<SubtreeFootprint> top(int count) const {
+    QVector<SubtreeFootprint> sorted = m_subtrees;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const SubtreeFootprint& lhs, const SubtreeFootprint& rhs) {
+                       return lhs.footprint.total() > rhs.footprint.total();
+                     });
+
+    if (count >= 0 && count < sorted.size()) {
+      sorted.resize(count);
+    }
+
+    return sorted;
+  }
+
+  /*!
+     \brief The total and the count largest subtrees as
+     { total: {...}, subtrees: [{ path, depth, nodes, ... }, ...] }, with
+     the subtrees largest first.
+  */
+  QVariantMap toVariantMap(int count = 20) const {
+    QVariantList subtrees;
+
+    for (const SubtreeFootprint& subtree : top(count)) {
+      QVariantMap entry = subtree.footprint.toVariantMap();
+      entry.insert(QStringLiteral("path"), subtree.path);
+      entry.insert(QStringLiteral("depth"), subtree.depth);
+      subtrees.append(entry);
+    }
+
+    QVariantMap map;
+    map.insert(QStringLiteral("total"), m_total.toVariantMap());
+    map.insert(QStringLiteral("subtrees"), subtrees);
+    return map;
+  }
+
+private:
+  FootprintReport()
+    : m_depth(0) {}
+
+  static QString childPath(const QString& path, const QString& key) {
+    return path.isEmpty() ? key : path + QLatin1Char('/') + key;
+  }
+
+  // reserves the entry before the children are walked, so entries stay in
+  // document order.
+  int record(const QString& path, int level) {
+    if (level == 0 || level > m_depth) {
+      return -1;
+    }
+
+    SubtreeFootprint subtree;
+    subtree.path = path;
+    subtree.depth = level;
+    m_subtrees.append(subtree);
+    return m_subtrees.size() - 1;
+  }
+
+  Footprint walk(const YAML::Node& node, const QString& path, int level) {
+    const int index = record(path, level);
+
+    // below the last recorded level only the totals are needed.
+    if (level >= m_depth) {
+      const Footprint result = footprint(node);
+
+      if (index >= 0) {
+        m_subtrees[index].footprint = result;
+      }
+
+      return result;
+    }
+
+    Footprint result;
+    result.nodes = 1;
+    result.nodeBytes = detail::yamlNodeBytes();
+    result.stringBytes = detail::stringHeapBytes(node.Tag());
+
+    if (node.IsSequence()) {
+      result.nodeBytes += detail::yamlSequenceBytes(node);
+      int i = 0;
+
+      for (YAML::const_iterator it = node.begin(); it != node.end(); ++it, ++i) {
+        result += walk(*it, childPath(path, QString::number(i)), level + 1);
+      }
+
+    } else if (node.IsMap()) {
+      result.nodeBytes += detail::yamlMapBytes(node);
+
+      for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+        const QString key = it->first.IsScalar()
+                              ? QString::fromStdString(it->first.Scalar())
+                              : QStringLiteral("?");
+        result += footprint(it->first);
+        result += walk(it->second, childPath(path, key), level + 1);
+      }
+
+    } else {
+      result = footprint(node);
+    }
+
+    if (index >= 0) {
+      m_subtrees[index].footprint = result;
+    }
+
+    return result;
+  }
+
+  Footprint walk(const QVariant& value, const QString& path, int level) {
+    const int index = record(path, level);
+    Footprint result;
+
+    if (level < m_depth && value.userType() == QMetaType::QVariantList) {
+      const QVariantList list = value.toList();
+      result = detail::listOverhead<QVariant>(list.size());
+
+      for (int i = 0; i < list.size(); ++i) {
+        result += walk(list.at(i), childPath(path, QString::number(i)), level + 1);
+      }
+
+    } else if (level < m_depth && value.userType() == QMetaType::QVariantMap) {
+      const QVariantMap map = value.toMap();
+      result = detail::mapOverhead<QString, QVariant>(map.size());
+
+      for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+        result += footprint(it.key());
+        result += walk(it.value(), childPath(path, it.key()), level + 1);
+      }
+
+    } else {
+      result = footprint(value);
+    }
+
+    if (index >= 0) {
+      m_subtrees[index].footprint = result;
+    }
+
+    return result;
+  }
+
+  int m_depth;
+  Footprint m_total;
+  QVector<SubtreeFootprint> m_subtrees;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_FOOTPRINT_H
@@ -0,0 +1,198 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_HASH_H
+#define QYAML_HASH_H
+
+#include <QByteArray>
+#include <QtEndian>
+#include <QtGlobal>
+
+#include <cstddef>
+#include <cstring>
+
+namespace QYaml {
+
+/*!
+   \brief A streaming implementation of the 64 bit xxHash (XXH64).
+
+   Much faster than the QCryptographicHash algorithms and good enough to tell
+   whether some output has changed, although it is not a cryptographic hash.
+   Data can be added in pieces of any size and the result is the same as
+   hashing it all at once.
+
+   \code
+   QYaml::XXHash64 hash;
+   hash.addData(header);
+   hash.addData(body);
+   quint64 value = hash.result();
+   \endcode
+*/
+class XXHash64
+{
+public:
+  explicit XXHash64(quint64 seed = 0) { reset(seed); }
+
+  void reset(quint64 seed = 0) {
+    m_seed = seed;
+    m_v1 = seed + Prime1 + Prime2;
+    m_v2 = seed + Prime2;
+    m_v3 = seed;
+    m_v4 = seed - Prime1;
+    m_length = 0;
+    m_bufferSize = 0;
+  }
+
+  void addData(const char* data, std::size_t size) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + size;
+    m_length += size;
+
+    if (m_bufferSize + size < BlockSize) {
+      if (size) {
+        std::memcpy(m_buffer + m_bufferSize, p, size);
+      }
+
+      m_bufferSize += size;
+      return;
+    }
+
+    if (m_bufferSize) {
+      const std::size_t fill = BlockSize - m_bufferSize;
+      std::memcpy(m_buffer + m_bufferSize, p, fill);
+      p += fill;
+      processBlock(m_buffer);
+      m_bufferSize = 0;
+    }
+
+    while (p + BlockSize <= end) {
+      processBlock(p);
+      p += BlockSize;
+    }
+
+    m_bufferSize = std::size_t(end - p);
+
+    if (m_bufferSize) {
+      std::memcpy(m_buffer, p, m_bufferSize);
+    }
+  }
+
+  void addData(const QByteArray& data) {
+    addData(data.constData(), std::size_t(data.size()));
+  }
+
+  quint64 result() const {
+    quint64 hash;
+
+    if (m_length >= BlockSize) {
+      hash = rotl(m_v1, 1) + rotl(m_v2, 7) + rotl(m_v3, 12) + rotl(m_v4, 18);
+      hash = mergeRound(hash, m_v1);
+      hash = mergeRound(hash, m_v2);
+      hash = mergeRound(hash, m_v3);
+      hash = mergeRound(hash, m_v4);
+    } else {
+      hash = m_seed + Prime5;
+    }
+
+    hash += m_length;
+
+    const unsigned char* p = m_buffer;
+    const unsigned char* const end = m_buffer + m_bufferSize;
+
+    while (p + 8 <= end) {
+      hash ^= round(0, qFromLittleEndian<quint64>(p));
+      hash = rotl(hash, 27) * Prime1 + Prime4;
+      p += 8;
+    }
+
+    if (p + 4 <= end) {
+      hash ^= quint64(qFromLittleEndian<quint32>(p)) * Prime1;
+      hash = rotl(hash, 23) * Prime2 + Prime3;
+      p += 4;
+    }
+
+    while (p < end) {
+      hash ^= quint64(*p) * Prime5;
+      hash = rotl(hash, 11) * Prime1;
+      ++p;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+  }
+
+  static quint64 hash(const char* data, std::size_t size, quint64 seed = 0) {
+    XXHash64 hasher(seed);
+    hasher.addData(data, size);
+    return hasher.result();
+  }
+
+  static quint64 hash(const QByteArray& data, quint64 seed = 0) {
+    return hash(data.constData(), std::size_t(data.size()), seed);
+  }
+
+private:
+  static const quint64 Prime1 = 0x9E3779B185EBCA87ULL;
+  static const quint64 Prime2 = 0xC2B2AE3D27D4EB4FULL;
+  static const quint64 Prime3 = 0x165667B19E3779F9ULL;
+  static const quint64 Prime4 = 0x85EBCA77C2B2AE63ULL;
+  static const quint64 Prime5 = 0x27D4EB2F165667C5ULL;
+  static const std::size_t BlockSize = 32;
+
+  static quint64 rotl(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+  }
+
+  static quint64 round(quint64 accumulator, quint64 input) {
+    accumulator += input * Prime2;
+    accumulator = rotl(accumulator, 31);
+    return accumulator * Prime1;
+  }
+
+  static quint64 mergeRound(quint64 accumulator, quint64 value) {
+    accumulator ^= round(0, value);
+    return accumulator * Prime1 + Prime4;
+  }
+
+  void processBlock(const unsigned char* block) {
+    m_v1 = round(m_v1, qFromLittleEndian<quint64>(block));
+    m_v2 = round(m_v2, qFromLittleEndian<quint64>(block + 8));
+    m_v3 = round(m_v3, qFromLittleEndian<quint64>(block + 16));
+    m_v4 = round(m_v4, qFromLittleEndian<quint64>(block + 24));
+  }
+
+  quint64 m_seed;
+  quint64 m_v1, m_v2, m_v3, m_v4;
+  quint64 m_length;
+  unsigned char m_buffer[BlockSize];
+  std::size_t m_bufferSize;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_HASH_H
@@ -0,0 +1,157 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_INDEXEDMAP_H
+#define QYAML_INDEXEDMAP_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <yaml-cpp/yaml.h>
+
+#include "node.h"
+
+namespace QYaml {
+
+/*!
+   \brief A hashed key index over a YAML map node.
+
+   YAML::Node::operator[] on a map is a linear scan that decodes and compares
+   every key in turn. IndexedMap walks the map once and keeps a
+   QHash<QString, YAML::Node>, so later lookups are O(1). The stored values
+   are ordinary Node handles sharing the original document, so converting
+   them goes through the usual YAML::convert<T> specialisations.
+
+   The index is a snapshot. If keys are added to or removed from the map
+   afterwards call rebuild(). Keys that are not scalars are not indexed.
+
+   \code
+   YAML::Node m_preferences = YAML::LoadFile(file);
+   QYaml::IndexedMap prefs(m_preferences);
+   QString username = prefs.value<QString>(QStringLiteral("username"));
+   QRect rect = prefs.value<QRect>(QStringLiteral("position"), QRect());
+   \endcode
+
+   Building QString keys from string literals on every call allocates, so
+   use QStringLiteral or keep the key strings around.
+*/
+class IndexedMap
+{
+public:
+  IndexedMap() = default;
+
+  explicit IndexedMap(const YAML::Node& node) { rebuild(node); }
+
+  /*!
+     \brief Re-indexes node, which should be a map.
+
+     Returns false, leaving the index empty, if node is not a map.
+  */
+  bool rebuild(const YAML::Node& node) {
+    m_node = node;
+    m_index.clear();
+
+    if (!node.IsMap()) {
+      return false;
+    }
+
+    m_index.reserve(int(node.size()));
+
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      if (!it->first.IsScalar()) {
+        continue;
+      }
+
+      const QString key = QString::fromStdString(it->first.Scalar());
+
+      // yaml-cpp returns the first of any duplicated keys, so do the same.
+      if (!m_index.contains(key)) {
+        m_index.insert(key, it->second);
+      }
+    }
+
+    return true;
+  }
+
+  const YAML::Node& node() const { return m_node; }
+
+  int size() const { return m_index.size(); }
+  bool isEmpty() const { return m_index.isEmpty(); }
+  QStringList keys() const { return m_index.keys(); }
+
+  bool contains(const QString& key) const { return m_index.contains(key); }
+
+  /*!
+     \brief Returns the value node for key, or an undefined node if there is
+     no such key.
+  */
+  YAML::Node value(const QString& key) const {
+    Index::const_iterator it = m_index.constFind(key);
+
+    if (it == m_index.constEnd()) {
+      return YAML::Node(YAML::NodeType::Undefined);
+    }
+
+    return it.value();
+  }
+
+  YAML::Node operator[](const QString& key) const { return value(key); }
+
+  /*!
+     \brief Converts the value for key to T using the existing converters.
+
+     @throws {@link TypedBadConversion} if there is no such key or the value
+     cannot be converted.
+  */
+  template<class T>
+  T value(const QString& key) const {
+    return value(key).as<T>();
+  }
+
+  /*!
+     \brief Converts the value for key to T, returning defaultValue if there
+     is no such key or the value cannot be converted.
+  */
+  template<class T>
+  T value(const QString& key, const T& defaultValue) const {
+    Index::const_iterator it = m_index.constFind(key);
+
+    if (it == m_index.constEnd()) {
+      return defaultValue;
+    }
+
+    return it.value().as<T>(defaultValue);
+  }
+
+private:
+  typedef QHash<QString, YAML::Node> Index;
+
+  YAML::Node m_node;
+  Index m_index;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_INDEXEDMAP_H
@@ -0,0 +1,444 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_INSTRUMENT_H
+#define QYAML_INSTRUMENT_H
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+#if defined(QYAMLCPP_INSTRUMENTATION)
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#endif
+
+/*!
+   \brief Optional timing of the converters, Load functions and Emitter
+   overloads.
+
+   Define QYAMLCPP_INSTRUMENTATION before including any qyamlcpp header, or
+   build with -DQYAMLCPP_INSTRUMENTATION, to turn it on. Otherwise the
+   QYAML_PROBE macros expand to nothing and snapshot() is always empty.
+
+   Each probe records its call count, cumulative time in nanoseconds and,
+   where it makes sense, the number of bytes handled. Probes in templates are
+   named after the instantiated type, so QList<int>::decode and
+   QList<QString>::decode are counted apart. Times are inclusive, so the time
+   for QList<QColor>::decode also appears under QColor::decode.
+   Counters are kept per thread and only written by their own thread, so
+   recording takes no locks.
+
+   \code
+   QVariantMap stats = QYaml::Instrumentation::toVariantMap();
+   QByteArray json = QYaml::Instrumentation::toJson();
+
+   for (const QYaml::Instrumentation::ProbeStats& probe :
+        QYaml::Instrumentation::snapshot()) {
+      exporter.counter(probe.name, probe.calls, probe.nanoseconds);
+   }
+   \endcode
+*/
+namespace QYaml {
+namespace Instrumentation {
+
+struct ProbeStats
+{
+  QString name;
+  quint64 calls;
+  quint64 nanoseconds;
+  quint64 bytes;
+};
+
+#if defined(QYAMLCPP_INSTRUMENTATION)
+
+namespace detail {
+
+enum
+{
+  MaximumProbes = 512
+};
+
+struct Counters
+{
+  Counters() {
+    for (int i = 0; i < MaximumProbes; ++i) {
+      calls[i].store(0, std::memory_order_relaxed);
+      nanoseconds[i].store(0, std::memory_order_relaxed);
+      bytes[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<quint64> calls[MaximumProbes];
+  std::atomic<quint64> nanoseconds[MaximumProbes];
+  std::atomic<quint64> bytes[MaximumProbes];
+};
+
+// Only the owning thread writes to its Counters, so a relaxed load and
+// store is enough and avoids a locked read-modify-write.
+inline void add(std::atomic<quint64>& counter, quint64 value)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+/*
+   Probe names and the Counters of every live thread. Counters of threads
+   that have finished are folded into retired. The registry is never
+   destroyed, as thread local destructors may still run after static ones.
+*/
+class Registry
+{
+public:
+  static Registry& instance() {
+    static Registry* registry = new Registry;
+    return *registry;
+  }
+
+  int registerProbe(const QByteArray& name) {
+    QMutexLocker locker(&m_mutex);
+    const int count = m_probeCount.load(std::memory_order_relaxed);
+
+    // overloads that share a name, such as the QString& and const QString&
+    // emitters, are counted together.
+    for (int i = 0; i < count; ++i) {
+      if (m_names[i] == name) {
+        return i;
+      }
+    }
+
+    if (count == MaximumProbes) {
+      return -1;
+    }
+
+    m_names[count] = name;
+    m_probeCount.store(count + 1, std::memory_order_release);
+    return count;
+  }
+
+  Counters* attach() {
+    Counters* counters = new Counters;
+    QMutexLocker locker(&m_mutex);
+    m_threads.push_back(counters);
+    return counters;
+  }
+
+  void retire(Counters* counters) {
+    QMutexLocker locker(&m_mutex);
+
+    for (int i = 0; i < MaximumProbes; ++i) {
+      m_retired.calls[i].fetch_add(counters->calls[i].load(std::memory_order_relaxed));
+      m_retired.nanoseconds[i].fetch_add(
+        counters->nanoseconds[i].load(std::memory_order_relaxed));
+      m_retired.bytes[i].fetch_add(counters->bytes[i].load(std::memory_order_relaxed));
+    }
+
+    m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), counters),
+                    m_threads.end());
+    delete counters;
+  }
+
+  QVector<ProbeStats> totals() {
+    QMutexLocker locker(&m_mutex);
+    const int count = m_probeCount.load(std::memory_order_acquire);
+    QVector<ProbeStats> stats(count);
+
+    for (int i = 0; i < count; ++i) {
+      ProbeStats& probe = stats[i];
+      probe.name = QString::fromLatin1(m_names[i]);
+      probe.calls = m_retired.calls[i].load(std::memory_order_relaxed);
+      probe.nanoseconds = m_retired.nanoseconds[i].load(std::memory_order_relaxed);
+      probe.bytes = m_retired.bytes[i].load(std::memory_order_relaxed);
+
+      for (const Counters* counters : m_threads) {
+        probe.calls += counters->calls[i].load(std::memory_order_relaxed);
+        probe.nanoseconds += counters->nanoseconds[i].load(std::memory_order_relaxed);
+        probe.bytes += counters->bytes[i].load(std::memory_order_relaxed);
+      }
+    }
+
+    return stats;
+  }
+
+  // Counters belong to their threads, so reset() records a baseline to
+  // subtract rather than clearing them.
+  QVector<ProbeStats>& baseline() { return m_baseline; }
+  QMutex& baselineMutex() { return m_baselineMutex; }
+
+private:
+  Registry()
+    : m_probeCount(0) {}
+
+  QMutex m_mutex;
+  std::atomic<int> m_probeCount;
+  QByteArray m_names[MaximumProbes];
+  std::vector<Counters*> m_threads;
+  Counters m_retired;
+  QMutex m_baselineMutex;
+  QVector<ProbeStats> m_baseline;
+};
+
+struct ThreadSlot
+{
+  ThreadSlot()
+    : counters(nullptr) {}
+
+  ~ThreadSlot() {
+    if (counters) {
+      Registry::instance().retire(counters);
+    }
+  }
+
+  Counters* counters;
+};
+
+/*
+   The name of T as spelled in Q_FUNC_INFO, which is
+   "... typeName() [with T = QList<int>]" for GCC, "... [T = QList<int>]" for
+   Clang and "... typeName<class QList<int> >(void)" for MSVC.
+*/
+template<class T>
+QByteArray typeName()
+{
+  QByteArray name(Q_FUNC_INFO);
+  int start = name.indexOf("T = ");
+  int end = -1;
+
+  if (start >= 0) {
+    start += 4;
+    end = name.indexOf(']', start);
+
+    // GCC lists typedefs used in the signature after the parameters.
+    const int next = name.indexOf(';', start);
+
+    if (next >= 0 && (end < 0 || next < end)) {
+      end = next;
+    }
+  } else {
+    start = name.indexOf("typeName<");
+    end = name.lastIndexOf(">(");
+
+    if (start >= 0) {
+      start += 9;
+    }
+  }
+
+  if (start < 0 || end < start) {
+    return name;
+  }
+
+  name = name.mid(start, end - start).trimmed();
+  name.replace("class ", "");
+  name.replace("struct ", "");
+  return name;
+}
+
+inline Counters& threadCounters()
+{
+  static thread_local ThreadSlot slot;
+
+  if (!slot.counters) {
+    slot.counters = Registry::instance().attach();
+  }
+
+  return *slot.counters;
+}
+
+} // end of namespace detail
+
+/*!
+   \brief A named measuring point. Create as a function local static, as
+   the QYAML_PROBE macro does, so it is registered once.
+*/
+class Probe
+{
+public:
+  explicit Probe(const char* name)
+    : m_index(detail::Registry::instance().registerProbe(QByteArray(name))) {}
+
+  explicit Probe(const QByteArray& name)
+    : m_index(detail::Registry::instance().registerProbe(name)) {}
+
+  int index() const { return m_index; }
+
+private:
+  int m_index;
+};
+
+/*!
+   \brief Records one call to a Probe, and the time until it goes out of
+   scope.
+*/
+class ScopedProbe
+{
+public:
+  explicit ScopedProbe(const Probe& probe, quint64 bytes = 0)
+    : m_index(probe.index())
+    , m_bytes(bytes)
+    , m_start(Clock::now()) {}
+
+  ~ScopedProbe() {
+    if (m_index < 0) {
+      return;
+    }
+
+    const quint64 elapsed = quint64(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start)
+        .count());
+    detail::Counters& counters = detail::threadCounters();
+    detail::add(counters.calls[m_index], 1);
+    detail::add(counters.nanoseconds[m_index], elapsed);
+    detail::add(counters.bytes[m_index], m_bytes);
+  }
+
+  ScopedProbe(const ScopedProbe&) = delete;
+  ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+  void addBytes(quint64 bytes) { m_bytes += bytes; }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  int m_index;
+  quint64 m_bytes;
+  Clock::time_point m_start;
+};
+
+inline bool enabled()
+{
+  return true;
+}
+
+/*!
+   \brief The totals of every probe over all threads since the last reset().
+*/
+inline QVector<ProbeStats> snapshot()
+{
+  detail::Registry& registry = detail::Registry::instance();
+  QVector<ProbeStats> stats = registry.totals();
+  QMutexLocker locker(&registry.baselineMutex());
+  const QVector<ProbeStats>& baseline = registry.baseline();
+
+  for (int i = 0; i < stats.size() && i < baseline.size(); ++i) {
+    stats[i].calls -= baseline.at(i).calls;
+    stats[i].nanoseconds -= baseline.at(i).nanoseconds;
+    stats[i].bytes -= baseline.at(i).bytes;
+  }
+
+  return stats;
+}
+
+/*!
+   \brief Starts counting from zero again.
+*/
+inline void reset()
+{
+  detail::Registry& registry = detail::Registry::instance();
+  QVector<ProbeStats> totals = registry.totals();
+  QMutexLocker locker(&registry.baselineMutex());
+  registry.baseline() = totals;
+}
+
+#define QYAML_PROBE(name)                                                      \
+  static const ::QYaml::Instrumentation::Probe qyaml_probe_(name);             \
+  ::QYaml::Instrumentation::ScopedProbe qyaml_scope_(qyaml_probe_)
+
+// A probe in a template, named "<type>::<name>" after the instantiated
+// type. The type comes last as it may hold commas, as in QMap<K, V>.
+#define QYAML_TYPED_PROBE(name, ...)                                           \
+  static const ::QYaml::Instrumentation::Probe qyaml_probe_(                   \
+    ::QYaml::Instrumentation::detail::typeName<__VA_ARGS__>() + "::" + name);  \
+  ::QYaml::Instrumentation::ScopedProbe qyaml_scope_(qyaml_probe_)
+
+#define QYAML_PROBE_BYTES(bytes) qyaml_scope_.addBytes(quint64(bytes))
+
+#else // QYAMLCPP_INSTRUMENTATION
+
+inline bool enabled()
+{
+  return false;
+}
+
+inline QVector<ProbeStats> snapshot()
+{
+  return QVector<ProbeStats>();
+}
+
+inline void reset() {}
+
+#define QYAML_PROBE(name)                                                      \
+  do {                                                                         \
+  } while (0)
+
+#define QYAML_TYPED_PROBE(name, ...)                                           \
+  do {                                                                         \
+  } while (0)
+
+#define QYAML_PROBE_BYTES(bytes)                                               \
+  do {                                                                         \
+  } while (0)
+
+#endif // QYAMLCPP_INSTRUMENTATION
+
+/*!
+   \brief The snapshot as { name: { calls, nanoseconds, bytes } }, leaving
+   out probes that have not been called.
+*/
+inline QVariantMap toVariantMap()
+{
+  QVariantMap map;
+
+  for (const ProbeStats& probe : snapshot()) {
+    if (probe.calls == 0) {
+      continue;
+    }
+
+    QVariantMap values;
+    values.insert(QStringLiteral("calls"), probe.calls);
+    values.insert(QStringLiteral("nanoseconds"), probe.nanoseconds);
+    values.insert(QStringLiteral("bytes"), probe.bytes);
+    map.insert(probe.name, values);
+  }
+
+  return map;
+}
+
+inline QByteArray toJson(QJsonDocument::JsonFormat format = QJsonDocument::Indented)
+{
+  return QJsonDocument(QJsonObject::fromVariantMap(toVariantMap())).toJson(format);
+}
+
+} // end of namespace Instrumentation
+} // end of namespace QYaml
+
+#endif // QYAML_INSTRUMENT_H
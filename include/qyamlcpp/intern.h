@@ -0,0 +1,202 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_INTERN_H
+#define QYAML_INTERN_H
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+namespace QYaml {
+
+/*!
+   \brief An interning table for decoded QStrings.
+
+   Decoding a document normally creates a new QString for every occurrence
+   of a repeated key or enum like value. While a StringPool is active
+   convert<QString> looks the scalar up in the pool first and hands back
+   an implicitly shared copy of the existing QString, so each distinct
+   string is stored once.
+
+   A pool can be scoped to a single load:
+
+   \code
+   QYaml::StringPool pool;
+   {
+      QYaml::StringPool::Scope scope(pool);
+      inventory = root["items"].as<QList<QVariantMap>>();
+   }
+   \endcode
+
+   or made the default for every thread:
+
+   \code
+   QYaml::StringPool::setDefault(&QYaml::StringPool::global());
+   \endcode
+
+   Scopes are per thread and nest. A pool constructed with threadSafe false
+   must only be active in one thread at a time. Strings longer than
+   maximumLength() are never interned, as they are rarely repeated.
+*/
+class StringPool
+{
+public:
+  explicit StringPool(bool threadSafe = false)
+    : m_threadSafe(threadSafe)
+    , m_maximumLength(64) {}
+
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  /*!
+     \brief Returns a shared QString for the UTF-8 text.
+  */
+  QString intern(const char* data, std::size_t size) {
+    if (size > m_maximumLength) {
+      return QString::fromUtf8(data, int(size));
+    }
+
+    QMutexLocker locker(m_threadSafe ? &m_mutex : nullptr);
+
+    // m_key keeps its capacity, so lookups of strings already in the pool
+    // do not allocate.
+    m_key.assign(data, size);
+    Table::const_iterator it = m_strings.find(m_key);
+
+    if (it != m_strings.end()) {
+      return it->second;
+    }
+
+    QString value = QString::fromUtf8(data, int(size));
+    m_strings.emplace(m_key, value);
+    return value;
+  }
+
+  QString intern(const std::string& text) {
+    return intern(text.data(), text.size());
+  }
+
+  int size() const {
+    QMutexLocker locker(m_threadSafe ? &m_mutex : nullptr);
+    return int(m_strings.size());
+  }
+
+  void clear() {
+    QMutexLocker locker(m_threadSafe ? &m_mutex : nullptr);
+    Table().swap(m_strings);
+  }
+
+  std::size_t maximumLength() const { return m_maximumLength; }
+  void setMaximumLength(std::size_t length) { m_maximumLength = length; }
+
+  /*!
+     \brief A process wide, thread safe pool.
+  */
+  static StringPool& global() {
+    static StringPool pool(true);
+    return pool;
+  }
+
+  /*!
+     \brief Sets the pool used by threads with no active Scope. Pass nullptr
+     to turn default interning off.
+  */
+  static void setDefault(StringPool* pool) { defaultPool().store(pool); }
+
+  /*!
+     \brief The pool active in the calling thread, or nullptr.
+  */
+  static StringPool* current() {
+    StringPool* pool = scopedPool();
+    return pool ? pool : defaultPool().load();
+  }
+
+  /*!
+     \brief Makes a pool active in the calling thread for its lifetime.
+  */
+  class Scope
+  {
+  public:
+    explicit Scope(StringPool& pool)
+      : m_previous(scopedPool()) {
+      scopedPool() = &pool;
+    }
+
+    ~Scope() { scopedPool() = m_previous; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    StringPool* m_previous;
+  };
+
+private:
+  typedef std::unordered_map<std::string, QString> Table;
+
+  static StringPool*& scopedPool() {
+    static thread_local StringPool* pool = nullptr;
+    return pool;
+  }
+
+  static std::atomic<StringPool*>& defaultPool() {
+    static std::atomic<StringPool*> pool(nullptr);
+    return pool;
+  }
+
+  const bool m_threadSafe;
+  std::size_t m_maximumLength;
+  mutable QMutex m_mutex;
+  std::string m_key;
+  Table m_strings;
+};
+
+/*!
+   \brief Converts UTF-8 text to a QString, going through the active
+   StringPool if there is one.
+*/
+inline QString internedString(const char* data, std::size_t size)
+{
+  StringPool* pool = StringPool::current();
+
+  if (pool) {
+    return pool->intern(data, size);
+  }
+
+  return QString::fromUtf8(data, int(size));
+}
+
+inline QString internedString(const std::string& text)
+{
+  return internedString(text.data(), text.size());
+}
+
+} // end of namespace QYaml
+
+#endif // QYAML_INTERN_H
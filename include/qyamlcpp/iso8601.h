@@ -0,0 +1,490 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_ISO8601_H
+#define QYAML_ISO8601_H
+
+#include <QDate>
+#include <QDateTime>
+#include <QTime>
+
+#include <cstddef>
+
+namespace QYaml {
+
+/*!
+   \brief Fixed layout ISO 8601 parsing and formatting of dates and times.
+
+   Only the layouts the converters write are handled here,
+
+   \code
+   2020-06-01
+   13:45:30, 13:45:30.250
+   2020-06-01T13:45:30Z, 2020-06-01T13:45:30.250+02:00
+   \endcode
+
+   with 't' or a space also allowed between date and time, "hh:mm" times,
+   fractions of any length, cut to milliseconds, and "+hh", "+hhmm" or
+   "+hh:mm" offsets. Anything else returns false so the caller can fall back
+   to QDateTime::fromString(). A date and time ending in 'Z' never goes near
+   the time zone database. As with Qt::ISODate a date and time without an
+   offset is local time.
+
+   Years before 1 or after 9999 are written in the ISO 8601 expanded form, a
+   sign and five or more digits, "+12345-01-01". ISO 8601 counts 1 BC as
+   year 0, where Qt calls it -1, so QDate(-1, 1, 1) is "+00000-01-01" and
+   QDate(-44, 3, 15) is "-00043-03-15". Like Qt::ISODate, "0000" is rejected.
+*/
+namespace Iso8601 {
+
+enum
+{
+  //! Big enough for any formatDate() output.
+  DateLength = 17,
+  //! Big enough for any formatDateTime() output.
+  DateTimeLength = 40
+};
+
+namespace detail {
+
+inline bool digits(const char* data, int count, int& value)
+{
+  value = 0;
+
+  for (int i = 0; i < count; ++i) {
+    const unsigned digit = unsigned(data[i] - '0');
+
+    if (digit > 9) {
+      return false;
+    }
+
+    value = value * 10 + int(digit);
+  }
+
+  return true;
+}
+
+inline bool isLeapYear(int year)
+{
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+inline int daysInMonth(int year, int month)
+{
+  static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  return month == 2 && isLeapYear(year) ? 29 : days[month - 1];
+}
+
+// days since 1970-01-01 of a proleptic Gregorian date.
+inline qint64 daysFromCivil(int year, int month, int day)
+{
+  year -= month <= 2 ? 1 : 0;
+  const qint64 era = (year >= 0 ? year : year - 399) / 400;
+  const qint64 yearOfEra = year - era * 400;
+  const qint64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const qint64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+inline void civilFromDays(qint64 days, int& year, int& month, int& day)
+{
+  days += 719468;
+  const qint64 era = (days >= 0 ? days : days - 146096) / 146097;
+  const qint64 dayOfEra = days - era * 146097;
+  const qint64 yearOfEra =
+    (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  const qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  const qint64 shifted = (5 * dayOfYear + 2) / 153;
+  day = int(dayOfYear - (153 * shifted + 2) / 5 + 1);
+  month = int(shifted < 10 ? shifted + 3 : shifted - 9);
+  year = int(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// Qt has no year 0, its year -1 is 1 BC, which ISO 8601 numbers 0.
+inline int astronomicalYear(int year)
+{
+  return year < 0 ? year + 1 : year;
+}
+
+inline int qtYear(int astronomical)
+{
+  return astronomical <= 0 ? astronomical - 1 : astronomical;
+}
+
+// "yyyy-MM-dd" or "+yyyyy-MM-dd" with up to nine year digits, leaves p after
+// the date. year is Qt's.
+inline bool parseDate(const char*& p, const char* end, int& year, int& month, int& day)
+{
+  int astronomical = 0;
+
+  if (p < end && (*p == '+' || *p == '-')) {
+    const bool negative = *p == '-';
+    const char* const first = ++p;
+
+    while (p < end && p - first < 9 && unsigned(*p - '0') <= 9) {
+      astronomical = astronomical * 10 + (*p - '0');
+      ++p;
+    }
+
+    if (p - first < 5) {
+      return false;
+    }
+
+    astronomical = negative ? -astronomical : astronomical;
+
+  } else {
+    if (end - p < 4 || !digits(p, 4, astronomical) || astronomical == 0) {
+      return false;
+    }
+
+    p += 4;
+  }
+
+  if (end - p < 6 || p[0] != '-' || !digits(p + 1, 2, month) || p[3] != '-' ||
+      !digits(p + 4, 2, day) || month < 1 || month > 12 || day < 1 ||
+      day > daysInMonth(astronomical, month)) {
+    return false;
+  }
+
+  p += 6;
+  year = qtYear(astronomical);
+  return true;
+}
+
+// "hh:mm[:ss[.fraction]]", leaves p after the time.
+inline bool parseTime(const char*& p,
+                      const char* end,
+                      int& hour,
+                      int& minute,
+                      int& second,
+                      int& msec)
+{
+  second = 0;
+  msec = 0;
+
+  if (end - p < 5 || !digits(p, 2, hour) || p[2] != ':' || !digits(p + 3, 2, minute) ||
+      hour > 23 || minute > 59) {
+    return false;
+  }
+
+  p += 5;
+
+  if (p == end || *p != ':') {
+    return true;
+  }
+
+  if (end - p < 3 || !digits(p + 1, 2, second) || second > 59) {
+    return false;
+  }
+
+  p += 3;
+
+  if (p == end || (*p != '.' && *p != ',')) {
+    return true;
+  }
+
+  const char* fraction = ++p;
+  int scale = 100;
+
+  while (p != end && unsigned(*p - '0') <= 9) {
+    msec += (*p - '0') * scale;
+    scale /= 10;
+    ++p;
+  }
+
+  return p != fraction;
+}
+
+// "Z", "+hh", "+hhmm" or "+hh:mm", nothing at all is local time.
+inline bool parseOffset(const char* p, const char* end, bool& local, int& offset)
+{
+  local = (p == end);
+  offset = 0;
+
+  if (local) {
+    return true;
+  }
+
+  if (*p == 'Z' || *p == 'z') {
+    return p + 1 == end;
+  }
+
+  if (*p != '+' && *p != '-') {
+    return false;
+  }
+
+  const int sign = *p == '-' ? -1 : 1;
+  const std::ptrdiff_t length = end - p - 1;
+  int hours = 0;
+  int minutes = 0;
+
+  if (length < 2 || !digits(p + 1, 2, hours)) {
+    return false;
+  }
+
+  if (length == 4) {
+    if (!digits(p + 3, 2, minutes)) {
+      return false;
+    }
+  } else if (length == 5) {
+    if (p[3] != ':' || !digits(p + 4, 2, minutes)) {
+      return false;
+    }
+  } else if (length != 2) {
+    return false;
+  }
+
+  if (hours > 23 || minutes > 59) {
+    return false;
+  }
+
+  offset = sign * (hours * 3600 + minutes * 60);
+  return true;
+}
+
+inline char* put(char* out, qint64 value, int width)
+{
+  for (int i = width - 1; i >= 0; --i) {
+    out[i] = char('0' + value % 10);
+    value /= 10;
+  }
+
+  return out + width;
+}
+
+inline char* putDate(char* out, int year, int month, int day)
+{
+  if (year >= 1 && year <= 9999) {
+    out = put(out, year, 4);
+  } else {
+    const qint64 astronomical = astronomicalYear(year);
+    const qint64 magnitude = astronomical < 0 ? -astronomical : astronomical;
+    int width = 5;
+
+    for (qint64 rest = magnitude / 100000; rest > 0; rest /= 10) {
+      ++width;
+    }
+
+    *out++ = astronomical < 0 ? '-' : '+';
+    out = put(out, magnitude, width);
+  }
+
+  *out++ = '-';
+  out = put(out, month, 2);
+  *out++ = '-';
+  return put(out, day, 2);
+}
+
+inline char* putTime(char* out, int hour, int minute, int second, int msec)
+{
+  out = put(out, hour, 2);
+  *out++ = ':';
+  out = put(out, minute, 2);
+  *out++ = ':';
+  out = put(out, second, 2);
+
+  if (msec != 0) {
+    *out++ = '.';
+    out = put(out, msec, 3);
+  }
+
+  return out;
+}
+
+} // end of namespace detail
+
+inline bool parseDate(const char* data, std::size_t size, QDate& date)
+{
+  const char* end = data + size;
+  int year, month, day;
+
+  if (!detail::parseDate(data, end, year, month, day) || data != end) {
+    return false;
+  }
+
+  date = QDate(year, month, day);
+  return true;
+}
+
+inline bool parseTime(const char* data, std::size_t size, QTime& time)
+{
+  const char* end = data + size;
+  int hour, minute, second, msec;
+
+  if (!detail::parseTime(data, end, hour, minute, second, msec) || data != end) {
+    return false;
+  }
+
+  time = QTime(hour, minute, second, msec);
+  return true;
+}
+
+inline bool parseDateTime(const char* data, std::size_t size, QDateTime& dateTime)
+{
+  const char* p = data;
+  const char* end = data + size;
+  int year, month, day;
+
+  if (!detail::parseDate(p, end, year, month, day)) {
+    return false;
+  }
+
+  // a date on its own is the start of that day, as with Qt::ISODate.
+  if (p == end) {
+    dateTime = QDateTime(QDate(year, month, day), QTime(0, 0));
+    return true;
+  }
+
+  int hour, minute, second, msec, offset;
+  bool local;
+
+  if (*p != 'T' && *p != 't' && *p != ' ') {
+    return false;
+  }
+
+  ++p;
+
+  if (!detail::parseTime(p, end, hour, minute, second, msec) ||
+      !detail::parseOffset(p, end, local, offset)) {
+    return false;
+  }
+
+  if (local) {
+    dateTime = QDateTime(QDate(year, month, day), QTime(hour, minute, second, msec));
+    return true;
+  }
+
+  // further out the milliseconds since the epoch would overflow.
+  if (year < -99999999 || year > 99999999) {
+    return false;
+  }
+
+  const qint64 days = detail::daysFromCivil(detail::astronomicalYear(year), month, day);
+  const qint64 msecs = days * 86400000 + ((hour * 60 + minute) * 60 + second) * 1000 + msec -
+                       offset * 1000;
+
+  dateTime = offset == 0 && (p[0] == 'Z' || p[0] == 'z')
+               ? QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC)
+               : QDateTime::fromMSecsSinceEpoch(msecs, Qt::OffsetFromUTC, offset);
+  return true;
+}
+
+/*!
+   \brief Writes "yyyy-MM-dd" to out, which must have room for DateLength
+   characters. Returns the length, or 0 for an invalid date.
+*/
+inline int formatDate(const QDate& date, char* out)
+{
+  if (!date.isValid()) {
+    return 0;
+  }
+
+  return int(detail::putDate(out, date.year(), date.month(), date.day()) - out);
+}
+
+/*!
+   \brief Writes "hh:mm:ss", or "hh:mm:ss.zzz" if there are milliseconds, to
+   out, which must have room for 12 characters. Returns 0 for an invalid
+   time.
+*/
+inline int formatTime(const QTime& time, char* out)
+{
+  if (!time.isValid()) {
+    return 0;
+  }
+
+  return int(detail::putTime(out, time.hour(), time.minute(), time.second(), time.msec()) -
+             out);
+}
+
+/*!
+   \brief Writes a date and time, with "Z" for UTC, an offset for other
+   fixed offsets and time zones and nothing for local time, to out, which
+   must have room for DateTimeLength characters. Returns 0 for an invalid
+   date and time.
+*/
+inline int formatDateTime(const QDateTime& dateTime, char* out)
+{
+  if (!dateTime.isValid()) {
+    return 0;
+  }
+
+  const Qt::TimeSpec spec = dateTime.timeSpec();
+  int year, month, day, hour, minute, second, msec;
+  int offset = 0;
+
+  if (spec == Qt::LocalTime) {
+    const QDate date = dateTime.date();
+    const QTime time = dateTime.time();
+    year = date.year();
+    month = date.month();
+    day = date.day();
+    hour = time.hour();
+    minute = time.minute();
+    second = time.second();
+    msec = time.msec();
+  } else {
+    // fixed offsets and UTC are split up here, without Qt's date cache.
+    if (spec != Qt::UTC) {
+      offset = dateTime.offsetFromUtc();
+    }
+
+    const qint64 msecs = dateTime.toMSecsSinceEpoch() + qint64(offset) * 1000;
+    qint64 days = msecs / 86400000;
+    qint64 rest = msecs % 86400000;
+
+    if (rest < 0) {
+      rest += 86400000;
+      --days;
+    }
+
+    detail::civilFromDays(days, year, month, day);
+    year = detail::qtYear(year);
+    msec = int(rest % 1000);
+    second = int(rest / 1000 % 60);
+    minute = int(rest / 60000 % 60);
+    hour = int(rest / 3600000);
+  }
+
+  char* p = detail::putDate(out, year, month, day);
+  *p++ = 'T';
+  p = detail::putTime(p, hour, minute, second, msec);
+
+  if (spec == Qt::UTC) {
+    *p++ = 'Z';
+  } else if (spec != Qt::LocalTime) {
+    const int minutes = (offset < 0 ? -offset : offset) / 60;
+    *p++ = offset < 0 ? '-' : '+';
+    p = detail::put(p, minutes / 60, 2);
+    *p++ = ':';
+    p = detail::put(p, minutes % 60, 2);
+  }
+
+  return int(p - out);
+}
+
+} // end of namespace Iso8601
+} // end of namespace QYaml
+
+#endif // QYAML_ISO8601_H
@@ -0,0 +1,514 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_ITEMMODEL_H
+#define QYAML_ITEMMODEL_H
+
+#include <QAbstractItemModel>
+#include <QColor>
+#include <QFont>
+#include <QModelIndex>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "docindex.h"
+#include "node.h"
+
+namespace QYaml {
+
+/*!
+   \brief A read only item model over a YAML::Node, or over the documents of
+   a DocumentIndex, for tree views of large files.
+
+   Nothing is converted up front. Rows are created in batches of batchSize()
+   when the view asks for them through canFetchMore() and fetchMore(), so
+   only the parts of the tree that have been expanded take any memory. With
+   a DocumentIndex each document is only read and parsed when its row is
+   expanded.
+
+   There are three columns, the key, the value and the node type. Sequence
+   elements are keyed by their index. Mappings with the shape of an encoded
+   QColor or QFont are decoded through the usual converters, the first time
+   they are shown, and give a colour swatch as the value's DecorationRole
+   and a font preview as its FontRole.
+
+   \code
+   YAML::Node root = YAML::LoadFile(path);
+   QYaml::NodeModel model(root);
+   treeView->setModel(&model);
+
+   QYaml::DocumentIndex index(logPath);
+   index.build("id");
+   QYaml::NodeModel documents(&index);
+   \endcode
+
+   The model keeps a handle to the root node, so changing the node while a
+   view is attached gives undefined results. Call setRoot() again instead.
+*/
+class NodeModel : public QAbstractItemModel
+{
+public:
+  enum Column
+  {
+    KeyColumn,
+    ValueColumn,
+    TypeColumn,
+    ColumnCount
+  };
+
+  explicit NodeModel(QObject* parent = nullptr)
+    : QAbstractItemModel(parent)
+    , m_index(nullptr)
+    , m_batchSize(256) {
+    setRoot(YAML::Node());
+  }
+
+  explicit NodeModel(const YAML::Node& root, QObject* parent = nullptr)
+    : QAbstractItemModel(parent)
+    , m_index(nullptr)
+    , m_batchSize(256) {
+    setRoot(root);
+  }
+
+  /*!
+     \brief A model with one top-level row per document of index. The index
+     is not owned and must outlive the model.
+  */
+  explicit NodeModel(const DocumentIndex* index, QObject* parent = nullptr)
+    : QAbstractItemModel(parent)
+    , m_index(nullptr)
+    , m_batchSize(256) {
+    setDocumentIndex(index);
+  }
+
+  void setRoot(const YAML::Node& root) {
+    beginResetModel();
+    m_index = nullptr;
+    m_root.reset(new Item(nullptr, 0, YAML::Node(), root));
+
+    // a scalar has no rows of its own, so show it as the only row.
+    if (!isCollection(root) && root.IsDefined() && !root.IsNull()) {
+      m_root->total = 1;
+    }
+
+    endResetModel();
+  }
+
+  void setDocumentIndex(const DocumentIndex* index) {
+    beginResetModel();
+    m_index = index;
+    m_root.reset(new Item(nullptr, 0, YAML::Node(), YAML::Node()));
+    m_root->total = index ? index->count() : 0;
+    endResetModel();
+  }
+
+  /*!
+     \brief The number of rows added by each fetchMore(), 256 by default.
+  */
+  int batchSize() const { return m_batchSize; }
+  void setBatchSize(int rows) { m_batchSize = qMax(1, rows); }
+
+  /*!
+     \brief The node shown at index, which is loaded first if it is a
+     document of the index.
+  */
+  YAML::Node node(const QModelIndex& index) const {
+    Item* item = itemAt(index);
+    load(item);
+    return item->node;
+  }
+
+  QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override {
+    Item* item = itemAt(parent);
+
+    if (row < 0 || column < 0 || column >= ColumnCount ||
+        row >= int(item->children.size()) || (parent.isValid() && parent.column() != 0)) {
+      return QModelIndex();
+    }
+
+    return createIndex(row, column, item->children[std::size_t(row)].get());
+  }
+
+  QModelIndex parent(const QModelIndex& child) const override {
+    if (!child.isValid()) {
+      return QModelIndex();
+    }
+
+    Item* parent = static_cast<Item*>(child.internalPointer())->parent;
+
+    if (parent == m_root.get()) {
+      return QModelIndex();
+    }
+
+    return createIndex(parent->row, 0, parent);
+  }
+
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override {
+    if (parent.column() > 0) {
+      return 0;
+    }
+
+    return int(itemAt(parent)->children.size());
+  }
+
+  int columnCount(const QModelIndex& = QModelIndex()) const override { return ColumnCount; }
+
+  bool hasChildren(const QModelIndex& parent = QModelIndex()) const override {
+    if (parent.column() > 0) {
+      return false;
+    }
+
+    Item* item = itemAt(parent);
+
+    // documents are not read until they are expanded.
+    if (item->document >= 0 && !item->loaded) {
+      return true;
+    }
+
+    return childCount(item) > 0;
+  }
+
+  bool canFetchMore(const QModelIndex& parent) const override {
+    if (parent.column() > 0) {
+      return false;
+    }
+
+    Item* item = itemAt(parent);
+    load(item);
+    return int(item->children.size()) < childCount(item);
+  }
+
+  void fetchMore(const QModelIndex& parent) override {
+    if (!canFetchMore(parent)) {
+      return;
+    }
+
+    Item* item = itemAt(parent);
+    const int first = int(item->children.size());
+    const int last = qMin(childCount(item), first + m_batchSize) - 1;
+
+    beginInsertRows(parent, first, last);
+    item->children.reserve(std::size_t(last + 1));
+
+    for (int row = first; row <= last; ++row) {
+      item->children.emplace_back(createChild(item, row));
+    }
+
+    endInsertRows();
+  }
+
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override {
+    if (!index.isValid()) {
+      return QVariant();
+    }
+
+    Item* item = static_cast<Item*>(index.internalPointer());
+
+    switch (index.column()) {
+    case KeyColumn:
+      return role == Qt::DisplayRole ? keyText(item) : QVariant();
+
+    case ValueColumn:
+      return value(item, role);
+
+    case TypeColumn:
+      return role == Qt::DisplayRole ? typeText(item) : QVariant();
+
+    default:
+      return QVariant();
+    }
+  }
+
+  QVariant headerData(int section,
+                      Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+      return QVariant();
+    }
+
+    switch (section) {
+    case KeyColumn:
+      return QStringLiteral("Key");
+    case ValueColumn:
+      return QStringLiteral("Value");
+    case TypeColumn:
+      return QStringLiteral("Type");
+    default:
+      return QVariant();
+    }
+  }
+
+  Qt::ItemFlags flags(const QModelIndex& index) const override {
+    if (!index.isValid()) {
+      return Qt::NoItemFlags;
+    }
+
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+  }
+
+private:
+  enum Kind
+  {
+    Unknown,
+    Plain,
+    Color,
+    Font
+  };
+
+  // scalars longer than this are cut short in the value column.
+  enum
+  {
+    DisplayLength = 200
+  };
+
+  struct Item
+  {
+    Item(Item* parent, int row, const YAML::Node& key, const YAML::Node& node)
+      : parent(parent)
+      , row(row)
+      , key(key)
+      , node(node)
+      , document(-1)
+      , total(-1)
+      , loaded(true)
+      , kind(Unknown) {}
+
+    Item* parent;
+    int row;
+    YAML::Node key;
+    YAML::Node node;
+    int document;
+    int total;
+    bool loaded;
+    QString error;
+    YAML::const_iterator next;
+    std::vector<std::unique_ptr<Item>> children;
+    Kind kind;
+    QVariant decoded;
+  };
+
+  static bool isCollection(const YAML::Node& node) {
+    return node.IsMap() || node.IsSequence();
+  }
+
+  Item* itemAt(const QModelIndex& index) const {
+    return index.isValid() ? static_cast<Item*>(index.internalPointer()) : m_root.get();
+  }
+
+  // reads and parses a document of the index the first time it is needed.
+  void load(Item* item) const {
+    if (item->loaded) {
+      return;
+    }
+
+    item->loaded = true;
+
+    try {
+      item->node.reset(m_index->loadDocument(item->document));
+    } catch (const YAML::Exception& e) {
+      item->error = QString::fromStdString(e.msg);
+    }
+  }
+
+  int childCount(Item* item) const {
+    if (item->total < 0) {
+      item->total = isCollection(item->node) ? int(item->node.size()) : 0;
+    }
+
+    return item->total;
+  }
+
+  Item* createChild(Item* item, int row) const {
+    if (item == m_root.get() && m_index) {
+      Item* child = new Item(item, row, YAML::Node(), YAML::Node());
+      child->document = row;
+      child->loaded = false;
+      return child;
+    }
+
+    if (!isCollection(item->node)) {
+      return new Item(item, row, YAML::Node(), item->node);
+    }
+
+    // rows are always added in order, so one iterator per item is enough.
+    if (row == 0) {
+      item->next = item->node.begin();
+    }
+
+    const YAML::const_iterator it = item->next++;
+
+    if (item->node.IsMap()) {
+      return new Item(item, row, it->first, it->second);
+    }
+
+    return new Item(item, row, YAML::Node(), *it);
+  }
+
+  static QString flowText(const YAML::Node& node) {
+    YAML::Emitter out;
+    out << YAML::Flow << node;
+    return QString::fromUtf8(out.c_str(), int(out.size()));
+  }
+
+  QString keyText(Item* item) const {
+    if (item->document >= 0) {
+      const DocumentIndex::Entry& entry = m_index->entry(item->document);
+      return entry.hasKey ? entry.key : QStringLiteral("document %1").arg(item->document);
+    }
+
+    if (!item->key.IsDefined() || item->key.IsNull()) {
+      return item->parent->node.IsSequence() ? QStringLiteral("[%1]").arg(item->row) : QString();
+    }
+
+    return item->key.IsScalar() ? QString::fromStdString(item->key.Scalar()) : flowText(item->key);
+  }
+
+  static QString typeText(Item* item) {
+    if (!item->loaded) {
+      return QStringLiteral("document");
+    }
+
+    QString type;
+
+    switch (item->node.Type()) {
+    case YAML::NodeType::Map:
+      type = QStringLiteral("map");
+      break;
+    case YAML::NodeType::Sequence:
+      type = QStringLiteral("sequence");
+      break;
+    case YAML::NodeType::Scalar:
+      type = QStringLiteral("scalar");
+      break;
+    default:
+      type = QStringLiteral("null");
+      break;
+    }
+
+    const std::string& tag = item->node.Tag();
+
+    if (!tag.empty() && tag != "?" && tag != "!") {
+      type += QStringLiteral(" ") + QString::fromStdString(tag);
+    }
+
+    return type;
+  }
+
+  // colour and font maps are recognised by their shape and decoded once.
+  static void decode(Item* item) {
+    if (item->kind != Unknown) {
+      return;
+    }
+
+    item->kind = Plain;
+
+    try {
+      if (YAML::convert<QVariant>::isColor(item->node)) {
+        item->decoded = QVariant::fromValue(item->node.as<QColor>());
+        item->kind = Color;
+      } else if (YAML::convert<QVariant>::isFont(item->node)) {
+        item->decoded = QVariant::fromValue(item->node.as<QFont>());
+        item->kind = Font;
+      }
+    } catch (const YAML::Exception&) {
+      item->decoded = QVariant();
+    }
+  }
+
+  QVariant value(Item* item, int role) const {
+    if (!item->loaded) {
+      return QVariant();
+    }
+
+    if (!item->error.isEmpty()) {
+      return role == Qt::DisplayRole || role == Qt::ToolTipRole ? QVariant(item->error)
+                                                                : QVariant();
+    }
+
+    const YAML::Node& node = item->node;
+
+    if (node.IsScalar()) {
+      const std::string& scalar = node.Scalar();
+
+      if (role == Qt::DisplayRole) {
+        // only the start of a long or multi line scalar is converted.
+        std::size_t length = scalar.find('\n');
+        length = std::min<std::size_t>(length, DisplayLength);
+        QString text = QString::fromUtf8(scalar.data(), int(std::min(length, scalar.size())));
+        return length < scalar.size() ? text + QChar(0x2026) : text;
+      }
+
+      if (role == Qt::ToolTipRole && scalar.size() > DisplayLength) {
+        return QString::fromUtf8(scalar.data(), int(std::min<std::size_t>(scalar.size(), 4096)));
+      }
+
+      return QVariant();
+    }
+
+    if (!isCollection(node)) {
+      return QVariant();
+    }
+
+    decode(item);
+
+    switch (role) {
+    case Qt::DisplayRole:
+      if (item->kind == Color) {
+        return item->decoded.value<QColor>().name(QColor::HexArgb);
+      }
+
+      if (item->kind == Font) {
+        const QFont font = item->decoded.value<QFont>();
+        return QStringLiteral("%1, %2pt").arg(font.family()).arg(font.pointSize());
+      }
+
+      return node.IsMap() ? QStringLiteral("{%1}").arg(childCount(item))
+                          : QStringLiteral("[%1]").arg(childCount(item));
+
+    case Qt::DecorationRole:
+      return item->kind == Color ? item->decoded : QVariant();
+
+    case Qt::FontRole:
+      return item->kind == Font ? item->decoded : QVariant();
+
+    default:
+      return QVariant();
+    }
+  }
+
+  std::unique_ptr<Item> m_root;
+  const DocumentIndex* m_index;
+  int m_batchSize;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_ITEMMODEL_H
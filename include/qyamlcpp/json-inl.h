@@ -0,0 +1,409 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_JSON_INL_H
+#define QYAML_JSON_INL_H
+
+#include "json.h"
+
+namespace YAML {
+
+/* = QJsonValue
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QJsonValue>::encode(const QJsonValue& rhs)
+{
+  QYAML_PROBE("QJsonValue::encode");
+
+  switch (rhs.type()) {
+  case QJsonValue::Bool:
+    return Node(rhs.toBool());
+
+  case QJsonValue::Double:
+    return QYaml::detail::doubleNode(rhs.toDouble(), false);
+
+  case QJsonValue::String:
+    return QYaml::detail::stringNode(rhs.toString());
+
+  case QJsonValue::Array:
+    return convert<QJsonArray>::encode(rhs.toArray());
+
+  case QJsonValue::Object:
+    return convert<QJsonObject>::encode(rhs.toObject());
+
+  default:
+    return Node(NodeType::Null);
+  }
+}
+
+QYAMLCPP_INLINE bool convert<QJsonValue>::decode(const Node& node, QJsonValue& rhs)
+{
+  QYAML_PROBE("QJsonValue::decode");
+
+  switch (node.Type()) {
+  case NodeType::Null:
+    rhs = QJsonValue(QJsonValue::Null);
+    return true;
+
+  case NodeType::Scalar: {
+    const QYaml::detail::TypedScalar scalar = QYaml::detail::typedScalar(node);
+
+    switch (scalar.kind) {
+    case QYaml::detail::TypedScalar::Null:
+      rhs = QJsonValue(QJsonValue::Null);
+      break;
+
+    case QYaml::detail::TypedScalar::Bool:
+      rhs = QJsonValue(scalar.boolean);
+      break;
+
+    case QYaml::detail::TypedScalar::Integer:
+      rhs = QJsonValue(scalar.integer);
+      break;
+
+    case QYaml::detail::TypedScalar::Double:
+      rhs = QJsonValue(scalar.real);
+      break;
+
+    default:
+      rhs = QJsonValue(QString::fromStdString(node.Scalar()));
+      break;
+    }
+
+    return true;
+  }
+
+  case NodeType::Sequence: {
+    QJsonArray array;
+
+    if (!convert<QJsonArray>::decode(node, array)) {
+      return false;
+    }
+
+    rhs = array;
+    return true;
+  }
+
+  case NodeType::Map: {
+    QJsonObject object;
+
+    if (!convert<QJsonObject>::decode(node, object)) {
+      return false;
+    }
+
+    rhs = object;
+    return true;
+  }
+
+  default:
+    return false;
+  }
+}
+
+/* = QJsonArray
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QJsonArray>::encode(const QJsonArray& rhs)
+{
+  QYAML_PROBE("QJsonArray::encode");
+
+  Node node(NodeType::Sequence);
+
+  for (const QJsonValue& value : rhs) {
+    node.push_back(convert<QJsonValue>::encode(value));
+  }
+
+  return node;
+}
+
+QYAMLCPP_INLINE bool convert<QJsonArray>::decode(const Node& node, QJsonArray& rhs)
+{
+  QYAML_PROBE("QJsonArray::decode");
+
+  if (!node.IsSequence()) {
+    return false;
+  }
+
+  rhs = QJsonArray();
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    QJsonValue value;
+
+    if (!convert<QJsonValue>::decode(*it, value)) {
+      return false;
+    }
+
+    rhs.append(value);
+  }
+
+  return true;
+}
+
+/* = QJsonObject
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QJsonObject>::encode(const QJsonObject& rhs)
+{
+  QYAML_PROBE("QJsonObject::encode");
+
+  Node node(NodeType::Map);
+
+  for (QJsonObject::const_iterator it = rhs.constBegin(); it != rhs.constEnd(); ++it) {
+    node.force_insert(QYaml::detail::stringNode(it.key()),
+                      convert<QJsonValue>::encode(it.value()));
+  }
+
+  return node;
+}
+
+QYAMLCPP_INLINE bool convert<QJsonObject>::decode(const Node& node, QJsonObject& rhs)
+{
+  QYAML_PROBE("QJsonObject::decode");
+
+  if (!node.IsMap()) {
+    return false;
+  }
+
+  rhs = QJsonObject();
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    QJsonValue value;
+
+    if (!it->first.IsScalar() || !convert<QJsonValue>::decode(it->second, value)) {
+      return false;
+    }
+
+    rhs.insert(QYaml::internedString(it->first.Scalar()), value);
+  }
+
+  return true;
+}
+
+/* = QCborValue
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QCborValue>::encode(const QCborValue& rhs)
+{
+  QYAML_PROBE("QCborValue::encode");
+
+  switch (rhs.type()) {
+  case QCborValue::Integer:
+    return QYaml::detail::integerNode(rhs.toInteger());
+
+  case QCborValue::Double:
+    return QYaml::detail::doubleNode(rhs.toDouble(), true);
+
+  case QCborValue::False:
+  case QCborValue::True:
+    return Node(rhs.toBool());
+
+  case QCborValue::String:
+    return QYaml::detail::stringNode(rhs.toString());
+
+  case QCborValue::ByteArray:
+    return QYaml::detail::binaryNode(rhs.toByteArray());
+
+  case QCborValue::Array:
+    return convert<QCborArray>::encode(rhs.toArray());
+
+  case QCborValue::Map:
+    return convert<QCborMap>::encode(rhs.toMap());
+
+  case QCborValue::DateTime:
+    return convert<QDateTime>::encode(rhs.toDateTime());
+
+  case QCborValue::Url:
+    return convert<QUrl>::encode(rhs.toUrl());
+
+  case QCborValue::Uuid:
+    return convert<QUuid>::encode(rhs.toUuid());
+
+  case QCborValue::RegularExpression:
+    return QYaml::detail::stringNode(rhs.toRegularExpression().pattern());
+
+  default:
+    // other tagged values keep their content, null, undefined and simple
+    // types have no YAML equivalent.
+    if (rhs.isTag()) {
+      return encode(rhs.taggedValue());
+    }
+
+    return Node(NodeType::Null);
+  }
+}
+
+QYAMLCPP_INLINE bool convert<QCborValue>::decode(const Node& node, QCborValue& rhs)
+{
+  QYAML_PROBE("QCborValue::decode");
+
+  switch (node.Type()) {
+  case NodeType::Null:
+    rhs = QCborValue(nullptr);
+    return true;
+
+  case NodeType::Scalar: {
+    const QYaml::detail::TypedScalar scalar = QYaml::detail::typedScalar(node);
+    const std::string& text = node.Scalar();
+
+    switch (scalar.kind) {
+    case QYaml::detail::TypedScalar::Null:
+      rhs = QCborValue(nullptr);
+      break;
+
+    case QYaml::detail::TypedScalar::Bool:
+      rhs = QCborValue(scalar.boolean);
+      break;
+
+    case QYaml::detail::TypedScalar::Integer:
+      rhs = QCborValue(scalar.integer);
+      break;
+
+    case QYaml::detail::TypedScalar::Double:
+      rhs = QCborValue(scalar.real);
+      break;
+
+    case QYaml::detail::TypedScalar::Binary: {
+      QByteArray bytes;
+
+      if (!QYaml::Scalar::decodeBase64(text.data(), text.size(), bytes)) {
+        return false;
+      }
+
+      rhs = QCborValue(bytes);
+      break;
+    }
+
+    case QYaml::detail::TypedScalar::String:
+      rhs = QCborValue(QString::fromStdString(text));
+      break;
+    }
+
+    return true;
+  }
+
+  case NodeType::Sequence: {
+    QCborArray array;
+
+    if (!convert<QCborArray>::decode(node, array)) {
+      return false;
+    }
+
+    rhs = array;
+    return true;
+  }
+
+  case NodeType::Map: {
+    QCborMap map;
+
+    if (!convert<QCborMap>::decode(node, map)) {
+      return false;
+    }
+
+    rhs = map;
+    return true;
+  }
+
+  default:
+    return false;
+  }
+}
+
+/* = QCborArray
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QCborArray>::encode(const QCborArray& rhs)
+{
+  QYAML_PROBE("QCborArray::encode");
+
+  Node node(NodeType::Sequence);
+
+  for (const QCborValue& value : rhs) {
+    node.push_back(convert<QCborValue>::encode(value));
+  }
+
+  return node;
+}
+
+QYAMLCPP_INLINE bool convert<QCborArray>::decode(const Node& node, QCborArray& rhs)
+{
+  QYAML_PROBE("QCborArray::decode");
+
+  if (!node.IsSequence()) {
+    return false;
+  }
+
+  rhs = QCborArray();
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    QCborValue value;
+
+    if (!convert<QCborValue>::decode(*it, value)) {
+      return false;
+    }
+
+    rhs.append(value);
+  }
+
+  return true;
+}
+
+/* = QCborMap
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QCborMap>::encode(const QCborMap& rhs)
+{
+  QYAML_PROBE("QCborMap::encode");
+
+  Node node(NodeType::Map);
+
+  for (QCborMap::const_iterator it = rhs.constBegin(); it != rhs.constEnd(); ++it) {
+    node.force_insert(convert<QCborValue>::encode(it.key()),
+                      convert<QCborValue>::encode(it.value()));
+  }
+
+  return node;
+}
+
+QYAMLCPP_INLINE bool convert<QCborMap>::decode(const Node& node, QCborMap& rhs)
+{
+  QYAML_PROBE("QCborMap::decode");
+
+  if (!node.IsMap()) {
+    return false;
+  }
+
+  rhs = QCborMap();
+
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    QCborValue key;
+    QCborValue value;
+
+    if (!convert<QCborValue>::decode(it->first, key) ||
+        !convert<QCborValue>::decode(it->second, value)) {
+      return false;
+    }
+
+    rhs.insert(key, value);
+  }
+
+  return true;
+}
+
+} // end of namespace YAML
+
+#endif // QYAML_JSON_INL_H
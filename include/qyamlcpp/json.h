@@ -0,0 +1,387 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_JSON_H
+#define QYAML_JSON_H
+
+#include <QtGlobal>
+
+// QCborValue and QCborStreamWriter are new in Qt 5.12.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+
+#include <QByteArray>
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborStreamWriter>
+#include <QCborValue>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QRegularExpression>
+#include <QString>
+#include <QUrl>
+#include <QUuid>
+
+#include <cmath>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include "config.h"
+#include "instrument.h"
+#include "intern.h"
+#include "node.h"
+#include "scalar.h"
+
+namespace QYaml {
+namespace detail {
+
+static const char* const StringTag = "tag:yaml.org,2002:str";
+static const char* const BinaryTag = "tag:yaml.org,2002:binary";
+static const char* const NullTag = "tag:yaml.org,2002:null";
+static const char* const BoolTag = "tag:yaml.org,2002:bool";
+static const char* const IntTag = "tag:yaml.org,2002:int";
+static const char* const FloatTag = "tag:yaml.org,2002:float";
+
+/*
+   The type of a scalar as the YAML 1.2 core schema resolves it. yaml-cpp
+   tags quoted scalars "!", so those and !!str scalars stay strings, as do
+   scalars with tags of their own.
+*/
+struct TypedScalar
+{
+  enum Kind
+  {
+    Null,
+    Bool,
+    Integer,
+    Double,
+    String,
+    Binary
+  };
+
+  TypedScalar()
+    : kind(String)
+    , boolean(false)
+    , integer(0)
+    , real(0.0) {}
+
+  Kind kind;
+  bool boolean;
+  qint64 integer;
+  double real;
+};
+
+// only the core schema forms, so "yes", "n" and "off" stay strings.
+inline bool toCoreBool(const std::string& text, bool& value)
+{
+  if (text == "true" || text == "True" || text == "TRUE") {
+    value = true;
+    return true;
+  }
+
+  if (text == "false" || text == "False" || text == "FALSE") {
+    value = false;
+    return true;
+  }
+
+  return false;
+}
+
+inline TypedScalar typedScalar(const YAML::Node& node)
+{
+  TypedScalar scalar;
+  const std::string& tag = node.Tag();
+  const std::string& text = node.Scalar();
+  const bool plain = tag.empty() || tag == "?";
+
+  if (tag == BinaryTag) {
+    scalar.kind = TypedScalar::Binary;
+
+  } else if ((plain || tag == NullTag) && Scalar::isNull(text.data(), text.size())) {
+    scalar.kind = TypedScalar::Null;
+
+  } else if ((plain || tag == BoolTag) && toCoreBool(text, scalar.boolean)) {
+    scalar.kind = TypedScalar::Bool;
+
+  } else if ((plain || tag == IntTag) &&
+             Scalar::toInteger(text.data(), text.size(), scalar.integer)) {
+    scalar.kind = TypedScalar::Integer;
+
+  } else if ((plain || tag == IntTag || tag == FloatTag) &&
+             Scalar::toDouble(text.data(), text.size(), scalar.real)) {
+    // integers too big for qint64 end up here as well.
+    scalar.kind = TypedScalar::Double;
+  }
+
+  return scalar;
+}
+
+/*
+   A string scalar. Text that would read back as a number, bool or null is
+   tagged !!str so it stays a string when emitted and loaded again.
+*/
+inline YAML::Node stringNode(const QString& value)
+{
+  YAML::Node node(value.toStdString());
+
+  if (typedScalar(node).kind != TypedScalar::String) {
+    node.SetTag(StringTag);
+  }
+
+  return node;
+}
+
+inline YAML::Node integerNode(qint64 value)
+{
+  char buffer[Scalar::NumberLength];
+  const int length = Scalar::formatInteger(value, buffer);
+  return YAML::Node(std::string(buffer, std::size_t(length)));
+}
+
+/*
+   JSON has a single number type, so whole numbers are written as integers.
+   CBOR keeps doubles apart from integers, so keepDouble writes 3.0 rather
+   than 3 for it.
+*/
+inline YAML::Node doubleNode(double value, bool keepDouble)
+{
+  // 2^53, above which not every integer is a double.
+  const double exact = 9007199254740992.0;
+
+  if (!keepDouble && std::floor(value) == value && std::fabs(value) <= exact) {
+    return integerNode(qint64(value));
+  }
+
+  char buffer[Scalar::NumberLength + 2];
+  int length = Scalar::formatReal(value, buffer);
+  bool whole = true;
+
+  for (int i = 0; i < length; ++i) {
+    if (buffer[i] == '.' || buffer[i] == 'e' || buffer[i] == 'n') {
+      whole = false;
+      break;
+    }
+  }
+
+  if (whole) {
+    buffer[length++] = '.';
+    buffer[length++] = '0';
+  }
+
+  return YAML::Node(std::string(buffer, std::size_t(length)));
+}
+
+inline YAML::Node binaryNode(const QByteArray& value)
+{
+  YAML::Node node = YAML::convert<QByteArray>::encode(value);
+  node.SetTag(BinaryTag);
+  return node;
+}
+
+/*
+   Writes node as a CBOR item for QYaml::toCborValue(). Arrays and maps are
+   written with their length up front. With forJson binary scalars are left
+   as their base64 text, as the QJsonValue converter leaves them.
+*/
+inline void writeCbor(QCborStreamWriter& writer, const YAML::Node& node, bool forJson)
+{
+  switch (node.Type()) {
+  case YAML::NodeType::Scalar: {
+    const TypedScalar scalar = typedScalar(node);
+    const std::string& text = node.Scalar();
+
+    switch (scalar.kind) {
+    case TypedScalar::Null:
+      writer.append(nullptr);
+      break;
+
+    case TypedScalar::Bool:
+      writer.append(scalar.boolean);
+      break;
+
+    case TypedScalar::Integer:
+      writer.append(scalar.integer);
+      break;
+
+    case TypedScalar::Double:
+      writer.append(scalar.real);
+      break;
+
+    case TypedScalar::Binary: {
+      QByteArray bytes;
+
+      if (!forJson && Scalar::decodeBase64(text.data(), text.size(), bytes)) {
+        writer.appendByteString(bytes.constData(), bytes.size());
+        break;
+      }
+
+      writer.appendTextString(text.data(), qsizetype(text.size()));
+      break;
+    }
+
+    case TypedScalar::String:
+      writer.appendTextString(text.data(), qsizetype(text.size()));
+      break;
+    }
+
+    break;
+  }
+
+  case YAML::NodeType::Sequence:
+    writer.startArray(quint64(node.size()));
+
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      writeCbor(writer, *it, forJson);
+    }
+
+    writer.endArray();
+    break;
+
+  case YAML::NodeType::Map:
+    writer.startMap(quint64(node.size()));
+
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      writeCbor(writer, it->first, forJson);
+      writeCbor(writer, it->second, forJson);
+    }
+
+    writer.endMap();
+    break;
+
+  default:
+    writer.append(nullptr);
+    break;
+  }
+}
+
+} // end of namespace detail
+
+/*!
+   \brief Converts a whole node tree to a QCborValue in bulk.
+
+   QCborMap::insert() searches the map for the key first, so building a
+   large map one insert at a time is quadratic. This writes the tree as
+   CBOR, with every array and map length known up front, and lets
+   QCborValue::fromCbor() build it, which sizes each container once and
+   appends map entries without searching. The result is the same as
+   node.as<QCborValue>(), which is the better choice for small trees.
+*/
+inline QCborValue toCborValue(const YAML::Node& node)
+{
+  QYAML_PROBE("QYaml::toCborValue");
+
+  QByteArray data;
+
+  {
+    QCborStreamWriter writer(&data);
+    detail::writeCbor(writer, node, false);
+  }
+
+  QYAML_PROBE_BYTES(data.size());
+  return QCborValue::fromCbor(data);
+}
+
+/*!
+   \brief Converts a whole node tree to a QJsonValue in bulk, by way of
+   toCborValue(). Map keys that are not scalars are written as their CBOR
+   diagnostic text, where node.as<QJsonValue>() would fail.
+*/
+inline QJsonValue toJsonValue(const YAML::Node& node)
+{
+  QYAML_PROBE("QYaml::toJsonValue");
+
+  QByteArray data;
+
+  {
+    QCborStreamWriter writer(&data);
+    detail::writeCbor(writer, node, true);
+  }
+
+  return QCborValue::fromCbor(data).toJsonValue();
+}
+
+} // end of namespace QYaml
+
+namespace YAML {
+
+/*
+   Structural conversion between nodes and the Qt JSON and CBOR types,
+   without going through text. Scalars are typed with the YAML 1.2 core
+   schema on the way in, and strings that look like another type are tagged
+   !!str on the way out, so types survive a round trip. !!binary scalars
+   become CBOR byte strings, while JSON keeps their base64 text.
+*/
+template<>
+struct convert<QJsonValue>
+{
+  static Node encode(const QJsonValue& rhs);
+  static bool decode(const Node& node, QJsonValue& rhs);
+};
+
+template<>
+struct convert<QJsonArray>
+{
+  static Node encode(const QJsonArray& rhs);
+  static bool decode(const Node& node, QJsonArray& rhs);
+};
+
+template<>
+struct convert<QJsonObject>
+{
+  static Node encode(const QJsonObject& rhs);
+  static bool decode(const Node& node, QJsonObject& rhs);
+};
+
+template<>
+struct convert<QCborValue>
+{
+  static Node encode(const QCborValue& rhs);
+  static bool decode(const Node& node, QCborValue& rhs);
+};
+
+template<>
+struct convert<QCborArray>
+{
+  static Node encode(const QCborArray& rhs);
+  static bool decode(const Node& node, QCborArray& rhs);
+};
+
+template<>
+struct convert<QCborMap>
+{
+  static Node encode(const QCborMap& rhs);
+  static bool decode(const Node& node, QCborMap& rhs);
+};
+
+} // end of namespace YAML
+
+#if !defined(QYAMLCPP_COMPILED_LIB)
+#include "json-inl.h"
+#endif
+
+#endif // QT_VERSION >= 5.12
+
+#endif // QYAML_JSON_H
@@ -0,0 +1,215 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_LAZY_H
+#define QYAML_LAZY_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <yaml-cpp/yaml.h>
+
+#include "instrument.h"
+#include "node.h"
+
+namespace QYaml {
+
+/*!
+   \brief A value that is only converted from its node when first used.
+
+   Decoding a QImage, QPixmap or large QByteArray means base64 decoding and
+   often decompressing it, which is wasted for values that are never looked
+   at. A Lazy<T> read from a document just keeps a handle to the node and
+   converts it the first time get() is called. The conversion runs once,
+   even when several threads call get() at the same time, and copies of a
+   Lazy share the result.
+
+   \code
+   struct Sprite {
+      QString name;
+      QYaml::Lazy<QImage> image;
+   };
+
+   sprite.image = node["image"].as<QYaml::Lazy<QImage>>();
+   ...
+   painter.drawImage(0, 0, sprite.image.get()); // decoded here
+   \endcode
+
+   A Lazy that has not been converted is written back out as its original
+   node, so loading and saving a document does not re-encode its images.
+   T must be default constructible. QPixmap can only be used on the GUI
+   thread, so use Lazy<QImage> for values that other threads may read.
+*/
+template<class T>
+class Lazy
+{
+public:
+  Lazy()
+    : d(std::make_shared<State>()) {
+    d->decoded.store(true, std::memory_order_release);
+  }
+
+  Lazy(const T& value)
+    : d(std::make_shared<State>()) {
+    d->value = value;
+    d->decoded.store(true, std::memory_order_release);
+  }
+
+  /*!
+     \brief Holds node, to be converted on first use.
+  */
+  explicit Lazy(const YAML::Node& node)
+    : d(std::make_shared<State>()) {
+    d->node.reset(node);
+  }
+
+  /*!
+     \brief The converted value, converting it first if needed. If the node
+     cannot be converted this is a default constructed T and isValid()
+     returns false.
+  */
+  const T& get() const {
+    if (!d->decoded.load(std::memory_order_acquire)) {
+      std::call_once(d->once, &State::decode, d.get());
+    }
+
+    return d->value;
+  }
+
+  const T& operator*() const { return get(); }
+  const T* operator->() const { return &get(); }
+
+  /*!
+     \brief Replaces the value. The original node is no longer used, even
+     when writing.
+  */
+  void set(const T& value) { *this = Lazy(value); }
+
+  /*!
+     \brief True once the value has been converted, or if it was set
+     directly.
+  */
+  bool isDecoded() const { return d->decoded.load(std::memory_order_acquire); }
+
+  /*!
+     \brief False if the node could not be converted. Converts the value
+     if that has not happened yet.
+  */
+  bool isValid() const {
+    get();
+    return d->valid;
+  }
+
+  /*!
+     \brief The node the value is converted from, undefined if the value was
+     set directly.
+  */
+  YAML::Node node() const { return d->node; }
+
+  /*!
+     \brief Frees the converted value, which will be converted from the node
+     again when it is next used. Does nothing for a value that was set
+     directly. Copies made before this keep the value.
+  */
+  void discard() {
+    if (d->node.IsDefined() && isDecoded()) {
+      *this = Lazy(d->node);
+    }
+  }
+
+private:
+  struct State
+  {
+    State()
+      : node(YAML::NodeType::Undefined)
+      , value()
+      , valid(true)
+      , decoded(false) {}
+
+    void decode() {
+      QYAML_TYPED_PROBE("decode", Lazy<T>);
+
+      try {
+        valid = YAML::convert<T>::decode(node, value);
+      } catch (const YAML::Exception&) {
+        valid = false;
+      }
+
+      if (!valid) {
+        value = T();
+      }
+
+      decoded.store(true, std::memory_order_release);
+    }
+
+    std::once_flag once;
+    YAML::Node node;
+    T value;
+    bool valid;
+    std::atomic<bool> decoded;
+  };
+
+  std::shared_ptr<State> d;
+};
+
+} // end of namespace QYaml
+
+namespace YAML {
+
+template<class T>
+struct convert<QYaml::Lazy<T>>
+{
+  // an unconverted value is written as a copy of its original node.
+  static Node encode(const QYaml::Lazy<T>& rhs) {
+    const Node original = rhs.node();
+
+    if (original.IsDefined()) {
+      return Clone(original);
+    }
+
+    return convert<T>::encode(rhs.get());
+  }
+
+  static bool decode(const Node& node, QYaml::Lazy<T>& rhs) {
+    rhs = QYaml::Lazy<T>(node);
+    return true;
+  }
+};
+
+template<class T>
+inline void operator>>(const Node& node, QYaml::Lazy<T>& q)
+{
+  q = node.as<QYaml::Lazy<T>>();
+}
+
+template<class T>
+inline Emitter& operator<<(Emitter& emitter, const QYaml::Lazy<T>& v)
+{
+  return emitter << convert<QYaml::Lazy<T>>::encode(v);
+}
+
+} // end of namespace YAML
+
+#endif // QYAML_LAZY_H
@@ -0,0 +1,504 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_MULTIDOC_H
+#define QYAML_MULTIDOC_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QRunnable>
+#include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "instrument.h"
+#include "streambuf.h"
+
+namespace QYaml {
+
+/*!
+   \brief The byte range of one document in a multi document stream,
+   including its directives and markers.
+*/
+struct DocumentRange
+{
+  std::size_t offset;
+  std::size_t length;
+};
+
+/*
+   Document boundaries are found from the line structure alone. YAML does not
+   allow a "---" or "..." marker at the start of a line inside a block or
+   quoted scalar, it always ends the scalar, so a line scan finds the same
+   boundaries as the parser does without tokenising anything.
+*/
+namespace detail {
+
+inline const char* nextLine(const char* line, const char* end)
+{
+  const void* newline = std::memchr(line, '\n', std::size_t(end - line));
+  return newline ? static_cast<const char*>(newline) + 1 : end;
+}
+
+inline const char* previousLine(const char* data, const char* line)
+{
+  const char* p = line - 1; // the '\n' ending the previous line
+
+  while (p > data && p[-1] != '\n') {
+    --p;
+  }
+
+  return p;
+}
+
+inline bool isMarker(const char* line, const char* end, char c)
+{
+  if (end - line < 3 || line[0] != c || line[1] != c || line[2] != c) {
+    return false;
+  }
+
+  return end - line == 3 || line[3] == ' ' || line[3] == '\t' || line[3] == '\r' ||
+         line[3] == '\n';
+}
+
+inline bool isBlankOrComment(const char* line, const char* end)
+{
+  while (line < end && (*line == ' ' || *line == '\t')) {
+    ++line;
+  }
+
+  return line == end || *line == '\n' || *line == '\r' || *line == '#';
+}
+
+inline bool isDirective(const char* line, const char* end)
+{
+  return line < end && *line == '%';
+}
+
+// Directives belong to the document after them, so a "---" preceded by
+// directives starts at the first of them. yaml-cpp reads any "%" line at
+// column 0 as a directive, even without a "..." before it, and so does this.
+inline const char* documentStart(const char* data, const char* end, const char* marker)
+{
+  const char* directive = nullptr;
+  const char* line = marker;
+
+  while (line > data) {
+    line = previousLine(data, line);
+
+    if (isDirective(line, end)) {
+      directive = line;
+    } else if (!isBlankOrComment(line, end)) {
+      break;
+    }
+  }
+
+  return directive ? directive : marker;
+}
+
+// true if [begin, end) holds a document rather than only comments,
+// directives and end markers.
+inline bool containsDocument(const char* begin, const char* end)
+{
+  for (const char* line = begin; line < end; line = nextLine(line, end)) {
+    if (!isBlankOrComment(line, end) && !isDirective(line, end) &&
+        !isMarker(line, end, '.')) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*
+   yaml-cpp keeps the directives of the previous document for a document that
+   declares none of its own, so a document cut out of the stream needs the
+   last directive block before it to parse as it does in place. Offsets must
+   be passed in increasing order, the stream is scanned once.
+*/
+class DirectiveTracker
+{
+public:
+  DirectiveTracker(const char* data, std::size_t size)
+    : m_data(data)
+    , m_end(data + size)
+    , m_line(data)
+    , m_pendingStart(nullptr)
+    , m_pendingEnd(nullptr)
+    , m_blockStart(nullptr)
+    , m_blockEnd(nullptr) {}
+
+  /*
+     The directive block a document starting at offset inherits, empty if
+     the document has directives of its own or none came before it.
+  */
+  DocumentRange inherited(std::size_t offset) {
+    const char* const start = m_data + offset;
+
+    for (; m_line < start; m_line = nextLine(m_line, m_end)) {
+      if (isDirective(m_line, m_end)) {
+        if (!m_pendingStart) {
+          m_pendingStart = m_line;
+        }
+
+        m_pendingEnd = nextLine(m_line, m_end);
+
+      } else if (m_pendingStart && !isBlankOrComment(m_line, m_end)) {
+        m_blockStart = m_pendingStart;
+        m_blockEnd = m_pendingEnd;
+        m_pendingStart = nullptr;
+      }
+    }
+
+    DocumentRange range;
+    range.offset = m_blockStart ? std::size_t(m_blockStart - m_data) : 0;
+    range.length = m_blockStart ? std::size_t(m_blockEnd - m_blockStart) : 0;
+
+    for (const char* line = start; line < m_end; line = nextLine(line, m_end)) {
+      if (isDirective(line, m_end)) {
+        range.length = 0;
+        break;
+      }
+
+      if (!isBlankOrComment(line, m_end)) {
+        break;
+      }
+    }
+
+    return range;
+  }
+
+private:
+  const char* m_data;
+  const char* m_end;
+  const char* m_line;
+  const char* m_pendingStart;
+  const char* m_pendingEnd;
+  const char* m_blockStart;
+  const char* m_blockEnd;
+};
+
+} // end of namespace detail
+
+/*!
+   \brief The offset of the first document that starts at or after from,
+   or size if there is none. A document starts at its directives, its "---"
+   marker, or the line after the "..." that ended the one before.
+*/
+inline std::size_t nextDocumentStart(const char* data, std::size_t size, std::size_t from)
+{
+  const char* const end = data + size;
+
+  if (from >= size) {
+    return size;
+  }
+
+  const char* line = data + from;
+
+  if (from > 0 && line[-1] != '\n') {
+    line = detail::nextLine(line, end);
+  }
+
+  for (; line < end; line = detail::nextLine(line, end)) {
+    if (detail::isMarker(line, end, '-')) {
+      const char* start = detail::documentStart(data, end, line);
+
+      // directives before from belong to a document that started earlier.
+      if (start >= data + from) {
+        return std::size_t(start - data);
+      }
+
+    } else if (detail::isMarker(line, end, '.')) {
+      const char* next = detail::nextLine(line, end);
+
+      // yaml-cpp reads a stream starting with "..." as an empty document.
+      if (next < end && !detail::isMarker(next, end, '.')) {
+        return std::size_t(next - data);
+      }
+    }
+  }
+
+  return size;
+}
+
+/*!
+   \brief Splits a multi document stream into its documents without parsing
+   them.
+*/
+inline QVector<DocumentRange> documentRanges(const char* data, std::size_t size)
+{
+  QVector<DocumentRange> ranges;
+  std::size_t begin = 0;
+
+  while (begin < size) {
+    std::size_t next = nextDocumentStart(data, size, begin + 1);
+
+    if (detail::containsDocument(data + begin, data + next)) {
+      DocumentRange range;
+      range.offset = begin;
+      range.length = next - begin;
+      ranges.append(range);
+    }
+
+    begin = next;
+  }
+
+  return ranges;
+}
+
+inline QVector<DocumentRange> documentRanges(const QByteArray& data)
+{
+  return documentRanges(data.constData(), std::size_t(data.size()));
+}
+
+namespace detail {
+
+class LoadAllTask : public QRunnable
+{
+public:
+  LoadAllTask(const char* data,
+              std::size_t size,
+              std::vector<YAML::Node>& documents,
+              std::exception_ptr& error)
+    : m_data(data)
+    , m_size(size)
+    , m_documents(documents)
+    , m_error(error) {}
+
+  void run() override {
+    try {
+      ByteArrayStreamBuf buffer(m_data, m_size);
+      std::istream stream(&buffer);
+      m_documents = YAML::LoadAll(stream);
+    } catch (...) {
+      m_error = std::current_exception();
+    }
+  }
+
+private:
+  const char* m_data;
+  std::size_t m_size;
+  std::vector<YAML::Node>& m_documents;
+  std::exception_ptr& m_error;
+};
+
+/*
+   Rethrows error, with a parser error's mark moved by pos bytes and lines
+   lines.
+*/
+inline void rethrowMoved(const std::exception_ptr& error, qint64 pos, qint64 lines)
+{
+  try {
+    std::rethrow_exception(error);
+  } catch (const YAML::ParserException& e) {
+    if ((pos == 0 && lines == 0) || e.mark.is_null()) {
+      throw;
+    }
+
+    YAML::Mark mark = e.mark;
+    mark.pos += int(pos);
+    mark.line += int(lines);
+    throw YAML::ParserException(mark, e.msg);
+  }
+}
+
+inline qint64 lineCount(const char* begin, const char* end)
+{
+  return qint64(std::count(begin, end, '\n'));
+}
+
+} // end of namespace detail
+
+/*!
+   \brief Loads every document in a multi document stream, parsing batches
+   of documents on several threads.
+
+   The text is cut at document boundaries into a few batches per thread and
+   each batch is parsed by its own yaml-cpp parser. A batch whose first
+   document inherits %TAG or %YAML directives from an earlier one is parsed
+   from a copy with those directives in front. The documents are returned in
+   stream order, exactly as YAML::LoadAll would return them.
+   threads defaults to QThread::idealThreadCount(). No batch is cut smaller
+   than minimumBatch bytes, so small inputs are parsed on the calling
+   thread.
+
+   \code
+   std::vector<YAML::Node> events = QYaml::loadAllParallel(log);
+   \endcode
+
+   @throws {@link ParserException} from the first malformed batch. Its
+   mark is the position in the whole stream, as from YAML::LoadAll.
+*/
+inline std::vector<YAML::Node> loadAllParallel(const char* data,
+                                               std::size_t size,
+                                               int threads = 0,
+                                               std::size_t minimumBatch = 256 * 1024)
+{
+  QYAML_PROBE("loadAllParallel");
+  QYAML_PROBE_BYTES(size);
+
+  if (threads <= 0) {
+    threads = QThread::idealThreadCount();
+  }
+
+  // a few batches per thread evens out documents of different sizes.
+  std::size_t batches = std::size_t(threads > 1 ? threads * 4 : 1);
+  batches = std::max<std::size_t>(
+    1, std::min(batches, size / std::max<std::size_t>(1, minimumBatch)));
+
+  std::vector<std::size_t> cuts;
+  cuts.push_back(0);
+
+  for (std::size_t i = 1; i < batches; ++i) {
+    const std::size_t cut = nextDocumentStart(data, size, size / batches * i);
+
+    if (cut > cuts.back() && cut < size) {
+      cuts.push_back(cut);
+    }
+  }
+
+  cuts.push_back(size);
+  const std::size_t count = cuts.size() - 1;
+  std::vector<std::vector<YAML::Node>> parts(count);
+  std::vector<std::exception_ptr> errors(count);
+
+  // batches that inherit directives, with those directives in front.
+  std::vector<std::string> copies(count);
+  std::vector<std::size_t> prefixes(count, 0);
+  detail::DirectiveTracker directives(data, size);
+
+  for (std::size_t i = 1; i < count; ++i) {
+    const DocumentRange inherited = directives.inherited(cuts[i]);
+    prefixes[i] = inherited.length;
+
+    if (inherited.length > 0) {
+      copies[i].reserve(inherited.length + cuts[i + 1] - cuts[i]);
+      copies[i].append(data + inherited.offset, inherited.length);
+      copies[i].append(data + cuts[i], cuts[i + 1] - cuts[i]);
+    }
+  }
+
+  if (count == 1) {
+    detail::LoadAllTask(data, size, parts[0], errors[0]).run();
+  } else {
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (copies[i].empty()) {
+        pool.start(new detail::LoadAllTask(
+          data + cuts[i], cuts[i + 1] - cuts[i], parts[i], errors[i]));
+      } else {
+        pool.start(new detail::LoadAllTask(
+          copies[i].data(), copies[i].size(), parts[i], errors[i]));
+      }
+    }
+
+    pool.waitForDone();
+  }
+
+  std::size_t total = 0;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    if (errors[i]) {
+      // the mark counts from the start of the directives in front, if any.
+      const char* const prefix = copies[i].data();
+      detail::rethrowMoved(errors[i],
+                           qint64(cuts[i]) - qint64(prefixes[i]),
+                           detail::lineCount(data, data + cuts[i]) -
+                             detail::lineCount(prefix, prefix + prefixes[i]));
+    }
+
+    total += parts[i].size();
+  }
+
+  // push_back copy constructs, assigning a YAML::Node would change the node.
+  std::vector<YAML::Node> documents;
+  documents.reserve(total);
+
+  for (const std::vector<YAML::Node>& part : parts) {
+    for (const YAML::Node& document : part) {
+      documents.push_back(document);
+    }
+  }
+
+  return documents;
+}
+
+inline std::vector<YAML::Node> loadAllParallel(const QByteArray& data,
+                                               int threads = 0,
+                                               std::size_t minimumBatch = 256 * 1024)
+{
+  return loadAllParallel(data.constData(), std::size_t(data.size()), threads, minimumBatch);
+}
+
+/*!
+   \brief As loadAllParallel(), reading from a memory mapped file. Returns
+   no documents if the file cannot be opened.
+*/
+inline std::vector<YAML::Node> loadAllFileParallel(const QString& fileName, int threads = 0)
+{
+  QFile file(fileName);
+
+  if (!file.open(QIODevice::ReadOnly)) {
+    return std::vector<YAML::Node>();
+  }
+
+  const qint64 size = file.size();
+
+  if (size == 0) {
+    return std::vector<YAML::Node>();
+  }
+
+  uchar* mapped = file.map(0, size);
+
+  if (!mapped) {
+    return loadAllParallel(file.readAll(), threads);
+  }
+
+  try {
+    std::vector<YAML::Node> documents =
+      loadAllParallel(reinterpret_cast<const char*>(mapped), std::size_t(size), threads);
+    file.unmap(mapped);
+    return documents;
+  } catch (...) {
+    file.unmap(mapped);
+    throw;
+  }
+}
+
+} // end of namespace QYaml
+
+#endif // QYAML_MULTIDOC_H
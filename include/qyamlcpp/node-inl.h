@@ -0,0 +1,1431 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_NODE_INL_H
+#define QYAML_NODE_INL_H
+
+#include "node.h"
+
+namespace YAML {
+
+/* = QString
+   =========================================================================================*/
+QYAMLCPP_INLINE Node convert<QString>::encode(const QString& rhs)
+{
+   QYAML_PROBE("QString::encode");
+
+   Node node;
+   node = rhs.toStdString();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QString>::decode(const Node& node, QString& rhs)
+{
+   QYAML_PROBE("QString::decode");
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   rhs = QYaml::internedString(node.Scalar());
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QString& q)
+{
+   std::string sstr;
+   sstr = node.as<std::string>();
+   q = QYaml::internedString(sstr);
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QString& q)
+{
+   std::string sstr = q.toStdString();
+   node = sstr;
+}
+
+/* = QByteArray
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QByteArray>::encode(const QByteArray& rhs)
+{
+   QYAML_PROBE("QByteArray::encode");
+   QYAML_PROBE_BYTES(rhs.size());
+
+   Node node;
+   const char* data = rhs.constData();
+   YAML::Binary binary(reinterpret_cast<const unsigned char*>(data),
+                       size_t(rhs.size()));
+   node = binary;
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QByteArray>::decode(const Node& node, QByteArray& rhs)
+{
+   QYAML_PROBE("QByteArray::decode");
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   // decodes straight into rhs rather than via a YAML::Binary copy.
+   const std::string& scalar = node.Scalar();
+   QYAML_PROBE_BYTES(scalar.size());
+
+   return QYaml::Scalar::decodeBase64(scalar.data(), scalar.size(), rhs);
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QByteArray& q)
+{
+   q = node.as<QByteArray>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QByteArray& q)
+{
+   const char* data = q.constData();
+   YAML::Binary binary(reinterpret_cast<const unsigned char*>(data),
+                       size_t(q.size()));
+   node = binary;
+}
+
+/* = QBuffer
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QBuffer>::encode(const QBuffer& rhs)
+{
+   QYAML_PROBE("QBuffer::encode");
+
+   Node node;
+   QByteArray data = rhs.buffer();
+   node = data;
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QBuffer>::decode(const Node& node, QBuffer& rhs)
+{
+   QYAML_PROBE("QBuffer::decode");
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   QByteArray array;
+
+   if (!convert<QByteArray>::decode(node, array)) {
+      return false;
+   }
+
+   // setData() shares the decoded bytes, setBuffer() would keep a
+   // pointer to the local array.
+   rhs.setData(array);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QBuffer& q)
+{
+   q.setData(node.as<QByteArray>());
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QBuffer& q)
+{
+   QByteArray data = q.buffer();
+   node = data;
+}
+
+/* = QColor
+   ==========================================================================================*/
+QYAMLCPP_INLINE Node convert<QColor>::encode(const QColor& rhs)
+{
+   QYAML_PROBE("QColor::encode");
+
+   Node node;
+   node["red"] = rhs.red();
+   node["green"] = rhs.green();
+   node["blue"] = rhs.blue();
+   node["alpha"] = rhs.alpha();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QColor>::decode(const Node& node, QColor& rhs)
+{
+   QYAML_PROBE("QColor::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   int red = node["red"].as<int>();
+   int green = node["green"].as<int>();
+   int blue = node["blue"].as<int>();
+   int alpha = node["alpha"].as<int>();
+   rhs = QColor(red, green, blue, alpha);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QColor& q)
+{
+   int red = node["red"].as<int>();
+   int green = node["green"].as<int>();
+   int blue = node["blue"].as<int>();
+   int alpha = node["alpha"].as<int>();
+   q = QColor(red, green, blue, alpha);
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QColor& q)
+{
+   node["red"] = q.red();
+   node["green"] = q.green();
+   node["blue"] = q.blue();
+   node["alpha"] = q.alpha();
+}
+
+/* = QFont
+   ===========================================================================================*/
+QYAMLCPP_INLINE Node convert<QFont>::encode(const QFont& rhs)
+{
+   QYAML_PROBE("QFont::encode");
+
+   Node node;
+   node["family"] = rhs.family();
+   node["bold"] = rhs.bold();
+   node["capitalization"] = int(rhs.capitalization());
+   node["fixedpitch"] = rhs.fixedPitch();
+   node["hinting preference"] = int(rhs.hintingPreference());
+   node["italic"] = rhs.italic();
+   node["kerning"] = rhs.kerning();
+   node["letter spacing"] = rhs.letterSpacing();
+   node["letter spacing type"] = int(rhs.letterSpacingType());
+   node["overline"] = rhs.overline();
+   // not recommended to use pixelSize()
+   node["point size"] = rhs.pointSize();
+   node["stretch"] = rhs.stretch();
+   node["strikeout"] = rhs.strikeOut();
+   node["style"] = int(rhs.style());
+   node["style hint"] = int(rhs.styleHint());
+   node["style name"] = rhs.styleName();
+   node["style strategy"] = int(rhs.styleStrategy());
+   node["underline"] = rhs.underline();
+   node["weight"] = int(rhs.weight());
+   node["word spacing"] = rhs.wordSpacing();
+
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QFont>::decode(const Node& node, QFont& rhs)
+{
+   QYAML_PROBE("QFont::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   QFont font;
+   rhs.setFamily(node["family"].as<QString>());
+   rhs.setBold(node["bold"].as<bool>());
+   rhs.setCapitalization(
+      QFont::Capitalization(node["capitalization"].as<int>()));
+   rhs.setFixedPitch(node["fixedpitch"].as<bool>());
+   rhs.setHintingPreference(
+      QFont::HintingPreference(node["hinting preference"].as<int>()));
+   rhs.setItalic(node["italic"].as<bool>());
+   rhs.setKerning(node["kerning"].as<bool>());
+   rhs.setLetterSpacing(
+      QFont::SpacingType(node["letter spacing type"].as<int>()),
+      node["letter spacing"].as<double>());
+   rhs.setOverline(node["overline"].as<bool>());
+   // not recommended to use pixelSize()
+   rhs.setPointSize(node["point size"].as<int>());
+   rhs.setStretch(node["stretch"].as<int>());
+   rhs.setStrikeOut(node["strikeout"].as<bool>());
+   rhs.setStyle(QFont::Style(node["style"].as<int>()));
+   rhs.setStyleHint(QFont::StyleHint(node["style hint"].as<int>()));
+   rhs.setStyleName(node["style name"].as<QString>());
+   rhs.setStyleStrategy(
+      QFont::StyleStrategy(node["style strategy"].as<int>()));
+   rhs.setUnderline(node["underline"].as<bool>());
+   rhs.setWeight(QFont::Weight(node["weight"].as<int>()));
+   rhs.setWordSpacing(node["word spacing"].as<int>());
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QFont& q)
+{
+   q.setFamily(node["family"].as<QString>());
+   q.setBold(node["bold"].as<bool>());
+   q.setCapitalization(QFont::Capitalization(node["capitalization"].as<int>()));
+   q.setFixedPitch(node["fixedpitch"].as<bool>());
+   q.setHintingPreference(
+      QFont::HintingPreference(node["hinting preference"].as<int>()));
+   q.setItalic(node["italic"].as<bool>());
+   q.setKerning(node["kerning"].as<bool>());
+   q.setLetterSpacing(QFont::SpacingType(node["letter spacing type"].as<int>()),
+                      node["letter spacing"].as<double>());
+   q.setOverline(node["overline"].as<bool>());
+   // not recommended to use pixelSize()
+   q.setPointSize(node["point size"].as<int>());
+   q.setStretch(node["stretch"].as<int>());
+   q.setStrikeOut(node["strikeout"].as<bool>());
+   q.setStyle(QFont::Style(node["style"].as<int>()));
+   q.setStyleHint(QFont::StyleHint(node["style hint"].as<int>()));
+   q.setStyleName(node["style name"].as<QString>());
+   q.setStyleStrategy(QFont::StyleStrategy(node["style strategy"].as<int>()));
+   q.setUnderline(node["underline"].as<bool>());
+   q.setWeight(QFont::Weight(node["weight"].as<int>()));
+   q.setWordSpacing(node["word spacing"].as<int>());
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QFont& q)
+{
+   node["family"] = q.family();
+   node["bold"] = q.bold();
+   node["capitalization"] = int(q.capitalization());
+   node["fixedpitch"] = q.fixedPitch();
+   node["hinting preference"] = int(q.hintingPreference());
+   node["italic"] = q.italic();
+   node["kerning"] = q.kerning();
+   node["letter spacing"] = q.letterSpacing();
+   node["letter spacing type"] = int(q.letterSpacingType());
+   node["overline"] = q.overline();
+   // not recommended to use pixelSize()
+   node["point size"] = q.pointSize();
+   node["stretch"] = q.stretch();
+   node["strikeout"] = q.strikeOut();
+   node["style"] = int(q.style());
+   node["style hint"] = int(q.styleHint());
+   node["style name"] = q.styleName();
+   node["style strategy"] = int(q.styleStrategy());
+   node["underline"] = q.underline();
+   node["weight"] = int(q.weight());
+   node["word spacing"] = q.wordSpacing();
+}
+
+/* = QPoint
+   =====================================================================================*/
+QYAMLCPP_INLINE Node convert<QPoint>::encode(const QPoint& rhs)
+{
+   QYAML_PROBE("QPoint::encode");
+
+   Node node;
+   node["x"] = rhs.x();
+   node["y"] = rhs.y();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QPoint>::decode(const Node& node, QPoint& rhs)
+{
+   QYAML_PROBE("QPoint::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   int x = node["x"].as<int>();
+   int y = node["y"].as<int>();
+   rhs = QPoint(x, y);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QPoint& q)
+{
+   int x = node["x"].as<int>();
+   int y = node["y"].as<int>();
+   q = QPoint(x, y);
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QPoint& q)
+{
+   node["x"] = q.x();
+   node["y"] = q.y();
+}
+
+/* = QPointF
+   =====================================================================================*/
+QYAMLCPP_INLINE Node convert<QPointF>::encode(const QPointF& rhs)
+{
+   QYAML_PROBE("QPointF::encode");
+
+   Node node;
+   node["x"] = rhs.x();
+   node["y"] = rhs.y();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QPointF>::decode(const Node& node, QPointF& rhs)
+{
+   QYAML_PROBE("QPointF::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   qreal x = node["x"].as<qreal>();
+   qreal y = node["y"].as<qreal>();
+   rhs = QPointF(x, y);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node& node, QPointF& q)
+{
+   qreal x = node["x"].as<qreal>();
+   qreal y = node["y"].as<qreal>();
+   q = QPointF(x, y);
+}
+
+QYAMLCPP_INLINE void operator<<(Node& node, const QPointF& q)
+{
+   node["x"] = q.x();
+   node["y"] = q.y();
+}
+
+/* = QRect
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QRect>::encode(const QRect& rhs)
+{
+   QYAML_PROBE("QRect::encode");
+
+   Node node;
+   node["left"] = rhs.left();
+   node["top"] = rhs.top();
+   node["width"] = rhs.width();
+   node["height"] = rhs.height();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QRect>::decode(const Node& node, QRect& rhs)
+{
+   QYAML_PROBE("QRect::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   int left = node["left"].as<int>();
+   int top = node["top"].as<int>();
+   int width = node["width"].as<int>();
+   int height = node["height"].as<int>();
+   rhs = QRect(left, top, width, height);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QRect& q)
+{
+   int left = node["left"].as<int>();
+   int top = node["top"].as<int>();
+   int width = node["width"].as<int>();
+   int height = node["height"].as<int>();
+   q = QRect(left, top, width, height);
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QRect& q)
+{
+   node["left"] = q.left();
+   node["top"] = q.top();
+   node["width"] = q.width();
+   node["height"] = q.height();
+}
+
+/* = QRectF
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QRectF>::encode(const QRectF& rhs)
+{
+   QYAML_PROBE("QRectF::encode");
+
+   Node node;
+   node["left"] = rhs.left();
+   node["top"] = rhs.top();
+   node["width"] = rhs.width();
+   node["height"] = rhs.height();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QRectF>::decode(const Node& node, QRectF& rhs)
+{
+   QYAML_PROBE("QRectF::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   qreal left = node["left"].as<qreal>();
+   qreal top = node["top"].as<qreal>();
+   qreal width = node["width"].as<qreal>();
+   qreal height = node["height"].as<qreal>();
+   rhs = QRectF(left, top, width, height);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QRectF& q)
+{
+   qreal left = node["left"].as<qreal>();
+   qreal top = node["top"].as<qreal>();
+   qreal width = node["width"].as<qreal>();
+   qreal height = node["height"].as<qreal>();
+   q = QRectF(left, top, width, height);
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QRectF& q)
+{
+   node["left"] = q.left();
+   node["top"] = q.top();
+   node["width"] = q.width();
+   node["height"] = q.height();
+}
+
+/* = QSize
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QSize>::encode(const QSize& rhs)
+{
+   QYAML_PROBE("QSize::encode");
+
+   Node node;
+   node["width"] = rhs.width();
+   node["height"] = rhs.height();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QSize>::decode(const Node& node, QSize& rhs)
+{
+   QYAML_PROBE("QSize::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   int width = node["width"].as<int>();
+   int height = node["height"].as<int>();
+   rhs = QSize(width, height);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QSize& q)
+{
+   int width = node["width"].as<int>();
+   int height = node["height"].as<int>();
+   q = QSize(width, height);
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QSize& q)
+{
+   node["width"] = q.width();
+   node["height"] = q.height();
+}
+
+/* = QSizeF
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QSizeF>::encode(const QSizeF& rhs)
+{
+   QYAML_PROBE("QSizeF::encode");
+
+   Node node;
+   node["width"] = rhs.width();
+   node["height"] = rhs.height();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QSizeF>::decode(const Node& node, QSizeF& rhs)
+{
+   QYAML_PROBE("QSizeF::decode");
+
+   if (!node.IsMap()) {
+      return false;
+   }
+
+   qreal width = node["width"].as<qreal>();
+   qreal height = node["height"].as<qreal>();
+   rhs = QSizeF(width, height);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QSizeF& q)
+{
+   qreal width = node["width"].as<qreal>();
+   qreal height = node["height"].as<qreal>();
+   q = QSizeF(width, height);
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QSizeF& q)
+{
+   node["width"] = q.width();
+   node["height"] = q.height();
+}
+
+/* = QLine
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QLine>::encode(const QLine& rhs)
+{
+   QYAML_PROBE("QLine::encode");
+
+   const int values[] = { rhs.x1(), rhs.y1(), rhs.x2(), rhs.y2() };
+   return QYaml::Packed::sequence(values, 4);
+}
+
+QYAMLCPP_INLINE bool convert<QLine>::decode(const Node& node, QLine& rhs)
+{
+   QYAML_PROBE("QLine::decode");
+
+   int values[4];
+
+   if (!QYaml::Packed::read(node, values, 4)) {
+      return false;
+   }
+
+   rhs = QLine(values[0], values[1], values[2], values[3]);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QLine& q)
+{
+   q = node.as<QLine>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QLine& q)
+{
+   node = convert<QLine>::encode(q);
+}
+
+/* = QLineF
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QLineF>::encode(const QLineF& rhs)
+{
+   QYAML_PROBE("QLineF::encode");
+
+   const qreal values[] = { rhs.x1(), rhs.y1(), rhs.x2(), rhs.y2() };
+   return QYaml::Packed::sequence(values, 4);
+}
+
+QYAMLCPP_INLINE bool convert<QLineF>::decode(const Node& node, QLineF& rhs)
+{
+   QYAML_PROBE("QLineF::decode");
+
+   qreal values[4];
+
+   if (!QYaml::Packed::read(node, values, 4)) {
+      return false;
+   }
+
+   rhs = QLineF(values[0], values[1], values[2], values[3]);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QLineF& q)
+{
+   q = node.as<QLineF>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QLineF& q)
+{
+   node = convert<QLineF>::encode(q);
+}
+
+/* = QPolygon
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QPolygon>::encode(const QPolygon& rhs)
+{
+   QYAML_PROBE("QPolygon::encode");
+
+   Node node = QYaml::Packed::sequence();
+
+   for (const QPoint& point : rhs) {
+      QYaml::Packed::append(node, point.x());
+      QYaml::Packed::append(node, point.y());
+   }
+
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QPolygon>::decode(const Node& node, QPolygon& rhs)
+{
+   QYAML_PROBE("QPolygon::decode");
+
+   if (!node.IsSequence()) {
+      return false;
+   }
+
+   const_iterator it = node.begin();
+
+   // the map per point form written for QVector<QPoint>.
+   if (it != node.end() && it->IsMap()) {
+      rhs.clear();
+      rhs.reserve(int(node.size()));
+
+      for (; it != node.end(); ++it) {
+         rhs.append(it->as<QPoint>());
+      }
+
+      return true;
+   }
+
+   const std::size_t size = node.size();
+
+   if (size % 2 != 0) {
+      return false;
+   }
+
+   // filled in place, so there is a single allocation for the points.
+   rhs.resize(int(size / 2));
+   QPoint* point = rhs.data();
+
+   while (it != node.end()) {
+      int x;
+      int y;
+
+      if (!QYaml::Packed::read(*it++, x) || !QYaml::Packed::read(*it++, y)) {
+         return false;
+      }
+
+      *point++ = QPoint(x, y);
+   }
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QPolygon& q)
+{
+   q = node.as<QPolygon>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QPolygon& q)
+{
+   node = convert<QPolygon>::encode(q);
+}
+
+/* = QPolygonF
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QPolygonF>::encode(const QPolygonF& rhs)
+{
+   QYAML_PROBE("QPolygonF::encode");
+
+   Node node = QYaml::Packed::sequence();
+
+   for (const QPointF& point : rhs) {
+      QYaml::Packed::append(node, point.x());
+      QYaml::Packed::append(node, point.y());
+   }
+
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QPolygonF>::decode(const Node& node, QPolygonF& rhs)
+{
+   QYAML_PROBE("QPolygonF::decode");
+
+   if (!node.IsSequence()) {
+      return false;
+   }
+
+   const_iterator it = node.begin();
+
+   // the map per point form written for QVector<QPointF>.
+   if (it != node.end() && it->IsMap()) {
+      rhs.clear();
+      rhs.reserve(int(node.size()));
+
+      for (; it != node.end(); ++it) {
+         rhs.append(it->as<QPointF>());
+      }
+
+      return true;
+   }
+
+   const std::size_t size = node.size();
+
+   if (size % 2 != 0) {
+      return false;
+   }
+
+   // filled in place, so there is a single allocation for the points.
+   rhs.resize(int(size / 2));
+   QPointF* point = rhs.data();
+
+   while (it != node.end()) {
+      qreal x;
+      qreal y;
+
+      if (!QYaml::Packed::read(*it++, x) || !QYaml::Packed::read(*it++, y)) {
+         return false;
+      }
+
+      *point++ = QPointF(x, y);
+   }
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QPolygonF& q)
+{
+   q = node.as<QPolygonF>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QPolygonF& q)
+{
+   node = convert<QPolygonF>::encode(q);
+}
+
+/* = QTransform
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QTransform>::encode(const QTransform& rhs)
+{
+   QYAML_PROBE("QTransform::encode");
+
+   const qreal values[] = { rhs.m11(), rhs.m12(), rhs.m13(), rhs.m21(), rhs.m22(),
+                            rhs.m23(), rhs.m31(), rhs.m32(), rhs.m33() };
+   return QYaml::Packed::sequence(values, 9);
+}
+
+QYAMLCPP_INLINE bool convert<QTransform>::decode(const Node& node, QTransform& rhs)
+{
+   QYAML_PROBE("QTransform::decode");
+
+   qreal m[9];
+
+   if (!QYaml::Packed::read(node, m, 9)) {
+      return false;
+   }
+
+   rhs = QTransform(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QTransform& q)
+{
+   q = node.as<QTransform>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QTransform& q)
+{
+   node = convert<QTransform>::encode(q);
+}
+
+/* = QMatrix4x4
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QMatrix4x4>::encode(const QMatrix4x4& rhs)
+{
+   QYAML_PROBE("QMatrix4x4::encode");
+
+   // copyDataTo() gives row order, data() would give column order.
+   float values[16];
+   rhs.copyDataTo(values);
+   return QYaml::Packed::sequence(values, 16);
+}
+
+QYAMLCPP_INLINE bool convert<QMatrix4x4>::decode(const Node& node, QMatrix4x4& rhs)
+{
+   QYAML_PROBE("QMatrix4x4::decode");
+
+   float values[16];
+
+   if (!QYaml::Packed::read(node, values, 16)) {
+      return false;
+   }
+
+   rhs = QMatrix4x4(values);
+
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QMatrix4x4& q)
+{
+   q = node.as<QMatrix4x4>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QMatrix4x4& q)
+{
+   node = convert<QMatrix4x4>::encode(q);
+}
+
+/* = QPixmap
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QPixmap>::encode(const QPixmap& rhs)
+{
+   QYAML_PROBE("QPixmap::encode");
+
+   Node node;
+   QByteArray array;
+   QBuffer buffer(&array);
+   buffer.open(QIODevice::WriteOnly);
+   rhs.save(&buffer, "PNG");
+   QYAML_PROBE_BYTES(array.size());
+
+   node = array;
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QPixmap>::decode(const Node& node, QPixmap& rhs)
+{
+   QYAML_PROBE("QPixmap::decode");
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   // decodes line wrapped !!binary blocks in the same pass.
+   const std::string& scalar = node.Scalar();
+   QYAML_PROBE_BYTES(scalar.size());
+
+   QByteArray array;
+
+   if (!QYaml::Scalar::decodeBase64(scalar.data(), scalar.size(), array)) {
+      return false;
+   }
+
+   QPixmap pixmap;
+
+   if (!pixmap.loadFromData(array)) {
+      return false;
+   }
+
+   rhs = pixmap;
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QPixmap& q)
+{
+   YAML::Binary binary = node.as<YAML::Binary>();
+   const char* data = reinterpret_cast<const char*>(binary.data());
+   int size = int(binary.size());
+   const QByteArray array(data, size);
+   QPixmap pixmap;
+   bool res = pixmap.loadFromData(array, "PNG");
+
+   if (res) {
+      q = pixmap;
+   }
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QPixmap& q)
+{
+   QByteArray array;
+   QBuffer buffer(&array);
+   buffer.open(QIODevice::WriteOnly);
+   q.save(&buffer, "PNG");
+   node = array;
+}
+
+/* = QImage
+   ======================================================================================*/
+QYAMLCPP_INLINE Node convert<QImage>::encode(const QImage& rhs)
+{
+   QYAML_PROBE("QImage::encode");
+
+   Node node;
+   QPixmap pixmap = QPixmap::fromImage(rhs);
+   QByteArray array;
+   QBuffer buffer(&array);
+   buffer.open(QIODevice::WriteOnly);
+   pixmap.save(&buffer, "PNG");
+   node = array;
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QImage>::decode(const Node& node, QImage& rhs)
+{
+   QYAML_PROBE("QImage::decode");
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   // QImage rather than QPixmap, so images can be decoded off the GUI thread.
+   const std::string& scalar = node.Scalar();
+   QYAML_PROBE_BYTES(scalar.size());
+
+   QByteArray array;
+
+   if (!QYaml::Scalar::decodeBase64(scalar.data(), scalar.size(), array)) {
+      return false;
+   }
+
+   QImage image;
+
+   if (!image.loadFromData(array)) {
+      return false;
+   }
+
+   rhs = image;
+   return true;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QImage& q)
+{
+  QPixmap pixmap = node.as<QPixmap>();
+  q = pixmap.toImage();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QImage& q)
+{
+  QPixmap pixmap = QPixmap::fromImage(q);
+  node = pixmap;
+}
+
+/* = QDateTime
+   ===============================================================================*/
+QYAMLCPP_INLINE Node convert<QDateTime>::encode(const QDateTime& rhs)
+{
+   QYAML_PROBE("QDateTime::encode");
+
+   if (!rhs.isValid()) {
+      return Node(NodeType::Null);
+   }
+
+   char buffer[QYaml::Iso8601::DateTimeLength];
+   const int length = QYaml::Iso8601::formatDateTime(rhs, buffer);
+   return Node(std::string(buffer, std::size_t(length)));
+}
+
+QYAMLCPP_INLINE bool convert<QDateTime>::decode(const Node& node, QDateTime& rhs)
+{
+   QYAML_PROBE("QDateTime::decode");
+
+   if (node.IsNull()) {
+      rhs = QDateTime();
+      return true;
+   }
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   const std::string& scalar = node.Scalar();
+
+   if (QYaml::Iso8601::parseDateTime(scalar.data(), scalar.size(), rhs)) {
+      return true;
+   }
+
+   rhs = QDateTime::fromString(QString::fromStdString(scalar), Qt::ISODate);
+   return rhs.isValid();
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QDateTime& q)
+{
+   q = node.as<QDateTime>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QDateTime& q)
+{
+   node = convert<QDateTime>::encode(q);
+}
+
+/* = QDate
+   ===================================================================================*/
+QYAMLCPP_INLINE Node convert<QDate>::encode(const QDate& rhs)
+{
+   QYAML_PROBE("QDate::encode");
+
+   if (!rhs.isValid()) {
+      return Node(NodeType::Null);
+   }
+
+   char buffer[QYaml::Iso8601::DateLength];
+   const int length = QYaml::Iso8601::formatDate(rhs, buffer);
+   return Node(std::string(buffer, std::size_t(length)));
+}
+
+QYAMLCPP_INLINE bool convert<QDate>::decode(const Node& node, QDate& rhs)
+{
+   QYAML_PROBE("QDate::decode");
+
+   if (node.IsNull()) {
+      rhs = QDate();
+      return true;
+   }
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   const std::string& scalar = node.Scalar();
+
+   if (QYaml::Iso8601::parseDate(scalar.data(), scalar.size(), rhs)) {
+      return true;
+   }
+
+   rhs = QDate::fromString(QString::fromStdString(scalar), Qt::ISODate);
+   return rhs.isValid();
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QDate& q)
+{
+   q = node.as<QDate>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QDate& q)
+{
+   node = convert<QDate>::encode(q);
+}
+
+/* = QTime
+   ===================================================================================*/
+QYAMLCPP_INLINE Node convert<QTime>::encode(const QTime& rhs)
+{
+   QYAML_PROBE("QTime::encode");
+
+   if (!rhs.isValid()) {
+      return Node(NodeType::Null);
+   }
+
+   char buffer[12];
+   const int length = QYaml::Iso8601::formatTime(rhs, buffer);
+   return Node(std::string(buffer, std::size_t(length)));
+}
+
+QYAMLCPP_INLINE bool convert<QTime>::decode(const Node& node, QTime& rhs)
+{
+   QYAML_PROBE("QTime::decode");
+
+   if (node.IsNull()) {
+      rhs = QTime();
+      return true;
+   }
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   const std::string& scalar = node.Scalar();
+
+   if (QYaml::Iso8601::parseTime(scalar.data(), scalar.size(), rhs)) {
+      return true;
+   }
+
+   rhs = QTime::fromString(QString::fromStdString(scalar), Qt::ISODate);
+   return rhs.isValid();
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QTime& q)
+{
+   q = node.as<QTime>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QTime& q)
+{
+   node = convert<QTime>::encode(q);
+}
+
+/* = QUuid
+   ===================================================================================*/
+QYAMLCPP_INLINE Node convert<QUuid>::encode(const QUuid& rhs)
+{
+   QYAML_PROBE("QUuid::encode");
+
+   // toByteArray() adds braces.
+   const QByteArray text = rhs.toByteArray();
+   return Node(std::string(text.constData() + 1, std::size_t(text.size() - 2)));
+}
+
+QYAMLCPP_INLINE bool convert<QUuid>::decode(const Node& node, QUuid& rhs)
+{
+   QYAML_PROBE("QUuid::decode");
+
+   if (node.IsNull()) {
+      rhs = QUuid();
+      return true;
+   }
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   // the braces are optional.
+   const std::string& scalar = node.Scalar();
+   rhs = QUuid(QByteArray::fromRawData(scalar.data(), int(scalar.size())));
+
+   return !rhs.isNull() ||
+          scalar.find_first_not_of("{}-0") == std::string::npos;
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QUuid& q)
+{
+   q = node.as<QUuid>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QUuid& q)
+{
+   node = convert<QUuid>::encode(q);
+}
+
+/* = QUrl
+   ====================================================================================*/
+QYAMLCPP_INLINE Node convert<QUrl>::encode(const QUrl& rhs)
+{
+   QYAML_PROBE("QUrl::encode");
+
+   Node node;
+   node = rhs.toString().toStdString();
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QUrl>::decode(const Node& node, QUrl& rhs)
+{
+   QYAML_PROBE("QUrl::decode");
+
+   if (node.IsNull()) {
+      rhs = QUrl();
+      return true;
+   }
+
+   if (!node.IsScalar()) {
+      return false;
+   }
+
+   const std::string& scalar = node.Scalar();
+   rhs = QUrl(QString::fromStdString(scalar));
+
+   return rhs.isValid() || scalar.empty();
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QUrl& q)
+{
+   q = node.as<QUrl>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QUrl& q)
+{
+   node = convert<QUrl>::encode(q);
+}
+
+/* = QVariant
+   =========================================================================================*/
+QYAMLCPP_INLINE Node convert<QVariant>::encode(const QVariant& rhs)
+{
+   QYAML_PROBE("QVariant::encode");
+
+   Node node;
+
+   switch (rhs.userType()) {
+   case QMetaType::UnknownType:
+      node = Node(NodeType::Null);
+      break;
+
+   case QMetaType::Bool:
+      node = rhs.toBool();
+      break;
+
+   case QMetaType::Int:
+   case QMetaType::Long:
+   case QMetaType::LongLong:
+      node = rhs.toLongLong();
+      break;
+
+   case QMetaType::UInt:
+   case QMetaType::ULong:
+   case QMetaType::ULongLong:
+      node = rhs.toULongLong();
+      break;
+
+   case QMetaType::Float:
+   case QMetaType::Double:
+      node = rhs.toDouble();
+      break;
+
+   case QMetaType::QByteArray:
+      node = rhs.toByteArray();
+      node.SetTag(binaryTag());
+      break;
+
+   case QMetaType::QColor:
+      node = rhs.value<QColor>();
+      node.SetTag(colorTag());
+      break;
+
+   case QMetaType::QFont:
+      node = rhs.value<QFont>();
+      node.SetTag(fontTag());
+      break;
+
+   case QMetaType::QDateTime:
+      node = rhs.toDateTime();
+      break;
+
+   case QMetaType::QDate:
+      node = rhs.toDate();
+      break;
+
+   case QMetaType::QTime:
+      node = rhs.toTime();
+      break;
+
+   case QMetaType::QUuid:
+      node = rhs.toUuid();
+      break;
+
+   case QMetaType::QUrl:
+      node = rhs.toUrl();
+      break;
+
+   case QMetaType::QLine:
+      node = rhs.toLine();
+      break;
+
+   case QMetaType::QLineF:
+      node = rhs.toLineF();
+      break;
+
+   case QMetaType::QPolygon:
+      node = rhs.value<QPolygon>();
+      break;
+
+   case QMetaType::QPolygonF:
+      node = rhs.value<QPolygonF>();
+      break;
+
+   case QMetaType::QTransform:
+      node = rhs.value<QTransform>();
+      break;
+
+   case QMetaType::QMatrix4x4:
+      node = rhs.value<QMatrix4x4>();
+      break;
+
+   case QMetaType::QStringList:
+   case QMetaType::QVariantList: {
+      node = Node(NodeType::Sequence);
+      const QVariantList list = rhs.toList();
+
+      for (const QVariant& item : list) {
+         node.push_back(encode(item));
+      }
+
+      break;
+   }
+
+   case QMetaType::QVariantMap:
+   case QMetaType::QVariantHash: {
+      node = Node(NodeType::Map);
+      const QVariantMap map = rhs.toMap();
+
+      for (QVariantMap::const_iterator it = map.constBegin();
+           it != map.constEnd(); ++it) {
+         node.force_insert(it.key().toStdString(), encode(it.value()));
+      }
+
+      break;
+   }
+
+   default:
+      node = rhs.toString().toStdString();
+      break;
+   }
+
+   return node;
+}
+
+QYAMLCPP_INLINE bool convert<QVariant>::decode(const Node& node, QVariant& rhs)
+{
+   QYAML_PROBE("QVariant::decode");
+
+   switch (node.Type()) {
+   case NodeType::Null:
+      rhs = QVariant();
+      return true;
+
+   case NodeType::Scalar: {
+      if (node.Tag() == binaryTag()) {
+         QByteArray array;
+
+         if (!convert<QByteArray>::decode(node, array)) {
+            return false;
+         }
+
+         rhs = array;
+         return true;
+      }
+
+      rhs = QYaml::internedString(node.Scalar());
+      return true;
+   }
+
+   case NodeType::Sequence: {
+      QVariantList list;
+      list.reserve(int(node.size()));
+
+      for (const_iterator it = node.begin(); it != node.end(); ++it) {
+         QVariant item;
+
+         if (!decode(*it, item)) {
+            return false;
+         }
+
+         list.append(item);
+      }
+
+      rhs = list;
+      return true;
+   }
+
+   case NodeType::Map: {
+      if (node.Tag() == colorTag() && isColor(node)) {
+         rhs = QVariant::fromValue(node.as<QColor>());
+         return true;
+      }
+
+      if (node.Tag() == fontTag() && isFont(node)) {
+         rhs = QVariant::fromValue(node.as<QFont>());
+         return true;
+      }
+
+      QVariantMap map;
+
+      for (const_iterator it = node.begin(); it != node.end(); ++it) {
+         QVariant item;
+
+         if (!it->first.IsScalar() || !decode(it->second, item)) {
+            return false;
+         }
+
+         map.insert(QYaml::internedString(it->first.Scalar()), item);
+      }
+
+      rhs = map;
+      return true;
+   }
+
+   default:
+      return false;
+   }
+}
+
+QYAMLCPP_INLINE void operator>>(const Node node, QVariant& q)
+{
+   q = node.as<QVariant>();
+}
+
+QYAMLCPP_INLINE void operator<<(Node node, const QVariant& q)
+{
+   node = convert<QVariant>::encode(q);
+}
+
+} // end of namespace YAML
+
+#endif // QYAML_NODE_INL_H
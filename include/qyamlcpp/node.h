@@ -28,11 +28,18 @@
 #include <QBuffer>
 #include <QByteArray>
 #include <QColor>
+#include <QDate>
+#include <QDateTime>
 #include <QFile>
 #include <QFont>
+#include <QLine>
+#include <QLineF>
+#include <QMatrix4x4>
 #include <QPixmap>
 #include <QPoint>
 #include <QPointF>
+#include <QPolygon>
+#include <QPolygonF>
 #include <QRect>
 #include <QRectF>
 #include <QSize>
@@ -40,130 +47,48 @@
 #include <QString>
 #include <QStringList>
 #include <QTextStream>
+#include <QTime>
+#include <QTransform>
+#include <QUrl>
+#include <QUuid>
+#include <QVariant>
 
+#include <initializer_list>
 #include <string>
 #include <yaml-cpp/yaml.h>
 
-namespace YAML {
-
-/* = QVariant
-   =========================================================================================*/
-template<>
-struct convert<QVariant>
-{
-   static Node encode(const QVariant& rhs) {
-      Node node;
-      node = rhs;
-      return node;
-   }
-
-   static bool decode(const Node& node, QVariant& rhs) {
-      if (!node.IsScalar()) {
-         return false;
-      }
-
-      //      std::string sstr = node
-      rhs = QVariant(node);
-
-      return true;
-   }
-};
-
-void operator>>(const Node node, QVariant& q)
-{
-   std::string sstr;
-   sstr = node.as<std::string>();
-   q = QString(sstr.c_str());
-}
-
-
-void operator<<(Node node, const QVariant& q)
-{
-   std::string sstr = q.toString().toStdString();
-   node = sstr;
-}
+#include "config.h"
+#include "instrument.h"
+#include "intern.h"
+#include "iso8601.h"
+#include "packed.h"
+#include "scalar.h"
 
+namespace YAML {
 
 /* = QString
    =========================================================================================*/
 template<>
 struct convert<QString>
 {
-   static Node encode(const QString& rhs) {
-      Node node;
-      node = rhs.toStdString();
-      return node;
-   }
-
-   static bool decode(const Node& node, QString& rhs) {
-      if (!node.IsScalar()) {
-         return false;
-      }
-
-      std::string sstr = node.as<std::string>();
-      rhs = QString(sstr.c_str());
-
-      return true;
-   }
+   static Node encode(const QString& rhs);
+   static bool decode(const Node& node, QString& rhs);
 };
 
-void operator>>(const Node node, QString& q)
-{
-   std::string sstr;
-   sstr = node.as<std::string>();
-   q = QString(sstr.c_str());
-}
-
-
-void operator<<(Node node, const QString& q)
-{
-   std::string sstr = q.toStdString();
-   node = sstr;
-}
+void operator>>(const Node node, QString& q);
+void operator<<(Node node, const QString& q);
 
 /* = QByteArray
    ======================================================================================*/
 template<>
 struct convert<QByteArray>
 {
-   static Node encode(const QByteArray& rhs) {
-      Node node;
-      const char* data = rhs.constData();
-      YAML::Binary binary(reinterpret_cast<const unsigned char*>(data),
-                          size_t(rhs.size()));
-      node = binary;
-      return node;
-   }
-
-   static bool decode(const Node& node, QByteArray& rhs) {
-      if (!node.IsScalar()) {
-         return false;
-      }
-
-      YAML::Binary binary = node.as<YAML::Binary>();
-      const char* data = reinterpret_cast<const char*>(binary.data());
-      int size = int(binary.size());
-      rhs = QByteArray(data, size);
-
-      return true;
-   }
+   static Node encode(const QByteArray& rhs);
+   static bool decode(const Node& node, QByteArray& rhs);
 };
 
-void operator>>(const Node node, QByteArray& q)
-{
-   YAML::Binary binary = node.as<YAML::Binary>();
-   const char* data = reinterpret_cast<const char*>(binary.data());
-   int size = int(binary.size());
-   q = QByteArray(data, size);
-}
-
-void operator<<(Node node, const QByteArray& q)
-{
-   const char* data = q.constData();
-   YAML::Binary binary(reinterpret_cast<const unsigned char*>(data),
-                       size_t(q.size()));
-   node = binary;
-}
+void operator>>(const Node node, QByteArray& q);
+void operator<<(Node node, const QByteArray& q);
 
 
 /* = QBuffer
@@ -171,37 +96,12 @@ void operator<<(Node node, const QByteArray& q)
 template<>
 struct convert<QBuffer>
 {
-   static Node encode(const QBuffer& rhs) {
-      Node node;
-      QByteArray data = rhs.buffer();
-      node = data;
-      return node;
-   }
-
-   static bool decode(const Node& node, QBuffer& rhs) {
-      if (!node.IsScalar()) {
-         return false;
-      }
-
-      QByteArray array = node.as<QByteArray>();
-      rhs.setBuffer(&array);
-
-      return true;
-   }
+   static Node encode(const QBuffer& rhs);
+   static bool decode(const Node& node, QBuffer& rhs);
 };
 
-void operator>>(const Node node, QBuffer& q)
-{
-   QByteArray array = node.as<QByteArray>();
-   q.setBuffer(&array);
-}
-
-
-void operator<<(Node node, const QBuffer& q)
-{
-   QByteArray data = q.buffer();
-   node = data;
-}
+void operator>>(const Node node, QBuffer& q);
+void operator<<(Node node, const QBuffer& q);
 
 
 /* = QColor
@@ -213,47 +113,12 @@ void operator<<(Node node, const QBuffer& q)
 template<>
 struct convert<QColor>
 {
-   static Node encode(const QColor& rhs) {
-      Node node;
-      node["red"] = rhs.red();
-      node["green"] = rhs.green();
-      node["blue"] = rhs.blue();
-      node["alpha"] = rhs.alpha();
-      return node;
-   }
-
-   static bool decode(const Node& node, QColor& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
-
-      int red = node["red"].as<int>();
-      int green = node["green"].as<int>();
-      int blue = node["blue"].as<int>();
-      int alpha = node["alpha"].as<int>();
-      rhs = QColor(red, green, blue, alpha);
-
-      return true;
-   }
+   static Node encode(const QColor& rhs);
+   static bool decode(const Node& node, QColor& rhs);
 };
 
-void operator>>(const Node node, QColor& q)
-{
-   int red = node["red"].as<int>();
-   int green = node["green"].as<int>();
-   int blue = node["blue"].as<int>();
-   int alpha = node["alpha"].as<int>();
-   q = QColor(red, green, blue, alpha);
-}
-
-void operator<<(Node node, const QColor& q)
-{
-   node["red"] = q.red();
-   node["green"] = q.green();
-   node["blue"] = q.blue();
-   node["alpha"] = q.alpha();
-}
-
+void operator>>(const Node node, QColor& q);
+void operator<<(Node node, const QColor& q);
 
 
 /* = QFont
@@ -265,118 +130,12 @@ void operator<<(Node node, const QColor& q)
 template<>
 struct convert<QFont>
 {
-   static Node encode(const QFont& rhs) {
-      Node node;
-      node["family"] = rhs.family();
-      node["bold"] = rhs.bold();
-      node["capitalization"] = int(rhs.capitalization());
-      node["fixedpitch"] = rhs.fixedPitch();
-      node["hinting preference"] = int(rhs.hintingPreference());
-      node["italic"] = rhs.italic();
-      node["kerning"] = rhs.kerning();
-      node["letter spacing"] = rhs.letterSpacing();
-      node["letter spacing type"] = int(rhs.letterSpacingType());
-      node["overline"] = rhs.overline();
-      // not recommended to use pixelSize()
-      node["point size"] = rhs.pointSize();
-      node["stretch"] = rhs.stretch();
-      node["strikeout"] = rhs.strikeOut();
-      node["style"] = int(rhs.style());
-      node["style hint"] = int(rhs.styleHint());
-      node["style name"] = rhs.styleName();
-      node["style strategy"] = int(rhs.styleStrategy());
-      node["underline"] = rhs.underline();
-      node["weight"] = int(rhs.weight());
-      node["word spacing"] = rhs.wordSpacing();
-
-      return node;
-   }
-
-   static bool decode(const Node& node, QFont& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
-
-      QFont font;
-      rhs.setFamily(node["family"].as<QString>());
-      rhs.setBold(node["bold"].as<bool>());
-      rhs.setCapitalization(
-         QFont::Capitalization(node["capitalization"].as<int>()));
-      rhs.setFixedPitch(node["fixedpitch"].as<bool>());
-      rhs.setHintingPreference(
-         QFont::HintingPreference(node["hinting preference"].as<int>()));
-      rhs.setItalic(node["italic"].as<bool>());
-      rhs.setKerning(node["kerning"].as<bool>());
-      rhs.setLetterSpacing(
-         QFont::SpacingType(node["letter spacing type"].as<int>()),
-         node["letter spacing"].as<double>());
-      rhs.setOverline(node["overline"].as<bool>());
-      // not recommended to use pixelSize()
-      rhs.setPointSize(node["point size"].as<int>());
-      rhs.setStretch(node["stretch"].as<int>());
-      rhs.setStrikeOut(node["strikeout"].as<bool>());
-      rhs.setStyle(QFont::Style(node["style"].as<int>()));
-      rhs.setStyleHint(QFont::StyleHint(node["style hint"].as<int>()));
-      rhs.setStyleName(node["style name"].as<QString>());
-      rhs.setStyleStrategy(
-         QFont::StyleStrategy(node["style strategy"].as<int>()));
-      rhs.setUnderline(node["underline"].as<bool>());
-      rhs.setWeight(QFont::Weight(node["weight"].as<int>()));
-      rhs.setWordSpacing(node["word spacing"].as<int>());
-
-      return true;
-   }
+   static Node encode(const QFont& rhs);
+   static bool decode(const Node& node, QFont& rhs);
 };
 
-void operator>>(const Node node, QFont& q)
-{
-   q.setFamily(node["family"].as<QString>());
-   q.setBold(node["bold"].as<bool>());
-   q.setCapitalization(QFont::Capitalization(node["capitalization"].as<int>()));
-   q.setFixedPitch(node["fixedpitch"].as<bool>());
-   q.setHintingPreference(
-      QFont::HintingPreference(node["hinting preference"].as<int>()));
-   q.setItalic(node["italic"].as<bool>());
-   q.setKerning(node["kerning"].as<bool>());
-   q.setLetterSpacing(QFont::SpacingType(node["letter spacing type"].as<int>()),
-                      node["letter spacing"].as<double>());
-   q.setOverline(node["overline"].as<bool>());
-   // not recommended to use pixelSize()
-   q.setPointSize(node["point size"].as<int>());
-   q.setStretch(node["stretch"].as<int>());
-   q.setStrikeOut(node["strikeout"].as<bool>());
-   q.setStyle(QFont::Style(node["style"].as<int>()));
-   q.setStyleHint(QFont::StyleHint(node["style hint"].as<int>()));
-   q.setStyleName(node["style name"].as<QString>());
-   q.setStyleStrategy(QFont::StyleStrategy(node["style strategy"].as<int>()));
-   q.setUnderline(node["underline"].as<bool>());
-   q.setWeight(QFont::Weight(node["weight"].as<int>()));
-   q.setWordSpacing(node["word spacing"].as<int>());
-}
-void operator<<(Node node, const QFont& q)
-{
-   node["family"] = q.family();
-   node["bold"] = q.bold();
-   node["capitalization"] = int(q.capitalization());
-   node["fixedpitch"] = q.fixedPitch();
-   node["hinting preference"] = int(q.hintingPreference());
-   node["italic"] = q.italic();
-   node["kerning"] = q.kerning();
-   node["letter spacing"] = q.letterSpacing();
-   node["letter spacing type"] = int(q.letterSpacingType());
-   node["overline"] = q.overline();
-   // not recommended to use pixelSize()
-   node["point size"] = q.pointSize();
-   node["stretch"] = q.stretch();
-   node["strikeout"] = q.strikeOut();
-   node["style"] = int(q.style());
-   node["style hint"] = int(q.styleHint());
-   node["style name"] = q.styleName();
-   node["style strategy"] = int(q.styleStrategy());
-   node["underline"] = q.underline();
-   node["weight"] = int(q.weight());
-   node["word spacing"] = q.wordSpacing();
-}
+void operator>>(const Node node, QFont& q);
+void operator<<(Node node, const QFont& q);
 
 /* = QPoint
    =====================================================================================*/
@@ -387,38 +146,12 @@ void operator<<(Node node, const QFont& q)
 template<>
 struct convert<QPoint>
 {
-   static Node encode(const QPoint& rhs) {
-      Node node;
-      node["x"] = rhs.x();
-      node["y"] = rhs.y();
-      return node;
-   }
-
-   static bool decode(const Node& node, QPoint& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
-
-      int x = node["x"].as<int>();
-      int y = node["y"].as<int>();
-      rhs = QPoint(x, y);
-
-      return true;
-   }
+   static Node encode(const QPoint& rhs);
+   static bool decode(const Node& node, QPoint& rhs);
 };
 
-void operator>>(const Node node, QPoint& q)
-{
-   int x = node["x"].as<int>();
-   int y = node["y"].as<int>();
-   q = QPoint(x, y);
-}
-
-void operator<<(Node node, const QPoint& q)
-{
-   node["x"] = q.x();
-   node["y"] = q.y();
-}
+void operator>>(const Node node, QPoint& q);
+void operator<<(Node node, const QPoint& q);
 
 
 /* = QPointF
@@ -430,38 +163,12 @@ void operator<<(Node node, const QPoint& q)
 template<>
 struct convert<QPointF>
 {
-   static Node encode(const QPointF& rhs) {
-      Node node;
-      node["x"] = rhs.x();
-      node["y"] = rhs.y();
-      return node;
-   }
-
-   static bool decode(const Node& node, QPointF& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
-
-      qreal x = node["x"].as<qreal>();
-      qreal y = node["y"].as<qreal>();
-      rhs = QPointF(x, y);
-
-      return true;
-   }
+   static Node encode(const QPointF& rhs);
+   static bool decode(const Node& node, QPointF& rhs);
 };
 
-void operator>>(const Node& node, QPointF& q)
-{
-   qreal x = node["x"].as<qreal>();
-   qreal y = node["y"].as<qreal>();
-   q = QPointF(x, y);
-}
-
-void operator<<(Node& node, const QPointF& q)
-{
-   node["x"] = q.x();
-   node["y"] = q.y();
-}
+void operator>>(const Node& node, QPointF& q);
+void operator<<(Node& node, const QPointF& q);
 
 
 /* = QRect
@@ -473,46 +180,12 @@ void operator<<(Node& node, const QPointF& q)
 template<>
 struct convert<QRect>
 {
-   static Node encode(const QRect& rhs) {
-      Node node;
-      node["left"] = rhs.left();
-      node["top"] = rhs.top();
-      node["width"] = rhs.width();
-      node["height"] = rhs.height();
-      return node;
-   }
-
-   static bool decode(const Node& node, QRect& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
-
-      int left = node["left"].as<int>();
-      int top = node["top"].as<int>();
-      int width = node["width"].as<int>();
-      int height = node["height"].as<int>();
-      rhs = QRect(left, top, width, height);
-
-      return true;
-   }
+   static Node encode(const QRect& rhs);
+   static bool decode(const Node& node, QRect& rhs);
 };
 
-void operator>>(const Node node, QRect& q)
-{
-   int left = node["left"].as<int>();
-   int top = node["top"].as<int>();
-   int width = node["width"].as<int>();
-   int height = node["height"].as<int>();
-   q = QRect(left, top, width, height);
-}
-
-void operator<<(Node node, const QRect& q)
-{
-   node["left"] = q.left();
-   node["top"] = q.top();
-   node["width"] = q.width();
-   node["height"] = q.height();
-}
+void operator>>(const Node node, QRect& q);
+void operator<<(Node node, const QRect& q);
 
 
 /* = QRectF
@@ -524,46 +197,12 @@ void operator<<(Node node, const QRect& q)
 template<>
 struct convert<QRectF>
 {
-   static Node encode(const QRectF& rhs) {
-      Node node;
-      node["left"] = rhs.left();
-      node["top"] = rhs.top();
-      node["width"] = rhs.width();
-      node["height"] = rhs.height();
-      return node;
-   }
-
-   static bool decode(const Node& node, QRectF& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
-
-      qreal left = node["left"].as<qreal>();
-      qreal top = node["top"].as<qreal>();
-      qreal width = node["width"].as<qreal>();
-      qreal height = node["height"].as<qreal>();
-      rhs = QRectF(left, top, width, height);
-
-      return true;
-   }
+   static Node encode(const QRectF& rhs);
+   static bool decode(const Node& node, QRectF& rhs);
 };
 
-void operator>>(const Node node, QRectF& q)
-{
-   qreal left = node["left"].as<qreal>();
-   qreal top = node["top"].as<qreal>();
-   qreal width = node["width"].as<qreal>();
-   qreal height = node["height"].as<qreal>();
-   q = QRectF(left, top, width, height);
-}
-
-void operator<<(Node node, const QRectF& q)
-{
-   node["left"] = q.left();
-   node["top"] = q.top();
-   node["width"] = q.width();
-   node["height"] = q.height();
-}
+void operator>>(const Node node, QRectF& q);
+void operator<<(Node node, const QRectF& q);
 
 
 /* = QSize
@@ -575,81 +214,131 @@ void operator<<(Node node, const QRectF& q)
 template<>
 struct convert<QSize>
 {
-   static Node encode(const QSize& rhs) {
-      Node node;
-      node["width"] = rhs.width();
-      node["height"] = rhs.height();
-      return node;
-   }
+   static Node encode(const QSize& rhs);
+   static bool decode(const Node& node, QSize& rhs);
+};
 
-   static bool decode(const Node& node, QSize& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
+void operator>>(const Node node, QSize& q);
+void operator<<(Node node, const QSize& q);
 
-      int width = node["width"].as<int>();
-      int height = node["height"].as<int>();
-      rhs = QSize(width, height);
 
-      return true;
-   }
+/* = QSizeF
+   ======================================================================================*/
+/*
+   Converts QSizeF to Node and back. Enables QSizeF to be sent/received from a
+   YAML file via yaml-cpp.
+*/
+template<>
+struct convert<QSizeF>
+{
+   static Node encode(const QSizeF& rhs);
+   static bool decode(const Node& node, QSizeF& rhs);
 };
 
-void operator>>(const Node node, QSize& q)
+void operator>>(const Node node, QSizeF& q);
+void operator<<(Node node, const QSizeF& q);
+
+
+/* = QLine
+   ======================================================================================*/
+/*
+   Converts QLine to Node and back as a packed [x1, y1, x2, y2] flow sequence.
+*/
+template<>
+struct convert<QLine>
 {
-   int width = node["width"].as<int>();
-   int height = node["height"].as<int>();
-   q = QSize(width, height);
-}
+   static Node encode(const QLine& rhs);
+   static bool decode(const Node& node, QLine& rhs);
+};
+
+void operator>>(const Node node, QLine& q);
+void operator<<(Node node, const QLine& q);
+
 
-void operator<<(Node node, const QSize& q)
+/* = QLineF
+   ======================================================================================*/
+/*
+   Converts QLineF to Node and back as a packed [x1, y1, x2, y2] flow sequence.
+*/
+template<>
+struct convert<QLineF>
 {
-   node["width"] = q.width();
-   node["height"] = q.height();
-}
+   static Node encode(const QLineF& rhs);
+   static bool decode(const Node& node, QLineF& rhs);
+};
 
+void operator>>(const Node node, QLineF& q);
+void operator<<(Node node, const QLineF& q);
 
-/* = QSizeF
+
+/* = QPolygon
    ======================================================================================*/
 /*
-   Converts QSizeF to Node and back. Enables QSizeF to be sent/received from a
-   YAML file via yaml-cpp.
+   Converts QPolygon to Node and back as a packed [x0, y0, x1, y1, ...] flow
+   sequence. A sequence of {x, y} maps, as written for a QVector<QPoint>, is
+   also accepted.
 */
 template<>
-struct convert<QSizeF>
+struct convert<QPolygon>
 {
-   static Node encode(const QSizeF& rhs) {
-      Node node;
-      node["width"] = rhs.width();
-      node["height"] = rhs.height();
-      return node;
-   }
+   static Node encode(const QPolygon& rhs);
+   static bool decode(const Node& node, QPolygon& rhs);
+};
 
-   static bool decode(const Node& node, QSizeF& rhs) {
-      if (!node.IsMap()) {
-         return false;
-      }
+void operator>>(const Node node, QPolygon& q);
+void operator<<(Node node, const QPolygon& q);
 
-      qreal width = node["width"].as<qreal>();
-      qreal height = node["height"].as<qreal>();
-      rhs = QSizeF(width, height);
 
-      return true;
-   }
+/* = QPolygonF
+   ======================================================================================*/
+/*
+   Converts QPolygonF to Node and back as a packed [x0, y0, x1, y1, ...] flow
+   sequence. A sequence of {x, y} maps, as written for a QVector<QPointF>, is
+   also accepted.
+*/
+template<>
+struct convert<QPolygonF>
+{
+   static Node encode(const QPolygonF& rhs);
+   static bool decode(const Node& node, QPolygonF& rhs);
 };
 
-void operator>>(const Node node, QSizeF& q)
+void operator>>(const Node node, QPolygonF& q);
+void operator<<(Node node, const QPolygonF& q);
+
+
+/* = QTransform
+   ======================================================================================*/
+/*
+   Converts QTransform to Node and back as a packed flow sequence of the nine
+   matrix elements, m11 to m33 in row order.
+*/
+template<>
+struct convert<QTransform>
 {
-   qreal width = node["width"].as<qreal>();
-   qreal height = node["height"].as<qreal>();
-   q = QSizeF(width, height);
-}
+   static Node encode(const QTransform& rhs);
+   static bool decode(const Node& node, QTransform& rhs);
+};
 
-void operator<<(Node node, const QSizeF& q)
+void operator>>(const Node node, QTransform& q);
+void operator<<(Node node, const QTransform& q);
+
+
+/* = QMatrix4x4
+   ======================================================================================*/
+/*
+   Converts QMatrix4x4 to Node and back as a packed flow sequence of the
+   sixteen matrix elements in row order.
+*/
+template<>
+struct convert<QMatrix4x4>
 {
-   node["width"] = q.width();
-   node["height"] = q.height();
-}
+   static Node encode(const QMatrix4x4& rhs);
+   static bool decode(const Node& node, QMatrix4x4& rhs);
+};
+
+void operator>>(const Node node, QMatrix4x4& q);
+void operator<<(Node node, const QMatrix4x4& q);
 
 
 /* = QPixmap
@@ -661,101 +350,172 @@ void operator<<(Node node, const QSizeF& q)
 template<>
 struct convert<QPixmap>
 {
-   static Node encode(const QPixmap& rhs) {
-      Node node;
-      QByteArray array;
-      QBuffer buffer(&array);
-      buffer.open(QIODevice::WriteOnly);
-      rhs.save(&buffer, "PNG");
-      node = array;
-      return node;
-   }
+   static Node encode(const QPixmap& rhs);
+   static bool decode(const Node& node, QPixmap& rhs);
+};
 
-   static bool decode(const Node& node, QPixmap& rhs) {
-      if (!node.IsScalar()) {
-         return false;
-      }
+void operator>>(const Node node, QPixmap& q);
+void operator<<(Node node, const QPixmap& q);
 
-      YAML::Binary binary = node.as<YAML::Binary>();
-      const unsigned char* data = binary.data();
-      std::size_t size = binary.size();
-      QPixmap pixmap;
-      bool res = pixmap.loadFromData(data, uint(size));
 
-      if (res) {
-         rhs = pixmap;
-      }
+/* = QImage
+   ======================================================================================*/
+/*
+   Converts QImage to Node and back. Enables QImage to be sent/received from a
+   YAML file via yaml-cpp.
+*/
+template<>
+struct convert<QImage>
+{
+   static Node encode(const QImage& rhs);
+   static bool decode(const Node& node, QImage& rhs);
+};
 
-      return res;
-   }
+void operator>>(const Node node, QImage& q);
+void operator<<(Node node, const QImage& q);
+
+
+/* = QDateTime
+   ===============================================================================*/
+/*
+   Converts QDateTime to an ISO 8601 scalar and back, "2020-06-01T13:45:30Z"
+   for UTC, with an offset for other time specs and none for local time.
+   Milliseconds are only written when they are not zero. The fixed layout is
+   parsed by hand, anything else goes through QDateTime::fromString().
+*/
+template<>
+struct convert<QDateTime>
+{
+   static Node encode(const QDateTime& rhs);
+   static bool decode(const Node& node, QDateTime& rhs);
 };
 
-void operator>>(const Node node, QPixmap& q)
+void operator>>(const Node node, QDateTime& q);
+void operator<<(Node node, const QDateTime& q);
+
+
+/* = QDate
+   ===================================================================================*/
+/*
+   Converts QDate to an ISO 8601 "yyyy-MM-dd" scalar and back.
+*/
+template<>
+struct convert<QDate>
 {
-   YAML::Binary binary = node.as<YAML::Binary>();
-   const char* data = reinterpret_cast<const char*>(binary.data());
-   int size = int(binary.size());
-   const QByteArray array(data, size);
-   QPixmap pixmap;
-   bool res = pixmap.loadFromData(array, "PNG");
-
-   if (res) {
-      q = pixmap;
-   }
-}
+   static Node encode(const QDate& rhs);
+   static bool decode(const Node& node, QDate& rhs);
+};
 
-void operator<<(Node node, const QPixmap& q)
+void operator>>(const Node node, QDate& q);
+void operator<<(Node node, const QDate& q);
+
+
+/* = QTime
+   ===================================================================================*/
+/*
+   Converts QTime to an ISO 8601 "hh:mm:ss" or "hh:mm:ss.zzz" scalar and
+   back.
+*/
+template<>
+struct convert<QTime>
 {
-   QByteArray array;
-   QBuffer buffer(&array);
-   buffer.open(QIODevice::WriteOnly);
-   q.save(&buffer, "PNG");
-   node = array;
-}
+   static Node encode(const QTime& rhs);
+   static bool decode(const Node& node, QTime& rhs);
+};
 
+void operator>>(const Node node, QTime& q);
+void operator<<(Node node, const QTime& q);
 
-/* = QImage
-   ======================================================================================*/
+
+/* = QUuid
+   ===================================================================================*/
 /*
-   Converts QImage to Node and back. Enables QImage to be sent/received from a
-   YAML file via yaml-cpp.
+   Converts QUuid to its string form, without braces, and back. A null node
+   decodes to a null QUuid.
 */
 template<>
-struct convert<QImage>
+struct convert<QUuid>
 {
-   static Node encode(const QImage& rhs) {
-      Node node;
-      QPixmap pixmap = QPixmap::fromImage(rhs);
-      QByteArray array;
-      QBuffer buffer(&array);
-      buffer.open(QIODevice::WriteOnly);
-      pixmap.save(&buffer, "PNG");
-      node = array;
-      return node;
+   static Node encode(const QUuid& rhs);
+   static bool decode(const Node& node, QUuid& rhs);
+};
+
+void operator>>(const Node node, QUuid& q);
+void operator<<(Node node, const QUuid& q);
+
+
+/* = QUrl
+   ====================================================================================*/
+/*
+   Converts QUrl to its string form and back.
+*/
+template<>
+struct convert<QUrl>
+{
+   static Node encode(const QUrl& rhs);
+   static bool decode(const Node& node, QUrl& rhs);
+};
+
+void operator>>(const Node node, QUrl& q);
+void operator<<(Node node, const QUrl& q);
+
+
+/* = QVariant
+   =========================================================================================*/
+/*
+   Converts QVariant to Node and back. Lists and maps become sequences and
+   mappings, QColor and QFont use their own converters and anything else is
+   written as a string. Scalars decode to QString, so use QVariant::value<T>()
+   to read numbers back. QByteArray is written as base64 tagged !!binary and
+   decodes back to QByteArray.
+   Colours and fonts are tagged !qcolor and !qfont, and only tagged mappings
+   decode back to QColor or QFont, so a plain mapping that happens to have
+   the same keys stays a QVariantMap.
+*/
+template<>
+struct convert<QVariant>
+{
+   static Node encode(const QVariant& rhs);
+   static bool decode(const Node& node, QVariant& rhs);
+
+   static const char* binaryTag() { return "tag:yaml.org,2002:binary"; }
+   static const char* colorTag() { return "!qcolor"; }
+   static const char* fontTag() { return "!qfont"; }
+
+   /*!
+      \brief True if node has the shape of an encoded QColor or QFont,
+      whether or not it is tagged.
+   */
+   static bool isColor(const Node& node) {
+      return node.IsMap() && node.size() == 4 &&
+             hasKeys(node, { "red", "green", "blue", "alpha" });
+   }
+
+   static bool isFont(const Node& node) {
+      return node.IsMap() && node.size() == 20 &&
+             hasKeys(node, { "family", "point size", "weight", "style hint" });
    }
 
-   static bool decode(const Node& node, QImage& rhs) {
-      if (!node.IsScalar()) {
-         return false;
+private:
+   static bool hasKeys(const Node& node,
+                       std::initializer_list<const char*> keys) {
+      for (const char* key : keys) {
+         if (!node[key].IsScalar()) {
+            return false;
+         }
       }
 
-      QPixmap pixmap = node.as<QPixmap>();
-      rhs = pixmap.toImage();
-      return rhs.isNull();
+      return true;
    }
 };
 
-void operator>>(const Node node, QImage& q){
-  QPixmap pixmap = node.as<QPixmap>();
-  q = pixmap.toImage();
-}
-
-void operator<<(Node node, const QImage& q){
-  QPixmap pixmap = QPixmap::fromImage(q);
-  node = pixmap;
-}
-
+void operator>>(const Node node, QVariant& q);
+void operator<<(Node node, const QVariant& q);
 
 } // end of namespace YAML
 
+#if !defined(QYAMLCPP_COMPILED_LIB)
+#include "node-inl.h"
+#endif
+
 #endif // NODE_H
@@ -0,0 +1,170 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_PACKED_H
+#define QYAML_PACKED_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include <yaml-cpp/yaml.h>
+
+#include "scalar.h"
+
+namespace QYaml {
+
+/*!
+   \brief Flat numeric flow sequences for the geometry converters.
+
+   Polygons, lines, transforms and matrices are stored as one flow sequence
+   of their coordinates rather than a map per point,
+
+   \code
+   [0, 0, 100, 0, 100, 50.5, 0, 50.5]
+   \endcode
+
+   which is one node per number instead of three nodes and two key lookups
+   per point. Numbers are formatted and parsed with the locale independent
+   functions in scalar.h, without going through std::stringstream.
+*/
+namespace Packed {
+
+namespace detail {
+
+template<class T>
+inline int format(T value, char* out, std::true_type)
+{
+  return Scalar::formatInteger(value, out);
+}
+
+template<class T>
+inline int format(T value, char* out, std::false_type)
+{
+  return Scalar::formatReal(value, out);
+}
+
+template<class T>
+inline bool parse(const std::string& text, T& value, std::true_type)
+{
+  return Scalar::toInteger(text.data(), text.size(), value);
+}
+
+template<class T>
+inline bool parse(const std::string& text, T& value, std::false_type)
+{
+  double number;
+
+  if (!Scalar::toDouble(text.data(), text.size(), number)) {
+    return false;
+  }
+
+  value = T(number);
+  return true;
+}
+
+} // end of namespace detail
+
+/*!
+   \brief An empty flow style sequence to append() to.
+*/
+inline YAML::Node sequence()
+{
+  YAML::Node node(YAML::NodeType::Sequence);
+  node.SetStyle(YAML::EmitterStyle::Flow);
+  return node;
+}
+
+/*!
+   \brief Appends value to node as a plain scalar.
+*/
+template<class T>
+inline void append(YAML::Node& node, T value)
+{
+  char buffer[Scalar::NumberLength];
+  const int length = detail::format(value, buffer, std::is_integral<T>());
+  node.push_back(YAML::Node(std::string(buffer, std::size_t(length))));
+}
+
+/*!
+   \brief Reads one element of a packed sequence. Returns false if it is
+   not a scalar of the right type.
+*/
+template<class T>
+inline bool read(const YAML::Node& node, T& value)
+{
+  return node.IsScalar() && detail::parse(node.Scalar(), value, std::is_integral<T>());
+}
+
+/*!
+   \brief A flow sequence of count values.
+*/
+template<class T>
+inline YAML::Node sequence(const T* values, std::size_t count)
+{
+  YAML::Node node = sequence();
+
+  for (std::size_t i = 0; i < count; ++i) {
+    append(node, values[i]);
+  }
+
+  return node;
+}
+
+/*!
+   \brief Reads a sequence of exactly count values into values. Returns
+   false if node is not such a sequence.
+*/
+template<class T>
+inline bool read(const YAML::Node& node, T* values, std::size_t count)
+{
+  if (!node.IsSequence() || node.size() != count) {
+    return false;
+  }
+
+  for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+    if (!read(*it, *values++)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+   \brief Writes value to the emitter as a plain scalar, in the same form
+   append() uses.
+*/
+template<class T>
+inline void write(YAML::Emitter& emitter, T value)
+{
+  char buffer[Scalar::NumberLength];
+  const int length = detail::format(value, buffer, std::is_integral<T>());
+  emitter.Write(std::string(buffer, std::size_t(length)));
+}
+
+} // end of namespace Packed
+} // end of namespace QYaml
+
+#endif // QYAML_PACKED_H
@@ -0,0 +1,252 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_PARALLELEMITTER_H
+#define QYAML_PARALLELEMITTER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "collection.h"
+#include "instrument.h"
+
+namespace QYaml {
+
+namespace detail {
+
+struct AppendValue
+{
+  template<class Iterator>
+  void operator()(YAML::Node& node, Iterator it) const {
+    node.push_back(*it);
+  }
+};
+
+struct InsertPair
+{
+  template<class Iterator>
+  void operator()(YAML::Node& node, Iterator it) const {
+    node.force_insert(it.key(), it.value());
+  }
+};
+
+/*
+   Converts one range of elements into a node of their own and emits it as
+   a complete top-level collection.
+*/
+template<class Iterator, class Insert>
+class EmitRangeTask : public QRunnable
+{
+public:
+  EmitRangeTask(Iterator begin,
+                Iterator end,
+                YAML::NodeType::value type,
+                std::string& output,
+                std::exception_ptr& error)
+    : m_begin(begin)
+    , m_end(end)
+    , m_type(type)
+    , m_output(output)
+    , m_error(error) {}
+
+  void run() override {
+    try {
+      YAML::Node node(m_type);
+      Insert insert;
+
+      for (Iterator it = m_begin; it != m_end; ++it) {
+        insert(node, it);
+      }
+
+      YAML::Emitter out;
+      out << node;
+
+      if (!out.good()) {
+        throw YAML::EmitterException(out.GetLastError());
+      }
+
+      m_output.assign(out.c_str(), out.size());
+
+    } catch (...) {
+      m_error = std::current_exception();
+    }
+  }
+
+private:
+  Iterator m_begin;
+  Iterator m_end;
+  YAML::NodeType::value m_type;
+  std::string& m_output;
+  std::exception_ptr& m_error;
+};
+
+/*
+   At the top level every element of a block collection starts on a line of
+   its own at column 0, and is written the same wherever it is, so the
+   output of consecutive ranges joined by line breaks is the output of the
+   whole collection. Empty and flow collections are never split.
+*/
+template<class Insert, class Iterator>
+QByteArray emitParallel(Iterator begin,
+                        Iterator end,
+                        int count,
+                        YAML::NodeType::value type,
+                        int threads)
+{
+  typedef EmitRangeTask<Iterator, Insert> Task;
+  static const int MinimumRange = 1024;
+
+  if (threads <= 0) {
+    threads = QThread::idealThreadCount();
+  }
+
+  // a few ranges per thread evens out elements of different sizes.
+  int ranges = threads > 1 ? threads * 4 : 1;
+  ranges = std::max(1, std::min(ranges, count / MinimumRange));
+
+  const std::size_t size = std::size_t(ranges);
+  std::vector<std::string> parts(size);
+  std::vector<std::exception_ptr> errors(size);
+
+  if (ranges == 1) {
+    Task(begin, end, type, parts[0], errors[0]).run();
+  } else {
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    Iterator first = begin;
+
+    for (std::size_t i = 0; i < size; ++i) {
+      Iterator last = end;
+
+      if (i < size - 1) {
+        last = first;
+        std::advance(last, count / ranges + (int(i) < count % ranges ? 1 : 0));
+      }
+
+      pool.start(new Task(first, last, type, parts[i], errors[i]));
+      first = last;
+    }
+
+    pool.waitForDone();
+  }
+
+  std::size_t total = 0;
+
+  for (std::size_t i = 0; i < size; ++i) {
+    if (errors[i]) {
+      std::rethrow_exception(errors[i]);
+    }
+
+    total += parts[i].size() + 1;
+  }
+
+  QByteArray output;
+  output.reserve(int(total));
+
+  for (std::size_t i = 0; i < size; ++i) {
+    if (i > 0) {
+      output.append('\n');
+    }
+
+    output.append(parts[i].data(), int(parts[i].size()));
+  }
+
+  return output;
+}
+
+} // end of namespace detail
+
+/*!
+   \brief Emits a large top-level sequence or mapping on several threads.
+
+   The elements are cut into contiguous ranges, a few per thread, and each
+   range is converted and emitted into a buffer of its own on a thread pool.
+   The buffers are then joined in order. The result is byte for byte what
+
+   \code
+   YAML::Emitter out;
+   out << records;
+   QByteArray yaml(out.c_str(), int(out.size()));
+   \endcode
+
+   gives, so it can be written straight to a file.
+
+   \code
+   QMap<QString, QVariantMap> records = ...;
+   QByteArray yaml = QYaml::emitParallel(records);
+   \endcode
+
+   threads defaults to QThread::idealThreadCount(). Collections of less
+   than a few thousand elements are emitted on the calling thread. The
+   element converters must be thread safe, which rules out QPixmap, and
+   the output matches an emitter with the default settings. Elements that
+   are YAML::Nodes already belong to a tree, and adding them to another one
+   changes them, so emit those on one thread.
+
+   @throws the first exception thrown by a converter, or
+   YAML::EmitterException if a range could not be emitted.
+*/
+template<class T>
+inline QByteArray emitParallel(const QList<T>& v, int threads = 0)
+{
+  QYAML_TYPED_PROBE("emitParallel", QList<T>);
+
+  return detail::emitParallel<detail::AppendValue>(
+    v.constBegin(), v.constEnd(), v.size(), YAML::NodeType::Sequence, threads);
+}
+
+template<class T>
+inline QByteArray emitParallel(const QVector<T>& v, int threads = 0)
+{
+  QYAML_TYPED_PROBE("emitParallel", QVector<T>);
+
+  return detail::emitParallel<detail::AppendValue>(
+    v.constBegin(), v.constEnd(), v.size(), YAML::NodeType::Sequence, threads);
+}
+
+template<class K, class V>
+inline QByteArray emitParallel(const QMap<K, V>& v, int threads = 0)
+{
+  QYAML_TYPED_PROBE("emitParallel", QMap<K, V>);
+
+  return detail::emitParallel<detail::InsertPair>(
+    v.constBegin(), v.constEnd(), v.size(), YAML::NodeType::Map, threads);
+}
+
+} // end of namespace QYaml
+
+#endif // QYAML_PARALLELEMITTER_H
@@ -0,0 +1,116 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_PARSE_INL_H
+#define QYAML_PARSE_INL_H
+
+#include "parse.h"
+#include "streambuf.h"
+
+#include <istream>
+
+namespace YAML {
+
+QYAMLCPP_INLINE Node Load(const QString& input)
+{
+   QYAML_PROBE("Load(QString)");
+   QYAML_PROBE_BYTES(input.size());
+
+   return Load(input.toStdString());
+}
+
+QYAMLCPP_INLINE Node Load(const QByteArray& input)
+{
+   QYAML_PROBE("Load(QByteArray)");
+   QYAML_PROBE_BYTES(input.size());
+
+   return Load(input.toStdString());
+}
+
+QYAMLCPP_INLINE Node LoadFile(const QString& filename)
+{
+   QYAML_PROBE("LoadFile(QString)");
+
+   return LoadFile(filename.toStdString());
+}
+
+QYAMLCPP_INLINE Node LoadFile(QFile& file)
+{
+   QYAML_PROBE("LoadFile(QFile)");
+
+   if (!file.exists()) {
+      return Node();
+   }
+
+   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      return Node();
+   }
+
+   QTextStream istream(&file);
+   QString data = istream.readAll();
+   QYAML_PROBE_BYTES(data.size());
+   return Load(data.toStdString());
+}
+
+QYAMLCPP_INLINE std::vector<Node> LoadAll(const QString& input)
+{
+   QYAML_PROBE("LoadAll(QString)");
+   QYAML_PROBE_BYTES(input.size());
+
+   return LoadAll(input.toUtf8());
+}
+
+QYAMLCPP_INLINE std::vector<Node> LoadAll(const QByteArray& input)
+{
+   QYAML_PROBE("LoadAll(QByteArray)");
+   QYAML_PROBE_BYTES(input.size());
+
+   QYaml::ByteArrayStreamBuf buffer(input);
+   std::istream stream(&buffer);
+   return LoadAll(stream);
+}
+
+QYAMLCPP_INLINE std::vector<Node> LoadAllFromFile(const QString& filename)
+{
+   QYAML_PROBE("LoadAllFromFile(QString)");
+
+   return LoadAllFromFile(filename.toStdString());
+}
+
+QYAMLCPP_INLINE std::vector<Node> LoadAllFromFile(QFile& file)
+{
+   QYAML_PROBE("LoadAllFromFile(QFile)");
+
+   if (!file.isOpen() && !file.open(QIODevice::ReadOnly)) {
+      return std::vector<Node>();
+   }
+
+   const QByteArray data = file.readAll();
+   QYAML_PROBE_BYTES(data.size());
+   return LoadAll(data);
+}
+
+} // end of namespace YAML
+
+#endif // QYAML_PARSE_INL_H
@@ -1,10 +1,15 @@
 #ifndef Q_YAML_PARSE_H
 #define Q_YAML_PARSE_H
 
+#include <QByteArray>
 #include <QFile>
 #include <QString>
 #include <QTextStream>
 
+#include <vector>
+
+#include "config.h"
+#include "instrument.h"
 #include "node.h"
 
 namespace YAML {
@@ -14,46 +19,59 @@ namespace YAML {
 
    @throws {@link ParserException} if it is malformed.
 */
-Node Load(const QString& input)
-{
-   return Load(input.toStdString());
-}
+Node Load(const QString& input);
 
 /**
    Loads the input QString as a single YAML document.
 
    @throws {@link ParserException} if it is malformed.
 */
-Node Load(const QByteArray& input)
-{
-   return Load(input.toStdString());
-}
+Node Load(const QByteArray& input);
 
 /*!
     \brief YAML::LoadFile extension for QString
 */
-Node LoadFile(const QString& filename)
-{
-   return LoadFile(filename.toStdString());
-}
+Node LoadFile(const QString& filename);
 
 /*!
     \brief YAML::LoadFile extension for QString
 */
-Node LoadFile(QFile& file)
-{
-   if (!file.exists()) {
-      return Node();
-   }
+Node LoadFile(QFile& file);
 
-   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-      return Node();
-   }
+/**
+   Loads every document in the input QString.
 
-   QTextStream istream(&file);
-   QString data = istream.readAll();
-   return Load(data.toStdString());
-}
+   @throws {@link ParserException} if it is malformed.
+*/
+std::vector<Node> LoadAll(const QString& input);
+
+/**
+   Loads every document in the input QByteArray, parsing it in place.
+
+   @throws {@link ParserException} if it is malformed.
+*/
+std::vector<Node> LoadAll(const QByteArray& input);
+
+/**
+   Loads every document in the named file.
+
+   @throws {@link ParserException} if it is malformed.
+   @throws {@link BadFile} if the file cannot be loaded.
+*/
+std::vector<Node> LoadAllFromFile(const QString& filename);
+
+/**
+   Loads every document in file, opening it if necessary. Returns no
+   documents if the file cannot be read.
+
+   @throws {@link ParserException} if it is malformed.
+*/
+std::vector<Node> LoadAllFromFile(QFile& file);
 
 }
+
+#if !defined(QYAMLCPP_COMPILED_LIB)
+#include "parse-inl.h"
+#endif
+
 #endif // Q_YAML_PARSE_H
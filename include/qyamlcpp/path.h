@@ -0,0 +1,286 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_PATH_H
+#define QYAML_PATH_H
+
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "node.h"
+
+namespace QYaml {
+
+/*!
+   \brief A precompiled key path into a YAML::Node tree.
+
+   A chain such as doc["window"]["geometry"]["rect"] converts each key to a
+   std::string and decodes every map key it passes on the way. A Path is
+   compiled once, storing its keys as std::strings, and resolving it compares
+   those directly against the map keys' scalar text so the walk itself makes
+   no allocations. Segments made only of digits also index into sequences.
+
+   \code
+   static const QYaml::Path rectPath("window/geometry/rect");
+   QRect rect = rectPath.resolve<QRect>(doc);
+   \endcode
+
+   The Cached variants take a generation number and memoize the resolved
+   node and the last converted value. Bump the generation whenever the document is
+   reloaded or edited. Memoization state is not thread safe, so share a
+   memoizing Path between threads only if access is serialised.
+*/
+class Path
+{
+public:
+  Path() = default;
+
+  /*!
+     \brief Compiles a separator delimited path. Empty segments are ignored.
+  */
+  explicit Path(const QString& path, QChar separator = QChar('/')) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const QStringList segments = path.split(separator, Qt::SkipEmptyParts);
+#else
+    const QStringList segments = path.split(separator, QString::SkipEmptyParts);
+#endif
+
+    for (const QString& segment : segments) {
+      append(segment);
+    }
+  }
+
+  /*!
+     \brief Compiles a path from a list of keys, which may contain the
+     separator character.
+  */
+  explicit Path(const QStringList& segments) {
+    for (const QString& segment : segments) {
+      append(segment);
+    }
+  }
+
+  Path(const Path& other)
+    : m_segments(other.m_segments) {}
+
+  Path& operator=(const Path& other) {
+    m_segments = other.m_segments;
+    invalidate();
+    return *this;
+  }
+
+  int size() const { return int(m_segments.size()); }
+  bool isEmpty() const { return m_segments.empty(); }
+
+  QStringList segments() const {
+    QStringList list;
+
+    for (const Segment& segment : m_segments) {
+      list.append(QString::fromStdString(segment.key));
+    }
+
+    return list;
+  }
+
+  QString toString(QChar separator = QChar('/')) const {
+    return segments().join(separator);
+  }
+
+  /*!
+     \brief Walks root along the path, returning an undefined node if any
+     step is missing.
+  */
+  YAML::Node resolveNode(const YAML::Node& root) const {
+    YAML::Node current;
+    current.reset(root);
+
+    for (const Segment& segment : m_segments) {
+      if (!step(current, segment)) {
+        return YAML::Node(YAML::NodeType::Undefined);
+      }
+    }
+
+    return current;
+  }
+
+  /*!
+     \brief Resolves the path and converts the result to T.
+
+     @throws {@link TypedBadConversion} if the path does not exist or the
+     value cannot be converted.
+  */
+  template<class T>
+  T resolve(const YAML::Node& root) const {
+    return resolveNode(root).as<T>();
+  }
+
+  /*!
+     \brief Resolves the path and converts the result to T, returning
+     fallback if the path does not exist or cannot be converted.
+  */
+  template<class T>
+  T resolve(const YAML::Node& root, const T& fallback) const {
+    YAML::Node node = resolveNode(root);
+
+    if (!node.IsDefined()) {
+      return fallback;
+    }
+
+    return node.as<T>(fallback);
+  }
+
+  /*!
+     \brief As resolveNode(), memoized until generation or root changes.
+  */
+  YAML::Node resolveNodeCached(const YAML::Node& root,
+                               quint64 generation) const {
+    refresh(root, generation);
+    return m_cache->node;
+  }
+
+  /*!
+     \brief As resolve<T>(), memoizing both the node and the converted
+     value until generation or root changes.
+  */
+  template<class T>
+  T resolveCached(const YAML::Node& root, quint64 generation) const {
+    refresh(root, generation);
+
+    if (m_cache->valueType != typeTag<T>()) {
+      m_cache->value.reset(new Value<T>(m_cache->node.as<T>()));
+      m_cache->valueType = typeTag<T>();
+    }
+
+    return static_cast<const Value<T>*>(m_cache->value.get())->value;
+  }
+
+  /*!
+     \brief Discards any memoized result.
+  */
+  void invalidate() const { m_cache.reset(); }
+
+private:
+  struct Segment
+  {
+    std::string key;
+    long index; // -1 unless the key is a valid sequence index
+  };
+
+  struct ValueBase
+  {
+    virtual ~ValueBase() = default;
+  };
+
+  template<class T>
+  struct Value : ValueBase
+  {
+    explicit Value(const T& v)
+      : value(v) {}
+    T value;
+  };
+
+  struct Cache
+  {
+    YAML::Node root;
+    YAML::Node node;
+    quint64 generation;
+    const void* valueType;
+    std::unique_ptr<ValueBase> value;
+  };
+
+  template<class T>
+  static const void* typeTag() {
+    static const char tag = 0;
+    return &tag;
+  }
+
+  void append(const QString& segment) {
+    Segment s;
+    s.key = segment.toStdString();
+
+    bool ok = false;
+    s.index = segment.toLong(&ok);
+
+    if (!ok || s.index < 0) {
+      s.index = -1;
+    }
+
+    m_segments.push_back(s);
+  }
+
+  // Rebinds current to the child named by segment. reset() is used rather
+  // than assignment, which would overwrite the node inside the document.
+  static bool step(YAML::Node& current, const Segment& segment) {
+    switch (current.Type()) {
+      case YAML::NodeType::Map:
+        for (YAML::const_iterator it = current.begin(); it != current.end();
+             ++it) {
+          if (it->first.IsScalar() && it->first.Scalar() == segment.key) {
+            current.reset(it->second);
+            return true;
+          }
+        }
+
+        return false;
+
+      case YAML::NodeType::Sequence:
+        if (segment.index < 0 || std::size_t(segment.index) >= current.size()) {
+          return false;
+        }
+
+        current.reset(
+          static_cast<const YAML::Node&>(current)[std::size_t(segment.index)]);
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  void refresh(const YAML::Node& root, quint64 generation) const {
+    if (m_cache && m_cache->generation == generation &&
+        m_cache->root.is(root)) {
+      return;
+    }
+
+    m_cache.reset(new Cache);
+    m_cache->root.reset(root);
+    m_cache->node.reset(resolveNode(root));
+    m_cache->generation = generation;
+    m_cache->valueType = nullptr;
+  }
+
+  std::vector<Segment> m_segments;
+  mutable std::unique_ptr<Cache> m_cache;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_PATH_H
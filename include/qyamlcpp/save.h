@@ -0,0 +1,246 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_SAVE_H
+#define QYAML_SAVE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QSaveFile>
+#include <QString>
+
+#include <memory>
+#include <ostream>
+#include <streambuf>
+
+#include <yaml-cpp/yaml.h>
+
+#include "hash.h"
+
+namespace QYaml {
+
+/*!
+   \brief A write only std::streambuf that collects its output in a
+   QByteArray and hashes it as it arrives.
+*/
+class HashingStreamBuf : public std::streambuf
+{
+public:
+  void clear() {
+    m_data.clear();
+    m_hash.reset();
+  }
+
+  const QByteArray& data() const { return m_data; }
+  quint64 hash() const { return m_hash.result(); }
+
+protected:
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      const char ch = traits_type::to_char_type(c);
+      m_data.append(ch);
+      m_hash.addData(&ch, 1);
+    }
+
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize count) override {
+    m_data.append(s, int(count));
+    m_hash.addData(s, std::size_t(count));
+    return count;
+  }
+
+private:
+  QByteArray m_data;
+  XXHash64 m_hash;
+};
+
+/*!
+   \brief Saves YAML to a file, but only if the content has changed.
+
+   The output is hashed while it is being emitted and compared with the hash
+   of the last save. On the first save, or if the file has been touched since,
+   the file on disk is hashed instead, and only when its size matches. If
+   nothing has changed the file is left alone, so its modification time, file
+   watchers and backups are not disturbed. Otherwise the file is replaced
+   atomically through QSaveFile.
+
+   \code
+   QYaml::SaveFile file(path);
+
+   YAML::Emitter& out = file.begin();
+   out << YAML::BeginMap;
+   out << YAML::Key << "font" << YAML::Value << font;
+   out << YAML::EndMap;
+
+   if (file.commit() == QYaml::SaveFile::Error) {
+      qWarning() << file.errorString();
+   }
+   \endcode
+
+   Keep the SaveFile around between saves to avoid reading the file back each
+   time. Not thread safe.
+*/
+class SaveFile
+{
+public:
+  enum Result
+  {
+    Written,
+    Unchanged,
+    Error
+  };
+
+  explicit SaveFile(const QString& fileName)
+    : m_fileName(fileName)
+    , m_stream(&m_buffer)
+    , m_hash(0)
+    , m_hasHash(false) {}
+
+  SaveFile(const SaveFile&) = delete;
+  SaveFile& operator=(const SaveFile&) = delete;
+
+  QString fileName() const { return m_fileName; }
+  QString errorString() const { return m_error; }
+
+  /*!
+     \brief Starts a new save and returns the emitter to write it with.
+     Anything emitted since the last commit() is discarded.
+  */
+  YAML::Emitter& begin() {
+    m_emitter.reset();
+    m_buffer.clear();
+    m_stream.clear();
+    m_emitter.reset(new YAML::Emitter(m_stream));
+    return *m_emitter;
+  }
+
+  /*!
+     \brief Writes what was emitted since begin(), unless it matches the
+     file.
+  */
+  Result commit() {
+    if (!m_emitter) {
+      m_error = QStringLiteral("commit() called without begin()");
+      return Error;
+    }
+
+    if (!m_emitter->good()) {
+      m_error = QString::fromStdString(m_emitter->GetLastError());
+      m_emitter.reset();
+      return Error;
+    }
+
+    m_emitter.reset();
+    const Result result = save(m_buffer.data(), m_buffer.hash());
+    m_buffer.clear();
+    return result;
+  }
+
+  /*!
+     \brief Writes data that has already been serialised, unless it matches
+     the file.
+  */
+  Result write(const QByteArray& data) { return save(data, XXHash64::hash(data)); }
+
+  /*!
+     \brief Forgets the last saved hash, so the next save compares against
+     the file on disk.
+  */
+  void reset() { m_hasHash = false; }
+
+private:
+  bool matches(const QFileInfo& info, qint64 size, quint64 hash) const {
+    if (!info.exists() || info.size() != size) {
+      return false;
+    }
+
+    if (m_hasHash && info.lastModified() == m_modified) {
+      return hash == m_hash;
+    }
+
+    QFile file(m_fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+      return false;
+    }
+
+    XXHash64 fileHash;
+    char chunk[64 * 1024];
+    qint64 read = 0;
+
+    while ((read = file.read(chunk, qint64(sizeof(chunk)))) > 0) {
+      fileHash.addData(chunk, std::size_t(read));
+    }
+
+    return read == 0 && fileHash.result() == hash;
+  }
+
+  void remember(quint64 hash) {
+    m_hash = hash;
+    m_hasHash = true;
+    m_modified = QFileInfo(m_fileName).lastModified();
+  }
+
+  Result save(const QByteArray& data, quint64 hash) {
+    m_error.clear();
+    const QFileInfo info(m_fileName);
+
+    if (matches(info, data.size(), hash)) {
+      remember(hash);
+      return Unchanged;
+    }
+
+    QDir().mkpath(info.absolutePath());
+    QSaveFile file(m_fileName);
+
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() ||
+        !file.commit()) {
+      m_error = file.errorString();
+      m_hasHash = false;
+      return Error;
+    }
+
+    remember(hash);
+    return Written;
+  }
+
+  QString m_fileName;
+  QString m_error;
+  HashingStreamBuf m_buffer;
+  std::ostream m_stream;
+  std::unique_ptr<YAML::Emitter> m_emitter;
+  quint64 m_hash;
+  QDateTime m_modified;
+  bool m_hasHash;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_SAVE_H
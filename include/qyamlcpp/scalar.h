@@ -0,0 +1,394 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_SCALAR_H
+#define QYAML_SCALAR_H
+
+#include <QByteArray>
+
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace QYaml {
+
+/*!
+   \brief Locale independent parsing of YAML scalar text.
+
+   These work directly on a pointer and length so that scalars can be read
+   without first copying them into a std::string or QByteArray. The accepted
+   forms follow what yaml-cpp accepts for the same types.
+*/
+namespace Scalar {
+
+/*!
+   \brief Returns true if the text matches one of the YAML null forms.
+*/
+inline bool isNull(const char* data, std::size_t size)
+{
+  if (size == 0) {
+    return true;
+  }
+
+  if (size == 1) {
+    return data[0] == '~';
+  }
+
+  return size == 4 && (std::strncmp(data, "null", 4) == 0 ||
+                       std::strncmp(data, "Null", 4) == 0 ||
+                       std::strncmp(data, "NULL", 4) == 0);
+}
+
+/*!
+   \brief Converts the YAML boolean forms (true/yes/on/y and their negatives)
+   to a bool.
+
+   Returns false if the text is not a recognised boolean.
+*/
+inline bool toBool(const char* data, std::size_t size, bool& rhs)
+{
+  static const char* const trueNames[] = { "y",    "Y",    "yes", "Yes",
+                                           "YES",  "true", "True", "TRUE",
+                                           "on",   "On",   "ON" };
+  static const char* const falseNames[] = { "n",     "N",     "no",  "No",
+                                            "NO",    "false", "False", "FALSE",
+                                            "off",   "Off",   "OFF" };
+
+  for (const char* name : trueNames) {
+    if (std::strlen(name) == size && std::strncmp(name, data, size) == 0) {
+      rhs = true;
+      return true;
+    }
+  }
+
+  for (const char* name : falseNames) {
+    if (std::strlen(name) == size && std::strncmp(name, data, size) == 0) {
+      rhs = false;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*!
+   \brief Converts decimal, 0x hexadecimal or 0o octal text to an integer.
+
+   Returns false on malformed text or if the value does not fit in T.
+*/
+template<class T>
+inline bool toInteger(const char* data, std::size_t size, T& rhs)
+{
+  static_assert(std::is_integral<T>::value, "toInteger requires an integer");
+
+  const char* p = data;
+  const char* end = data + size;
+  bool negative = false;
+
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  if (p == end || (negative && !std::is_signed<T>::value)) {
+    return false;
+  }
+
+  unsigned base = 10;
+
+  if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+    base = 16;
+    p += 2;
+  } else if (end - p > 2 && p[0] == '0' && p[1] == 'o') {
+    base = 8;
+    p += 2;
+  }
+
+  typedef unsigned long long Accumulator;
+  const Accumulator limit =
+    negative ? Accumulator(std::numeric_limits<T>::max()) + 1
+             : Accumulator(std::numeric_limits<T>::max());
+  Accumulator value = 0;
+
+  for (; p != end; ++p) {
+    unsigned digit;
+
+    if (*p >= '0' && *p <= '9') {
+      digit = unsigned(*p - '0');
+    } else if (*p >= 'a' && *p <= 'f') {
+      digit = unsigned(*p - 'a' + 10);
+    } else if (*p >= 'A' && *p <= 'F') {
+      digit = unsigned(*p - 'A' + 10);
+    } else {
+      return false;
+    }
+
+    if (digit >= base || value > (limit - digit) / base) {
+      return false;
+    }
+
+    value = value * base + digit;
+  }
+
+  if (negative) {
+    rhs = T(0 - value);
+  } else {
+    rhs = T(value);
+  }
+
+  return true;
+}
+
+/*!
+   \brief Converts YAML floating point text, including .inf and .nan, to a
+   double.
+
+   strtod() honours LC_NUMERIC, which Qt sets from the environment, so the
+   text is copied into a small stack buffer and the decimal point swapped for
+   the locale one when the two differ.
+*/
+inline bool toDouble(const char* data, std::size_t size, double& rhs)
+{
+  const char* p = data;
+  std::size_t n = size;
+  bool negative = false;
+
+  if (n > 0 && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+    --n;
+  }
+
+  if (n == 4 && p[0] == '.') {
+    if (std::strncmp(p, ".inf", 4) == 0 || std::strncmp(p, ".Inf", 4) == 0 ||
+        std::strncmp(p, ".INF", 4) == 0) {
+      rhs = negative ? -std::numeric_limits<double>::infinity()
+                     : std::numeric_limits<double>::infinity();
+      return true;
+    }
+
+    if (p == data && (std::strncmp(p, ".nan", 4) == 0 ||
+                      std::strncmp(p, ".NaN", 4) == 0 ||
+                      std::strncmp(p, ".NAN", 4) == 0)) {
+      rhs = std::numeric_limits<double>::quiet_NaN();
+      return true;
+    }
+  }
+
+  char buffer[64];
+
+  if (size == 0 || size >= sizeof(buffer)) {
+    return false;
+  }
+
+  const char point = *std::localeconv()->decimal_point;
+
+  for (std::size_t i = 0; i < size; ++i) {
+    const char c = data[i];
+
+    // reject the forms strtod() accepts but YAML does not (hex floats,
+    // "inf", "nan", embedded spaces).
+    if (!((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' ||
+          c == '-' || c == '+')) {
+      return false;
+    }
+
+    buffer[i] = (c == '.') ? point : c;
+  }
+
+  buffer[size] = '\0';
+
+  char* parsed = nullptr;
+  double value = std::strtod(buffer, &parsed);
+
+  if (parsed != buffer + size) {
+    return false;
+  }
+
+  rhs = value;
+  return true;
+}
+
+enum
+{
+  //! Big enough for any formatInteger() or formatReal() output.
+  NumberLength = 32
+};
+
+/*!
+   \brief Writes value as decimal text to out, which must have room for
+   NumberLength characters. Returns the length written.
+*/
+template<class T>
+inline int formatInteger(T value, char* out)
+{
+  static_assert(std::is_integral<T>::value, "formatInteger requires an integer");
+
+  typedef unsigned long long Magnitude;
+  const bool negative = (value < 0);
+  Magnitude magnitude = negative ? Magnitude(0) - Magnitude(value) : Magnitude(value);
+  char digits[NumberLength];
+  int count = 0;
+
+  do {
+    digits[count++] = char('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  int length = 0;
+
+  if (negative) {
+    out[length++] = '-';
+  }
+
+  while (count > 0) {
+    out[length++] = digits[--count];
+  }
+
+  return length;
+}
+
+/*!
+   \brief Writes value as the shortest YAML text that reads back as the same
+   T to out, which must have room for NumberLength characters. Returns the
+   length written.
+
+   Most values need fewer than max_digits10 digits, so digits10 is tried
+   first, which keeps 0.1 as "0.1". As with toDouble() the locale decimal
+   point is swapped for '.'.
+*/
+template<class T>
+inline int formatReal(T value, char* out)
+{
+  static_assert(std::is_floating_point<T>::value, "formatReal requires a float");
+
+  if (value != value) {
+    std::memcpy(out, ".nan", 4);
+    return 4;
+  }
+
+  if (value == std::numeric_limits<T>::infinity()) {
+    std::memcpy(out, ".inf", 4);
+    return 4;
+  }
+
+  if (value == -std::numeric_limits<T>::infinity()) {
+    std::memcpy(out, "-.inf", 5);
+    return 5;
+  }
+
+  int length = 0;
+
+  for (int digits = std::numeric_limits<T>::digits10;
+       digits <= std::numeric_limits<T>::max_digits10; ++digits) {
+    length = std::snprintf(out, NumberLength, "%.*g", digits, double(value));
+
+    if (T(std::strtod(out, nullptr)) == value) {
+      break;
+    }
+  }
+
+  const char point = *std::localeconv()->decimal_point;
+
+  if (point != '.') {
+    for (int i = 0; i < length; ++i) {
+      if (out[i] == point) {
+        out[i] = '.';
+      }
+    }
+  }
+
+  return length;
+}
+
+/*!
+   \brief Decodes base64 text, skipping the whitespace and line breaks of
+   block scalars, into rhs.
+
+   The output is presized from the input length so only one allocation is
+   made. Returns false on characters outside the base64 alphabet.
+*/
+inline bool decodeBase64(const char* data, std::size_t size, QByteArray& rhs)
+{
+  static const signed char lookup[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -2, -2, -1, -1, -2, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63, //
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -3, -1, -1, //
+    -1, 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, //
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1, //
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, //
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+  }; // -2 whitespace, -3 padding
+
+  rhs.resize(int(size / 4 * 3 + 3));
+  char* out = rhs.data();
+  unsigned accumulator = 0;
+  int bits = 0;
+
+  for (std::size_t i = 0; i < size; ++i) {
+    const signed char value = lookup[static_cast<unsigned char>(data[i])];
+
+    if (value == -2) {
+      continue;
+    }
+
+    if (value == -3) {
+      break;
+    }
+
+    if (value < 0) {
+      rhs.clear();
+      return false;
+    }
+
+    accumulator = (accumulator << 6) | unsigned(value);
+    bits += 6;
+
+    if (bits >= 8) {
+      bits -= 8;
+      *out++ = char((accumulator >> bits) & 0xFF);
+    }
+  }
+
+  rhs.resize(int(out - rhs.data()));
+  return true;
+}
+
+} // end of namespace Scalar
+
+} // end of namespace QYaml
+
+#endif // QYAML_SCALAR_H
@@ -0,0 +1,382 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_SETTINGS_H
+#define QYAML_SETTINGS_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QSettings>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVariant>
+
+#include <istream>
+
+#include <yaml-cpp/yaml.h>
+
+#include "node.h"
+#include "save.h"
+#include "streambuf.h"
+
+namespace QYaml {
+
+/*!
+   \brief Read and write functions for a YAML QSettings format.
+
+   Setting keys are split on '/' and each group becomes a nested mapping, so
+   "window/geometry/width" is stored as
+
+   \code
+   window:
+     geometry:
+       width: 800
+   \endcode
+
+   Values go through YAML::convert<QVariant>, so lists, maps, QColor and
+   QFont are written as YAML structures and everything else as a string.
+   Colours and fonts are tagged, so a group that happens to have their keys
+   is still read back as a group. QByteArray values, such as saveGeometry()
+   and saveState(), are written as !!binary and read back as QByteArray.
+   Other scalars are read back as strings. If a key is also a group, as with
+   "a" and "a/b", its own value is kept under the empty key.
+
+   \code
+   QSettings settings(fileName, QYaml::SettingsFormat::format());
+   \endcode
+
+   QSettings already writes through QSaveFile and batches its own syncs. For
+   writes that are skipped when nothing has changed use SettingsFile.
+*/
+class SettingsFormat
+{
+public:
+  /*!
+     \brief The QSettings format for .yaml files, registered on first use.
+  */
+  static QSettings::Format format() {
+    static const QSettings::Format yamlFormat =
+      QSettings::registerFormat(QStringLiteral("yaml"), &read, &write);
+    return yamlFormat;
+  }
+
+  /*!
+     \brief Parses YAML text into a flat settings map. An empty document
+     gives an empty map. Returns false if the text is not valid YAML or the
+     document is not a mapping.
+  */
+  static bool parse(const QByteArray& data, QSettings::SettingsMap& map) {
+    if (data.trimmed().isEmpty()) {
+      return true;
+    }
+
+    try {
+      ByteArrayStreamBuf buffer(data);
+      std::istream in(&buffer);
+      YAML::Node root = YAML::Load(in);
+
+      if (root.IsNull()) {
+        return true;
+      }
+
+      if (!root.IsMap()) {
+        return false;
+      }
+
+      return flatten(root, QString(), map);
+
+    } catch (const YAML::Exception&) {
+      return false;
+    }
+  }
+
+  /*!
+     \brief Serialises a flat settings map. The output only depends on the
+     map's contents, so it can be compared or hashed.
+  */
+  static QByteArray serialize(const QSettings::SettingsMap& map) {
+    YAML::Emitter out;
+    out << unflatten(map);
+    return QByteArray(out.c_str(), int(out.size()));
+  }
+
+  static bool read(QIODevice& device, QSettings::SettingsMap& map) {
+    return parse(device.readAll(), map);
+  }
+
+  static bool write(QIODevice& device, const QSettings::SettingsMap& map) {
+    const QByteArray data = serialize(map);
+    return device.write(data) == data.size();
+  }
+
+private:
+  static bool flatten(const YAML::Node& node,
+                      const QString& prefix,
+                      QSettings::SettingsMap& map) {
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      if (!it->first.IsScalar()) {
+        return false;
+      }
+
+      const QString name = QString::fromStdString(it->first.Scalar());
+      QString key = prefix;
+
+      if (!name.isEmpty()) {
+        key = prefix.isEmpty() ? name : prefix + QLatin1Char('/') + name;
+      }
+
+      QVariant value;
+
+      if (!YAML::convert<QVariant>::decode(it->second, value)) {
+        return false;
+      }
+
+      // anything that decoded to a plain map is a group rather than a value.
+      if (value.userType() == QMetaType::QVariantMap) {
+        if (!flatten(it->second, key, map)) {
+          return false;
+        }
+
+      } else {
+        map.insert(key, value);
+      }
+    }
+
+    return true;
+  }
+
+  static YAML::Node unflatten(const QSettings::SettingsMap& map) {
+    YAML::Node root(YAML::NodeType::Map);
+
+    for (QSettings::SettingsMap::const_iterator it = map.constBegin();
+         it != map.constEnd(); ++it) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+      const QStringList groups = it.key().split(QLatin1Char('/'), Qt::SkipEmptyParts);
+#else
+      const QStringList groups =
+        it.key().split(QLatin1Char('/'), QString::SkipEmptyParts);
+#endif
+
+      if (groups.isEmpty()) {
+        continue;
+      }
+
+      // reset() moves the handle down the tree, assigning would overwrite
+      // the parent node instead.
+      YAML::Node current;
+      current.reset(root);
+
+      for (int i = 0; i < groups.size(); ++i) {
+        YAML::Node child = current[groups.at(i).toStdString()];
+        const bool leaf = (i == groups.size() - 1);
+
+        if (child.IsDefined() && !child.IsMap()) {
+          // a value that is also a group, SettingsMap is sorted so the
+          // value is always seen first.
+          YAML::Node value = YAML::Clone(child);
+          child = YAML::Node(YAML::NodeType::Map);
+          child[""] = value;
+
+        } else if (!child.IsDefined() && !leaf) {
+          child = YAML::Node(YAML::NodeType::Map);
+        }
+
+        if (leaf) {
+          if (child.IsMap()) {
+            child[""] = it.value();
+          } else {
+            child = it.value();
+          }
+        }
+
+        current.reset(child);
+      }
+    }
+
+    return root;
+  }
+};
+
+/*!
+   \brief A YAML settings file with coalesced, atomic writes.
+
+   QSettings rewrites the whole file on every sync. SettingsFile keeps the
+   values in memory and writes them a short delay after the last change, so a
+   burst of setValue() calls costs a single write. Writes go through SaveFile,
+   so unchanged content is not written at all and a crash never leaves a
+   truncated file behind.
+
+   \code
+   QYaml::SettingsFile settings(configPath);
+   settings.setValue("window/geometry", saveGeometry());
+   settings.setValue("window/font", font());
+   // written once, 200ms later, or when settings is destroyed.
+   \endcode
+
+   The delayed write needs a running event loop. Without one call sync()
+   yourself. The destructor always syncs. Not thread safe.
+*/
+class SettingsFile
+{
+public:
+  explicit SettingsFile(const QString& fileName, int delay = 200)
+    : m_file(fileName)
+    , m_status(QSettings::NoError)
+    , m_dirty(false) {
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(delay);
+    QObject::connect(&m_timer, &QTimer::timeout, &m_timer, [this]() { sync(); });
+    reload();
+  }
+
+  ~SettingsFile() { sync(); }
+
+  SettingsFile(const SettingsFile&) = delete;
+  SettingsFile& operator=(const SettingsFile&) = delete;
+
+  QString fileName() const { return m_file.fileName(); }
+  QSettings::Status status() const { return m_status; }
+
+  /*!
+     \brief The time in milliseconds between the last change and the write.
+  */
+  int delay() const { return m_timer.interval(); }
+  void setDelay(int delay) { m_timer.setInterval(delay); }
+
+  void beginGroup(const QString& prefix) { m_groups.append(prefix); }
+  void endGroup() {
+    if (!m_groups.isEmpty()) {
+      m_groups.removeLast();
+    }
+  }
+  QString group() const { return m_groups.join(QLatin1Char('/')); }
+
+  bool contains(const QString& key) const {
+    return m_values.contains(fullKey(key));
+  }
+
+  QStringList allKeys() const { return m_values.keys(); }
+
+  QVariant value(const QString& key,
+                 const QVariant& defaultValue = QVariant()) const {
+    return m_values.value(fullKey(key), defaultValue);
+  }
+
+  void setValue(const QString& key, const QVariant& value) {
+    m_values.insert(fullKey(key), value);
+    changed();
+  }
+
+  /*!
+     \brief Removes key and any keys in the group of the same name.
+  */
+  void remove(const QString& key) {
+    const QString name = fullKey(key);
+    const QString prefix = name + QLatin1Char('/');
+    QSettings::SettingsMap::iterator it = m_values.lowerBound(name);
+
+    while (it != m_values.end() &&
+           (it.key() == name || it.key().startsWith(prefix))) {
+      it = m_values.erase(it);
+    }
+
+    changed();
+  }
+
+  /*!
+     \brief Writes any pending changes now. Returns false if the file could
+     not be written, true if it was written or nothing had changed.
+  */
+  bool sync() {
+    m_timer.stop();
+
+    if (!m_dirty) {
+      return m_status == QSettings::NoError;
+    }
+
+    m_dirty = false;
+
+    if (m_file.write(SettingsFormat::serialize(m_values)) == SaveFile::Error) {
+      m_status = QSettings::AccessError;
+      return false;
+    }
+
+    m_status = QSettings::NoError;
+    return true;
+  }
+
+  /*!
+     \brief Discards pending changes and reads the file again.
+  */
+  bool reload() {
+    m_timer.stop();
+    m_dirty = false;
+    m_values.clear();
+    m_file.reset();
+    m_status = QSettings::NoError;
+
+    QFile file(m_file.fileName());
+
+    if (!file.exists()) {
+      return true;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+      m_status = QSettings::AccessError;
+      return false;
+    }
+
+    const QByteArray data = file.readAll();
+
+    if (!SettingsFormat::parse(data, m_values)) {
+      m_status = QSettings::FormatError;
+      return false;
+    }
+
+    return true;
+  }
+
+private:
+  QString fullKey(const QString& key) const {
+    return m_groups.isEmpty() ? key : group() + QLatin1Char('/') + key;
+  }
+
+  void changed() {
+    m_dirty = true;
+    m_timer.start();
+  }
+
+  SaveFile m_file;
+  QSettings::SettingsMap m_values;
+  QStringList m_groups;
+  QTimer m_timer;
+  QSettings::Status m_status;
+  bool m_dirty;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_SETTINGS_H
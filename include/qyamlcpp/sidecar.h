@@ -0,0 +1,416 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_SIDECAR_H
+#define QYAML_SIDECAR_H
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QIODevice>
+#include <QPixmap>
+#include <QSaveFile>
+#include <QString>
+
+#include <climits>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include "hash.h"
+#include "node.h"
+
+namespace QYaml {
+
+/*!
+   \brief Thrown by SidecarWriter when a value cannot be written to the
+   sidecar file.
+*/
+class SidecarException : public YAML::Exception
+{
+public:
+  explicit SidecarException(const QString& message)
+    : YAML::Exception(YAML::Mark::null_mark(), message.toStdString()) {}
+};
+
+/*!
+   \brief Writes large binary values to a separate blob file and puts a
+   reference to them in the YAML.
+
+   Values smaller than the threshold are encoded as normal !!binary scalars.
+   Larger ones are appended to the sidecar file and replaced by
+
+   \code
+   image: {sidecar: project.blobs, offset: 8, length: 482113, xxh64: 5f0e3c2a91d7b640}
+   \endcode
+
+   Identical values are only stored once. They are matched on their XXH64
+   hash and length without comparing the bytes, so two different values
+   that collide on both would share one blob. The sidecar is written through
+   QSaveFile, so nothing replaces the old file until commit().
+
+   If a value cannot be written encode() throws SidecarException. The
+   writer then refuses any further large values, and commit() leaves the
+   old file in place.
+
+   \code
+   QYaml::SidecarWriter blobs(path + ".blobs");
+   blobs.open();
+
+   out << YAML::Key << "image" << YAML::Value << blobs.encode(image);
+   ...
+   blobs.commit();
+   \endcode
+*/
+class SidecarWriter
+{
+public:
+  static const char* magic() { return "QYAMLBLB"; }
+
+  explicit SidecarWriter(const QString& fileName, qint64 threshold = 64 * 1024)
+    : m_file(fileName)
+    , m_name(QFileInfo(fileName).fileName().toStdString())
+    , m_threshold(threshold)
+    , m_offset(0)
+    , m_failed(false) {}
+
+  SidecarWriter(const SidecarWriter&) = delete;
+  SidecarWriter& operator=(const SidecarWriter&) = delete;
+
+  QString fileName() const { return m_file.fileName(); }
+  QString errorString() const { return m_file.errorString(); }
+
+  /*!
+     \brief True if a write to the sidecar failed since open().
+  */
+  bool hasError() const { return m_failed; }
+
+  /*!
+     \brief Values of at least this many bytes go into the sidecar.
+  */
+  qint64 threshold() const { return m_threshold; }
+  void setThreshold(qint64 threshold) { m_threshold = threshold; }
+
+  bool open() {
+    m_blobs.clear();
+    m_failed = true;
+
+    if (!m_file.open(QIODevice::WriteOnly)) {
+      return false;
+    }
+
+    const qint64 size = qint64(qstrlen(magic()));
+    m_offset = m_file.write(magic(), size);
+
+    if (m_offset != size) {
+      m_file.cancelWriting();
+      return false;
+    }
+
+    m_failed = false;
+    return true;
+  }
+
+  /*!
+     \brief Replaces the sidecar file with everything written since open().
+     Returns false, and keeps the old file, if any write failed.
+  */
+  bool commit() { return !m_failed && m_file.commit(); }
+
+  YAML::Node encode(const QByteArray& data) {
+    if (data.size() < m_threshold) {
+      return YAML::convert<QByteArray>::encode(data);
+    }
+
+    return store(data.constData(), data.size());
+  }
+
+  YAML::Node encode(const QImage& image, const char* format = "PNG") {
+    return encode(save(image, format));
+  }
+
+  YAML::Node encode(const QPixmap& pixmap, const char* format = "PNG") {
+    return encode(save(pixmap, format));
+  }
+
+private:
+  struct Blob
+  {
+    qint64 offset;
+    qint64 length;
+  };
+
+  template<class Image>
+  static QByteArray save(const Image& image, const char* format) {
+    QByteArray array;
+    QBuffer buffer(&array);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, format);
+    return array;
+  }
+
+  YAML::Node store(const char* data, qint64 length) {
+    if (m_failed) {
+      throw SidecarException(QStringLiteral("%1 is not open for writing").arg(fileName()));
+    }
+
+    const quint64 hash = XXHash64::hash(data, std::size_t(length));
+    QHash<quint64, Blob>::const_iterator it = m_blobs.constFind(hash);
+    Blob blob;
+
+    if (it != m_blobs.constEnd() && it->length == length) {
+      blob = *it;
+    } else {
+      blob.offset = m_offset;
+      blob.length = length;
+
+      if (m_file.write(data, length) != length) {
+        m_failed = true;
+        m_file.cancelWriting();
+        throw SidecarException(QStringLiteral("cannot write to %1: %2")
+                                 .arg(fileName(), errorString()));
+      }
+
+      m_offset += length;
+      m_blobs.insert(hash, blob);
+    }
+
+    YAML::Node node(YAML::NodeType::Map);
+    node.force_insert("sidecar", m_name);
+    node.force_insert("offset", blob.offset);
+    node.force_insert("length", blob.length);
+    node.force_insert("xxh64", QByteArray::number(hash, 16).toStdString());
+    return node;
+  }
+
+  QSaveFile m_file;
+  std::string m_name;
+  qint64 m_threshold;
+  qint64 m_offset;
+  bool m_failed;
+  QHash<quint64, Blob> m_blobs;
+};
+
+/*!
+   \brief Reads values written by SidecarWriter from a memory mapped
+   sidecar file.
+
+   Referenced values are not base64 decoded or even copied: a QByteArray
+   read from the sidecar points straight into the mapping and is only valid
+   while the reader is open. Images are decoded directly from the mapping.
+   Values stored inline as !!binary scalars are decoded as usual.
+
+   \code
+   QYaml::SidecarReader blobs(path + ".blobs");
+   blobs.open();
+
+   QImage image;
+   blobs.decode(doc["image"], image);
+   \endcode
+
+   By default the xxh64 in a reference is checked, which reads every page
+   of the value, so a truncated or rewritten sidecar is noticed. Turn off
+   setVerify() to skip the check where the file is trusted.
+*/
+class SidecarReader
+{
+public:
+  explicit SidecarReader(const QString& fileName)
+    : m_file(fileName)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_verify(true) {}
+
+  ~SidecarReader() { close(); }
+
+  SidecarReader(const SidecarReader&) = delete;
+  SidecarReader& operator=(const SidecarReader&) = delete;
+
+  bool verify() const { return m_verify; }
+  void setVerify(bool verify) { m_verify = verify; }
+
+  bool open() {
+    close();
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+      return false;
+    }
+
+    m_size = m_file.size();
+    const qint64 header = qint64(qstrlen(SidecarWriter::magic()));
+
+    if (m_size < header) {
+      close();
+      return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+
+    if (!m_data || qstrncmp(reinterpret_cast<const char*>(m_data),
+                            SidecarWriter::magic(), uint(header)) != 0) {
+      close();
+      return false;
+    }
+
+    return true;
+  }
+
+  void close() {
+    if (m_data) {
+      m_file.unmap(m_data);
+      m_data = nullptr;
+    }
+
+    m_size = 0;
+    m_file.close();
+  }
+
+  bool isOpen() const { return m_data != nullptr; }
+
+  /*!
+     \brief True if node is a sidecar reference rather than a value.
+  */
+  static bool isReference(const YAML::Node& node) {
+    return node.IsMap() && node["sidecar"] && node["offset"] && node["length"];
+  }
+
+  /*!
+     \brief Reads a value without copying it. For a reference the result
+     points into the mapping and is only valid while the reader is open.
+     References to blobs over INT_MAX bytes fail to decode.
+  */
+  bool decode(const YAML::Node& node, QByteArray& rhs) const {
+    if (!isReference(node)) {
+      return YAML::convert<QByteArray>::decode(node, rhs);
+    }
+
+    const char* data = nullptr;
+    qint64 length = 0;
+
+    if (!resolve(node, data, length)) {
+      return false;
+    }
+
+    rhs = QByteArray::fromRawData(data, int(length));
+    return true;
+  }
+
+  bool decode(const YAML::Node& node, QImage& rhs) const {
+    if (!isReference(node)) {
+      return YAML::convert<QImage>::decode(node, rhs);
+    }
+
+    const char* data = nullptr;
+    qint64 length = 0;
+
+    if (!resolve(node, data, length)) {
+      return false;
+    }
+
+    QImage image;
+
+    if (!image.loadFromData(reinterpret_cast<const uchar*>(data), int(length))) {
+      return false;
+    }
+
+    rhs = image;
+    return true;
+  }
+
+  bool decode(const YAML::Node& node, QPixmap& rhs) const {
+    if (!isReference(node)) {
+      return YAML::convert<QPixmap>::decode(node, rhs);
+    }
+
+    const char* data = nullptr;
+    qint64 length = 0;
+
+    if (!resolve(node, data, length)) {
+      return false;
+    }
+
+    QPixmap pixmap;
+
+    if (!pixmap.loadFromData(reinterpret_cast<const uchar*>(data), uint(length))) {
+      return false;
+    }
+
+    rhs = pixmap;
+    return true;
+  }
+
+private:
+  bool resolve(const YAML::Node& node, const char*& data, qint64& length) const {
+    if (!m_data) {
+      return false;
+    }
+
+    qint64 offset = 0;
+
+    try {
+      offset = node["offset"].as<qint64>();
+      length = node["length"].as<qint64>();
+    } catch (const YAML::Exception&) {
+      return false;
+    }
+
+    if (offset < 0 || length < 0 || offset > m_size || length > m_size - offset) {
+      return false;
+    }
+
+    // QByteArray, QImage and QPixmap take an int size, so a longer blob
+    // would be truncated rather than read.
+    if (length > INT_MAX) {
+      return false;
+    }
+
+    data = reinterpret_cast<const char*>(m_data + offset);
+
+    if (m_verify) {
+      const YAML::Node hash = node["xxh64"];
+      bool ok = false;
+
+      if (!hash.IsScalar() ||
+          QByteArray::fromStdString(hash.Scalar()).toULongLong(&ok, 16) !=
+            XXHash64::hash(data, std::size_t(length)) ||
+          !ok) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  QFile m_file;
+  uchar* m_data;
+  qint64 m_size;
+  bool m_verify;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_SIDECAR_H
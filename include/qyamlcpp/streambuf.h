@@ -0,0 +1,91 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_STREAMBUF_H
+#define QYAML_STREAMBUF_H
+
+#include <QByteArray>
+
+#include <cstddef>
+#include <streambuf>
+
+namespace QYaml {
+
+/*!
+   \brief A read only std::streambuf over an existing block of memory.
+
+   yaml-cpp only parses from a std::istream, and std::istringstream would copy
+   the whole input into a std::string first. This lets the parser read
+   straight out of a QByteArray or a memory mapped file instead. The memory
+   must stay valid for as long as the buffer is in use.
+*/
+class ByteArrayStreamBuf : public std::streambuf
+{
+public:
+  ByteArrayStreamBuf(const char* data, std::size_t size) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+
+  explicit ByteArrayStreamBuf(const QByteArray& data)
+    : ByteArrayStreamBuf(data.constData(), std::size_t(data.size())) {}
+
+protected:
+  pos_type seekoff(off_type offset,
+                   std::ios_base::seekdir direction,
+                   std::ios_base::openmode which) override {
+    if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+
+    char* target = nullptr;
+
+    switch (direction) {
+      case std::ios_base::beg:
+        target = eback() + offset;
+        break;
+      case std::ios_base::cur:
+        target = gptr() + offset;
+        break;
+      default:
+        target = egptr() + offset;
+        break;
+    }
+
+    if (target < eback() || target > egptr()) {
+      return pos_type(off_type(-1));
+    }
+
+    setg(eback(), target, egptr());
+    return pos_type(off_type(target - eback()));
+  }
+
+  pos_type seekpos(pos_type position, std::ios_base::openmode which) override {
+    return seekoff(off_type(position), std::ios_base::beg, which);
+  }
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_STREAMBUF_H
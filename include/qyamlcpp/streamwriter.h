@@ -0,0 +1,517 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef QYAML_STREAMWRITER_H
+#define QYAML_STREAMWRITER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFileDevice>
+#include <QIODevice>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <yaml-cpp/yaml.h>
+
+#include "emitterpool.h"
+
+namespace QYaml {
+
+/*!
+   \brief Appends "---" separated YAML documents to an open QIODevice.
+
+   Documents are serialised with reusable emitters into a fixed size ring
+   buffer and written to the device in large blocks, when flushSize() bytes
+   are waiting or the oldest waiting document is flushInterval() milliseconds
+   old, rather than with one write per document. In Background mode the
+   writes happen on a thread of their own, so write() only blocks when the
+   ring buffer is full.
+
+   \code
+   QFile log(path);
+   log.open(QIODevice::WriteOnly | QIODevice::Append);
+
+   QYaml::StreamWriter writer(&log, QYaml::StreamWriter::Background);
+   writer.setSyncPolicy(QYaml::StreamWriter::SyncOnFlush);
+
+   writer.write(event);   // anything with an Emitter overload or converter
+   writer.write(node);
+   ...
+   writer.close();        // or let the destructor do it
+   \endcode
+
+   In Direct mode the interval is only checked when a document is written,
+   so call flush() when a quiet period matters. write() may be called from
+   several threads, each document is written whole. The device is not owned
+   and is not closed. After a write error nothing more is written and
+   errorString() says why.
+*/
+class StreamWriter
+{
+public:
+  enum Mode
+  {
+    //! Writes to the device on the thread that fills the buffer.
+    Direct,
+    //! Writes to the device on a thread owned by the writer.
+    Background
+  };
+
+  enum SyncPolicy
+  {
+    //! Hands the data to the operating system, but never waits for the disk.
+    NoSync,
+    //! Syncs a QFileDevice to disk after every flush.
+    SyncOnFlush,
+    //! Syncs a QFileDevice to disk once, in close().
+    SyncOnClose
+  };
+
+  explicit StreamWriter(QIODevice* device, Mode mode = Direct, int capacity = 1 << 20)
+    : m_device(device)
+    , m_mode(mode)
+    , m_capacity(std::max(capacity, 4096))
+    , m_flushSize(std::min(64 * 1024, m_capacity / 2))
+    , m_interval(1000)
+    , m_policy(NoSync)
+    , m_head(0)
+    , m_size(0)
+    , m_requested(0)
+    , m_completed(0)
+    , m_writing(false)
+    , m_unsynced(false)
+    , m_failed(false)
+    , m_stopping(false)
+    , m_closed(false) {
+    m_ring.resize(m_capacity);
+    m_data = m_ring.data();
+    m_pendingSince.start();
+
+    if (m_mode == Background) {
+      m_thread.reset(new Thread(this));
+      m_thread->start();
+    }
+  }
+
+  ~StreamWriter() { close(); }
+
+  StreamWriter(const StreamWriter&) = delete;
+  StreamWriter& operator=(const StreamWriter&) = delete;
+
+  QIODevice* device() const { return m_device; }
+  Mode mode() const { return m_mode; }
+
+  /*!
+     \brief The number of waiting bytes that starts a flush. The default is
+     64KiB, or half the buffer if that is smaller.
+  */
+  int flushSize() const {
+    QMutexLocker locker(&m_mutex);
+    return m_flushSize;
+  }
+
+  void setFlushSize(int bytes) {
+    QMutexLocker locker(&m_mutex);
+    m_flushSize = std::max(1, std::min(bytes, m_capacity));
+    m_wake.wakeAll();
+  }
+
+  /*!
+     \brief The longest time in milliseconds a document waits in the buffer.
+     The default is one second, 0 flushes by size only.
+  */
+  int flushInterval() const {
+    QMutexLocker locker(&m_mutex);
+    return m_interval;
+  }
+
+  void setFlushInterval(int msec) {
+    QMutexLocker locker(&m_mutex);
+    m_interval = std::max(0, msec);
+    m_wake.wakeAll();
+  }
+
+  SyncPolicy syncPolicy() const {
+    QMutexLocker locker(&m_mutex);
+    return m_policy;
+  }
+
+  void setSyncPolicy(SyncPolicy policy) {
+    QMutexLocker locker(&m_mutex);
+    m_policy = policy;
+  }
+
+  /*!
+     \brief The number of bytes waiting to be written.
+  */
+  int pending() const {
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+  }
+
+  QString errorString() const {
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+  }
+
+  /*!
+     \brief Appends value as the next document. Returns false if it could not
+     be emitted, or the writer has failed or been closed. value is taken by
+     forwarding reference as most of the Emitter overloads are not const.
+  */
+  template<class T>
+  bool write(T&& value) {
+    EmitterPool::Lease emitter = m_emitters.acquire();
+    emitter->begin() << value;
+
+    if (!emitter->good()) {
+      QMutexLocker locker(&m_mutex);
+      m_error = emitter->lastError();
+      return false;
+    }
+
+    return writeDocument(emitter->data());
+  }
+
+  /*!
+     \brief Appends a document that has already been serialised. The "---"
+     is added, document must not contain one.
+  */
+  bool writeDocument(const QByteArray& document) {
+    QMutexLocker producer(&m_producer);
+    QMutexLocker locker(&m_mutex);
+
+    if (!writable()) {
+      return false;
+    }
+
+    put(locker, "---\n", 4);
+    put(locker, document.constData(), document.size());
+
+    if (!document.endsWith('\n')) {
+      put(locker, "\n", 1);
+    }
+
+    if (m_failed) {
+      return false;
+    }
+
+    if (m_size >= m_flushSize || expired()) {
+      if (m_mode == Background) {
+        m_wake.wakeAll();
+      } else {
+        drain(locker, m_policy == SyncOnFlush);
+      }
+    }
+
+    return !m_failed;
+  }
+
+  /*!
+     \brief Writes everything in the buffer to the device, and syncs it if
+     the policy is SyncOnFlush. In Background mode waits for the writer
+     thread to do so.
+  */
+  bool flush() {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_closed) {
+      return !m_failed;
+    }
+
+    if (m_mode == Direct) {
+      drain(locker, m_policy == SyncOnFlush);
+      return !m_failed;
+    }
+
+    const quint64 request = ++m_requested;
+    m_wake.wakeAll();
+
+    while (m_completed < request && !m_failed) {
+      m_space.wait(&m_mutex);
+    }
+
+    return !m_failed;
+  }
+
+  /*!
+     \brief Writes everything in the buffer, syncs the device unless the
+     policy is NoSync and stops the writer thread. Later writes fail.
+  */
+  bool close() {
+    QMutexLocker producer(&m_producer);
+    QMutexLocker locker(&m_mutex);
+
+    if (m_closed) {
+      return !m_failed;
+    }
+
+    m_closed = true;
+
+    if (m_mode == Direct) {
+      drain(locker, m_policy != NoSync);
+      return !m_failed;
+    }
+
+    m_stopping = true;
+    m_wake.wakeAll();
+    locker.unlock();
+    m_thread->wait();
+    locker.relock();
+    return !m_failed;
+  }
+
+private:
+  class Thread : public QThread
+  {
+  public:
+    explicit Thread(StreamWriter* writer)
+      : m_writer(writer) {}
+
+  protected:
+    void run() override { m_writer->run(); }
+
+  private:
+    StreamWriter* m_writer;
+  };
+
+  bool writable() {
+    if (m_closed) {
+      m_error = QStringLiteral("the stream writer has been closed");
+      return false;
+    }
+
+    if (!m_device || !m_device->isWritable()) {
+      m_error = QStringLiteral("the device is not open for writing");
+      return false;
+    }
+
+    return !m_failed;
+  }
+
+  bool expired() const {
+    return m_interval > 0 && m_size > 0 && m_pendingSince.elapsed() >= m_interval;
+  }
+
+  // copies into the free part of the ring, making room when it is full.
+  // Only one producer at a time gets here, so a document is never split by
+  // another one.
+  void put(QMutexLocker& locker, const char* s, int count) {
+    while (count > 0 && !m_failed) {
+      if (m_size == m_capacity) {
+        if (m_mode == Background) {
+          m_wake.wakeAll();
+          m_space.wait(&m_mutex);
+        } else {
+          drain(locker, m_policy == SyncOnFlush);
+        }
+
+        continue;
+      }
+
+      if (m_size == 0) {
+        m_pendingSince.restart();
+
+        // the writer thread waits without a timeout while the ring is empty.
+        if (m_mode == Background) {
+          m_wake.wakeAll();
+        }
+      }
+
+      const int tail = (m_head + m_size) % m_capacity;
+      const int n = std::min(count, std::min(m_capacity - m_size, m_capacity - tail));
+      std::memcpy(m_data + tail, s, std::size_t(n));
+      m_size += n;
+      s += n;
+      count -= n;
+    }
+  }
+
+  // writes what is in the ring when it is called. The lock is released
+  // around the device writes, producers only touch the free part of the ring
+  // in the meantime.
+  void drain(QMutexLocker& locker, bool sync) {
+    while (m_writing) {
+      m_space.wait(&m_mutex);
+    }
+
+    m_writing = true;
+    int remaining = m_size;
+
+    while (remaining > 0 && !m_failed) {
+      const int start = m_head;
+      const int n = std::min(remaining, m_capacity - start);
+
+      locker.unlock();
+      const bool written = writeAll(m_data + start, n);
+      locker.relock();
+
+      if (!written) {
+        fail(m_device->errorString());
+        break;
+      }
+
+      m_head = (m_head + n) % m_capacity;
+      m_size -= n;
+      remaining -= n;
+      m_unsynced = true;
+      m_space.wakeAll();
+    }
+
+    if (m_size > 0) {
+      m_pendingSince.restart();
+    }
+
+    if (!m_failed && sync && m_unsynced) {
+      locker.unlock();
+      const bool synced = syncDevice();
+      locker.relock();
+
+      if (synced) {
+        m_unsynced = false;
+      } else {
+        fail(QStringLiteral("could not sync the device"));
+      }
+    }
+
+    m_writing = false;
+    m_space.wakeAll();
+  }
+
+  bool writeAll(const char* data, int count) {
+    while (count > 0) {
+      const qint64 written = m_device->write(data, count);
+
+      if (written <= 0) {
+        return false;
+      }
+
+      data += written;
+      count -= int(written);
+    }
+
+    // QFile has a buffer of its own.
+    QFileDevice* file = qobject_cast<QFileDevice*>(m_device);
+    return !file || file->flush();
+  }
+
+  bool syncDevice() {
+    QFileDevice* file = qobject_cast<QFileDevice*>(m_device);
+
+    if (!file || file->handle() < 0) {
+      return true;
+    }
+
+#if defined(Q_OS_WIN)
+    return ::_commit(file->handle()) == 0;
+#else
+    return ::fsync(file->handle()) == 0;
+#endif
+  }
+
+  // anything still in the buffer is dropped, so producers waiting for room
+  // are released.
+  void fail(const QString& error) {
+    m_error = error;
+    m_failed = true;
+    m_head = 0;
+    m_size = 0;
+    m_space.wakeAll();
+  }
+
+  void run() {
+    QMutexLocker locker(&m_mutex);
+
+    while (true) {
+      if (!m_stopping && m_completed == m_requested && m_size < m_flushSize &&
+          !expired()) {
+        if (m_size > 0 && m_interval > 0) {
+          // the interval may have run out since expired(), and a negative
+          // time would wrap round to waiting forever.
+          const qint64 remaining =
+            std::max<qint64>(1, m_interval - m_pendingSince.elapsed());
+          m_wake.wait(&m_mutex, (unsigned long)remaining);
+        } else {
+          m_wake.wait(&m_mutex);
+        }
+
+        continue;
+      }
+
+      const quint64 request = m_requested;
+      drain(locker, m_policy == SyncOnFlush || (m_stopping && m_policy != NoSync));
+      m_completed = request;
+      m_space.wakeAll();
+
+      if (m_stopping) {
+        return;
+      }
+    }
+  }
+
+  QIODevice* m_device;
+  Mode m_mode;
+  int m_capacity;
+  int m_flushSize;
+  int m_interval;
+  SyncPolicy m_policy;
+  QString m_error;
+
+  EmitterPool m_emitters;
+  QByteArray m_ring;
+  char* m_data;
+  int m_head;
+  int m_size;
+  QElapsedTimer m_pendingSince;
+
+  mutable QMutex m_mutex;
+  QMutex m_producer;
+  QWaitCondition m_wake;
+  QWaitCondition m_space;
+  std::unique_ptr<Thread> m_thread;
+  quint64 m_requested;
+  quint64 m_completed;
+  bool m_writing;
+  bool m_unsynced;
+  bool m_failed;
+  bool m_stopping;
+  bool m_closed;
+};
+
+} // end of namespace QYaml
+
+#endif // QYAML_STREAMWRITER_H
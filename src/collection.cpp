@@ -0,0 +1,45 @@
+/*
+   Copyright 2013-2020 Simon Meaden
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#include <qyamlcpp/collection.h>
+
+namespace YAML {
+
+// keep in step with the extern template declarations in collection.h
+template struct convert<QList<int>>;
+template struct convert<QList<double>>;
+template struct convert<QList<QString>>;
+template struct convert<QVector<int>>;
+template struct convert<QVector<double>>;
+template struct convert<QVector<QString>>;
+template struct convert<QSet<int>>;
+template struct convert<QSet<QString>>;
+template struct convert<QMap<QString, int>>;
+template struct convert<QMap<QString, QString>>;
+template struct convert<QMap<QString, QVariant>>;
+template struct convert<QHash<QString, int>>;
+template struct convert<QHash<QString, QString>>;
+template struct convert<QHash<QString, QVariant>>;
+
+} // end of namespace YAML
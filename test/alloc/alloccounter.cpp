@@ -0,0 +1,168 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#include "alloccounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#define QYAML_ALLOC_MALLOC_HOOKS 1
+#endif
+
+namespace {
+
+// plain zero initialised thread locals, so reading them never allocates.
+thread_local bool t_counting = false;
+thread_local AllocCounter::Counts t_counts = { 0, 0 };
+
+inline void record(std::size_t size)
+{
+  if (t_counting) {
+    ++t_counts.allocations;
+    t_counts.bytes += size;
+  }
+}
+
+} // end of anonymous namespace
+
+#if defined(QYAML_ALLOC_MALLOC_HOOKS)
+
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(std::size_t size)
+{
+  record(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+  record(count * size);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size)
+{
+  if (size != 0) {
+    record(size);
+  }
+
+  return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer)
+{
+  __libc_free(pointer);
+}
+}
+
+#define QYAML_ALLOC_RAW(size) __libc_malloc(size)
+#define QYAML_FREE_RAW(pointer) __libc_free(pointer)
+
+#else
+
+#define QYAML_ALLOC_RAW(size) std::malloc(size)
+#define QYAML_FREE_RAW(pointer) std::free(pointer)
+
+#endif
+
+// operator new is replaced on every platform. It allocates through the raw
+// functions so an allocation is never counted twice.
+void* operator new(std::size_t size)
+{
+  record(size);
+  void* pointer = QYAML_ALLOC_RAW(size ? size : 1);
+
+  if (!pointer) {
+    throw std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  record(size);
+  return QYAML_ALLOC_RAW(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept
+{
+  QYAML_FREE_RAW(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+  QYAML_FREE_RAW(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  QYAML_FREE_RAW(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+  QYAML_FREE_RAW(pointer);
+}
+
+namespace AllocCounter {
+
+void start()
+{
+  t_counts = Counts{ 0, 0 };
+  t_counting = true;
+}
+
+Counts stop()
+{
+  t_counting = false;
+  return t_counts;
+}
+
+bool interceptsMalloc()
+{
+#if defined(QYAML_ALLOC_MALLOC_HOOKS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // end of namespace AllocCounter
@@ -0,0 +1,56 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstdint>
+
+/*!
+   \brief Counts heap allocations made by the calling thread.
+
+   alloccounter.cpp replaces the global operator new and, on glibc, malloc,
+   calloc and realloc, so allocations made inside Qt's containers are seen as
+   well as those made by yaml-cpp. Only allocations made between start() and
+   stop() on the same thread are counted.
+*/
+namespace AllocCounter {
+
+struct Counts
+{
+  std::uint64_t allocations;
+  std::uint64_t bytes;
+};
+
+void start();
+Counts stop();
+
+/*!
+   \brief True if malloc is intercepted as well as operator new.
+*/
+bool interceptsMalloc();
+
+} // end of namespace AllocCounter
+
+#endif // ALLOCCOUNTER_H
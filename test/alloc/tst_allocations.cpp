@@ -0,0 +1,1112 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   Allocation and copy budgets for the converters.
+
+   yaml-cpp's own cost of reading or building nodes depends on its version,
+   so each budget is expressed relative to a baseline measured in the same
+   run, e.g. "QVector<int> decode of N elements makes no more than the
+   allocations of N node reads plus 2".
+*/
+#include <QBuffer>
+#include <QByteArray>
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QList>
+#include <QMap>
+#include <QPixmap>
+#include <QPoint>
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QSet>
+#include <QSize>
+#include <QSizeF>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <QtTest>
+
+#include <initializer_list>
+
+#include <yaml-cpp/yaml.h>
+
+#include <qyamlcpp/emitterpool.h>
+#include <qyamlcpp/intern.h>
+#include <qyamlcpp/qyamlcpp.h>
+
+#include "alloccounter.h"
+
+/* = Counted
+   ==========================================================================================*/
+/*
+   An element type that counts how often it is copied.
+*/
+struct Counted
+{
+  Counted()
+    : value(0) {}
+  explicit Counted(int v)
+    : value(v) {}
+  Counted(const Counted& other)
+    : value(other.value) {
+    ++copies;
+  }
+  Counted(Counted&& other) noexcept
+    : value(other.value) {}
+  Counted& operator=(const Counted& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  Counted& operator=(Counted&& other) noexcept {
+    value = other.value;
+    return *this;
+  }
+
+  int value;
+  static int copies;
+};
+
+int Counted::copies = 0;
+
+namespace YAML {
+
+template<>
+struct convert<Counted>
+{
+  static Node encode(const Counted& rhs) { return Node(rhs.value); }
+
+  static bool decode(const Node& node, Counted& rhs) {
+    if (!node.IsScalar()) {
+      return false;
+    }
+
+    rhs.value = node.as<int>();
+    return true;
+  }
+};
+
+} // end of namespace YAML
+
+/* = Helpers
+   ==========================================================================================*/
+/*
+   Runs f once to settle any lazily created statics, then counts the
+   allocations of a second run.
+*/
+template<class F>
+static AllocCounter::Counts measure(F f)
+{
+  f();
+  AllocCounter::start();
+  f();
+  return AllocCounter::stop();
+}
+
+static YAML::Node intSequence(int count)
+{
+  YAML::Node node(YAML::NodeType::Sequence);
+
+  for (int i = 0; i < count; ++i) {
+    node.push_back(i);
+  }
+
+  return node;
+}
+
+static YAML::Node stringIntMap(int count)
+{
+  YAML::Node node(YAML::NodeType::Map);
+
+  for (int i = 0; i < count; ++i) {
+    node.force_insert(QStringLiteral("key%1").arg(i), i);
+  }
+
+  return node;
+}
+
+// the cost of reading every element of a sequence, and nothing else.
+static AllocCounter::Counts sequenceReads(const YAML::Node& node)
+{
+  return measure([&node]() {
+    int sum = 0;
+
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      sum += it->as<int>();
+    }
+
+    volatile int result = sum;
+    Q_UNUSED(result);
+  });
+}
+
+// the cost of reading the given keys of a map as T.
+template<class T>
+static AllocCounter::Counts fieldReads(const YAML::Node& node,
+                                       std::initializer_list<const char*> keys)
+{
+  return measure([&node, keys]() {
+    for (const char* key : keys) {
+      T value = node[key].as<T>();
+      Q_UNUSED(value);
+    }
+  });
+}
+
+// the cost of building a map of the given keys, all set to value.
+template<class T>
+static AllocCounter::Counts fieldWrites(std::initializer_list<const char*> keys,
+                                        const T& value)
+{
+  return measure([keys, &value]() {
+    YAML::Node node;
+
+    for (const char* key : keys) {
+      node[key] = value;
+    }
+  });
+}
+
+static QImage sampleImage()
+{
+  QImage image(64, 64, QImage::Format_ARGB32);
+  image.fill(QColor(10, 20, 30, 255));
+  return image;
+}
+
+static QByteArray png(const QImage& image)
+{
+  QByteArray array;
+  QBuffer buffer(&array);
+  buffer.open(QIODevice::WriteOnly);
+  image.save(&buffer, "PNG");
+  return array;
+}
+
+#define CHECK_BUDGET(counts, budget)                                           \
+  QVERIFY2((counts).allocations <= quint64(budget),                            \
+           qPrintable(QStringLiteral("%1 allocations (%2 bytes), budget %3")   \
+                        .arg(quint64((counts).allocations))                    \
+                        .arg(quint64((counts).bytes))                          \
+                        .arg(quint64(budget))))
+
+/* = Tests
+   ==========================================================================================*/
+class TestAllocations : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+
+  void decodeQListInt_data() { sizes(); }
+  void decodeQListInt();
+  void decodeQVectorInt_data() { sizes(); }
+  void decodeQVectorInt();
+  void decodeQSetInt_data() { sizes(); }
+  void decodeQSetInt();
+  void decodeQMapStringInt_data() { sizes(); }
+  void decodeQMapStringInt();
+
+  void encodeQListInt_data() { sizes(); }
+  void encodeQListInt();
+  void encodeQVectorInt_data() { sizes(); }
+  void encodeQVectorInt();
+  void encodeQMapStringInt_data() { sizes(); }
+  void encodeQMapStringInt();
+  void emitQListInt_data() { sizes(); }
+  void emitQListInt();
+  void emitReused();
+
+  void decodeCopies_data() { sizes(); }
+  void decodeCopies();
+
+  void decodeQString();
+  void decodeQByteArray_data() { sizes(); }
+  void decodeQByteArray();
+  void decodeQBuffer_data() { sizes(); }
+  void decodeQBuffer();
+  void decodeQColor();
+  void decodeQFont();
+  void encodeQFont();
+  void decodeQPoint();
+  void encodeQPoint();
+  void decodeQPointF();
+  void encodeQPointF();
+  void decodeQRect();
+  void encodeQRect();
+  void decodeQRectF();
+  void encodeQRectF();
+  void decodeQSize();
+  void encodeQSize();
+  void decodeQSizeF();
+  void encodeQSizeF();
+  void decodeQPixmap();
+  void encodeQPixmap();
+  void decodeQImage();
+  void encodeQImage();
+
+  void decodeQVariantScalar();
+  void encodeQVariantScalar();
+  void decodeQVariantList_data() { sizes(); }
+  void decodeQVariantList();
+  void encodeQVariantList_data() { sizes(); }
+  void encodeQVariantList();
+  void decodeQVariantMap_data() { sizes(); }
+  void decodeQVariantMap();
+  void encodeQVariantMap_data() { sizes(); }
+  void encodeQVariantMap();
+
+  void emitQStringList_data() { sizes(); }
+  void emitQStringList();
+  void emitQMapStringInt_data() { sizes(); }
+  void emitQMapStringInt();
+  void emitQVectorInt_data() { sizes(); }
+  void emitQVectorInt();
+
+private:
+  void sizes() {
+    QTest::addColumn<int>("count");
+    QTest::newRow("10") << 10;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("100000") << 100000;
+  }
+};
+
+void TestAllocations::initTestCase()
+{
+  if (!AllocCounter::interceptsMalloc()) {
+    qWarning("malloc is not intercepted, only operator new is counted");
+  }
+
+  // interning would move allocations into the pool and out of the budgets.
+  QYaml::StringPool::setDefault(nullptr);
+}
+
+void TestAllocations::decodeQListInt()
+{
+  QFETCH(int, count);
+  const YAML::Node node = intSequence(count);
+  const AllocCounter::Counts reads = sequenceReads(node);
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QList<int> list;
+    YAML::convert<QList<int>>::decode(node, list);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations + 2);
+}
+
+void TestAllocations::decodeQVectorInt()
+{
+  QFETCH(int, count);
+  const YAML::Node node = intSequence(count);
+  const AllocCounter::Counts reads = sequenceReads(node);
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QVector<int> vector;
+    YAML::convert<QVector<int>>::decode(node, vector);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations + 2);
+}
+
+void TestAllocations::decodeQSetInt()
+{
+  QFETCH(int, count);
+  const YAML::Node node = intSequence(count);
+  const AllocCounter::Counts reads = sequenceReads(node);
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QSet<int> set;
+    YAML::convert<QSet<int>>::decode(node, set);
+  });
+
+  // one hash node per element, plus the data and bucket array.
+  CHECK_BUDGET(counts, reads.allocations + quint64(count) + 3);
+}
+
+void TestAllocations::decodeQMapStringInt()
+{
+  QFETCH(int, count);
+  const YAML::Node node = stringIntMap(count);
+
+  const AllocCounter::Counts reads = measure([&node]() {
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      QString key = it->first.as<QString>();
+      int value = it->second.as<int>();
+      Q_UNUSED(key);
+      Q_UNUSED(value);
+    }
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QMap<QString, int> map;
+    YAML::convert<QMap<QString, int>>::decode(node, map);
+  });
+
+  // one map node per element, plus the map data.
+  CHECK_BUDGET(counts, reads.allocations + quint64(count) + 2);
+}
+
+void TestAllocations::encodeQListInt()
+{
+  QFETCH(int, count);
+  QList<int> list;
+
+  for (int i = 0; i < count; ++i) {
+    list.append(i);
+  }
+
+  const AllocCounter::Counts baseline = measure([count]() {
+    YAML::Node node = intSequence(count);
+    Q_UNUSED(node);
+  });
+
+  const AllocCounter::Counts counts = measure([&list]() {
+    YAML::Node node = YAML::convert<QList<int>>::encode(list);
+    Q_UNUSED(node);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations + 1);
+}
+
+void TestAllocations::encodeQVectorInt()
+{
+  QFETCH(int, count);
+  QVector<int> vector;
+
+  for (int i = 0; i < count; ++i) {
+    vector.append(i);
+  }
+
+  const AllocCounter::Counts baseline = measure([count]() {
+    YAML::Node node = intSequence(count);
+    Q_UNUSED(node);
+  });
+
+  const AllocCounter::Counts counts = measure([&vector]() {
+    YAML::Node node = YAML::convert<QVector<int>>::encode(vector);
+    Q_UNUSED(node);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations + 1);
+}
+
+void TestAllocations::encodeQMapStringInt()
+{
+  QFETCH(int, count);
+  QMap<QString, int> map;
+
+  for (int i = 0; i < count; ++i) {
+    map.insert(QStringLiteral("key%1").arg(i), i);
+  }
+
+  const AllocCounter::Counts baseline = measure([&map]() {
+    YAML::Node node(YAML::NodeType::Map);
+
+    for (QMap<QString, int>::const_iterator it = map.constBegin();
+         it != map.constEnd(); ++it) {
+      node.force_insert(it.key(), it.value());
+    }
+  });
+
+  const AllocCounter::Counts counts = measure([&map]() {
+    YAML::Node node = YAML::convert<QMap<QString, int>>::encode(map);
+    Q_UNUSED(node);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations + 1);
+}
+
+void TestAllocations::emitQListInt()
+{
+  QFETCH(int, count);
+  QList<int> list;
+
+  for (int i = 0; i < count; ++i) {
+    list.append(i);
+  }
+
+  const AllocCounter::Counts baseline = measure([&list]() {
+    YAML::Emitter out;
+    out << YAML::convert<QList<int>>::encode(list);
+  });
+
+  const AllocCounter::Counts counts = measure([&list]() {
+    YAML::Emitter out;
+    out << list;
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::emitReused()
+{
+  QYaml::ReusableEmitter emitter;
+  QPointF point(120.25, -45.5);
+
+  const auto message = [&point](YAML::Emitter& out) {
+    out << YAML::BeginMap;
+    out << YAML::Key << "x" << YAML::Value << point.x();
+    out << YAML::Key << "y" << YAML::Value << point.y();
+    out << YAML::EndMap;
+  };
+
+  const AllocCounter::Counts fresh = measure([&message]() {
+    YAML::Emitter out;
+    message(out);
+  });
+
+  const AllocCounter::Counts reused = measure([&emitter, &message]() {
+    message(emitter.begin());
+    emitter.data();
+  });
+
+  // only the group yaml-cpp pushes for the map is left.
+  CHECK_BUDGET(reused, 1);
+  QVERIFY(reused.allocations < fresh.allocations);
+
+  const AllocCounter::Counts encode = measure([&point]() {
+    YAML::Node node = YAML::convert<QPointF>::encode(point);
+  });
+
+  const AllocCounter::Counts overload = measure([&emitter, &point]() {
+    emitter.begin() << point;
+    emitter.data();
+  });
+
+  CHECK_BUDGET(overload, encode.allocations + 1);
+}
+
+void TestAllocations::decodeCopies()
+{
+  QFETCH(int, count);
+  const YAML::Node node = intSequence(count);
+
+  // each element may be copied into place once at most.
+  Counted::copies = 0;
+  QList<Counted> list;
+  QVERIFY(YAML::convert<QList<Counted>>::decode(node, list));
+  QVERIFY2(Counted::copies <= count,
+           qPrintable(QStringLiteral("QList: %1 copies of %2 elements")
+                        .arg(Counted::copies)
+                        .arg(count)));
+
+  Counted::copies = 0;
+  QVector<Counted> vector;
+  QVERIFY(YAML::convert<QVector<Counted>>::decode(node, vector));
+  QVERIFY2(Counted::copies <= count,
+           qPrintable(QStringLiteral("QVector: %1 copies of %2 elements")
+                        .arg(Counted::copies)
+                        .arg(count)));
+
+  QCOMPARE(list.size(), count);
+  QCOMPARE(vector.size(), count);
+  QCOMPARE(vector.last().value, count - 1);
+}
+
+void TestAllocations::decodeQString()
+{
+  const YAML::Node node(std::string("a string that is too long for any small string buffer"));
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QString value;
+    YAML::convert<QString>::decode(node, value);
+  });
+
+  CHECK_BUDGET(counts, 1);
+}
+
+void TestAllocations::decodeQByteArray()
+{
+  QFETCH(int, count);
+  const QByteArray data(count, 'x');
+  const YAML::Node node = YAML::convert<QByteArray>::encode(data);
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QByteArray value;
+    YAML::convert<QByteArray>::decode(node, value);
+  });
+
+  CHECK_BUDGET(counts, 1);
+
+  QByteArray value;
+  QVERIFY(YAML::convert<QByteArray>::decode(node, value));
+  QCOMPARE(value, data);
+}
+
+void TestAllocations::decodeQBuffer()
+{
+  QFETCH(int, count);
+  const QByteArray data(count, 'x');
+  const YAML::Node node = YAML::convert<QByteArray>::encode(data);
+
+  const AllocCounter::Counts construction = measure([]() {
+    QBuffer buffer;
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QBuffer buffer;
+    YAML::convert<QBuffer>::decode(node, buffer);
+  });
+
+  // the QBuffer itself and the decoded bytes, which setData() shares.
+  CHECK_BUDGET(counts, construction.allocations + 1);
+
+  QBuffer buffer;
+  QVERIFY(YAML::convert<QBuffer>::decode(node, buffer));
+  QCOMPARE(buffer.data(), data);
+}
+
+void TestAllocations::decodeQColor()
+{
+  const YAML::Node node = YAML::convert<QColor>::encode(QColor(1, 2, 3, 4));
+
+  const AllocCounter::Counts reads = measure([&node]() {
+    int sum = node["red"].as<int>() + node["green"].as<int>() +
+              node["blue"].as<int>() + node["alpha"].as<int>();
+    volatile int result = sum;
+    Q_UNUSED(result);
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QColor color;
+    YAML::convert<QColor>::decode(node, color);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations);
+}
+
+void TestAllocations::decodeQFont()
+{
+  const YAML::Node node = YAML::convert<QFont>::encode(QFont(QStringLiteral("Sans"), 12));
+
+  const AllocCounter::Counts reads = measure([&node]() {
+    for (const char* key : { "family", "style name" }) {
+      QString value = node[key].as<QString>();
+      Q_UNUSED(value);
+    }
+
+    for (const char* key : { "bold", "fixedpitch", "italic", "kerning", "overline",
+                             "strikeout", "underline" }) {
+      bool value = node[key].as<bool>();
+      Q_UNUSED(value);
+    }
+
+    for (const char* key : { "capitalization", "hinting preference",
+                             "letter spacing type", "point size", "stretch", "style",
+                             "style hint", "style strategy", "weight",
+                             "word spacing" }) {
+      int value = node[key].as<int>();
+      Q_UNUSED(value);
+    }
+
+    double spacing = node["letter spacing"].as<double>();
+    Q_UNUSED(spacing);
+  });
+
+  const AllocCounter::Counts construction = measure([]() {
+    QFont font;
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QFont font;
+    YAML::convert<QFont>::decode(node, font);
+  });
+
+  // the setters detach the shared font data, which copies its family list.
+  CHECK_BUDGET(counts, reads.allocations + construction.allocations + 3);
+}
+
+void TestAllocations::encodeQFont()
+{
+  const QFont font(QStringLiteral("Sans"), 12);
+
+  const AllocCounter::Counts baseline = measure([&font]() {
+    YAML::Node node;
+    node["family"] = font.family();
+    node["style name"] = font.styleName();
+    node["letter spacing"] = font.letterSpacing();
+
+    for (const char* key : { "bold", "fixedpitch", "italic", "kerning", "overline",
+                             "strikeout", "underline" }) {
+      node[key] = false;
+    }
+
+    for (const char* key : { "capitalization", "hinting preference",
+                             "letter spacing type", "point size", "stretch", "style",
+                             "style hint", "style strategy", "weight",
+                             "word spacing" }) {
+      node[key] = 100;
+    }
+  });
+
+  const AllocCounter::Counts counts = measure([&font]() {
+    YAML::Node node = YAML::convert<QFont>::encode(font);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQPoint()
+{
+  const YAML::Node node = YAML::convert<QPoint>::encode(QPoint(12, -34));
+  const AllocCounter::Counts reads = fieldReads<int>(node, { "x", "y" });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QPoint point;
+    YAML::convert<QPoint>::decode(node, point);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations);
+}
+
+void TestAllocations::encodeQPoint()
+{
+  const QPoint point(12, -34);
+  const AllocCounter::Counts baseline = fieldWrites({ "x", "y" }, -34);
+
+  const AllocCounter::Counts counts = measure([&point]() {
+    YAML::Node node = YAML::convert<QPoint>::encode(point);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQPointF()
+{
+  const YAML::Node node = YAML::convert<QPointF>::encode(QPointF(120.25, -45.5));
+  const AllocCounter::Counts reads = fieldReads<qreal>(node, { "x", "y" });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QPointF point;
+    YAML::convert<QPointF>::decode(node, point);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations);
+}
+
+void TestAllocations::encodeQPointF()
+{
+  const QPointF point(120.25, -45.5);
+  const AllocCounter::Counts baseline = fieldWrites({ "x", "y" }, 120.25);
+
+  const AllocCounter::Counts counts = measure([&point]() {
+    YAML::Node node = YAML::convert<QPointF>::encode(point);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQRect()
+{
+  const YAML::Node node = YAML::convert<QRect>::encode(QRect(1, 2, 300, 400));
+  const AllocCounter::Counts reads =
+    fieldReads<int>(node, { "left", "top", "width", "height" });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QRect rect;
+    YAML::convert<QRect>::decode(node, rect);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations);
+}
+
+void TestAllocations::encodeQRect()
+{
+  const QRect rect(1, 2, 300, 400);
+  const AllocCounter::Counts baseline =
+    fieldWrites({ "left", "top", "width", "height" }, 400);
+
+  const AllocCounter::Counts counts = measure([&rect]() {
+    YAML::Node node = YAML::convert<QRect>::encode(rect);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQRectF()
+{
+  const YAML::Node node = YAML::convert<QRectF>::encode(QRectF(1.5, 2.5, 300.25, 400.75));
+  const AllocCounter::Counts reads =
+    fieldReads<qreal>(node, { "left", "top", "width", "height" });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QRectF rect;
+    YAML::convert<QRectF>::decode(node, rect);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations);
+}
+
+void TestAllocations::encodeQRectF()
+{
+  const QRectF rect(1.5, 2.5, 300.25, 400.75);
+  const AllocCounter::Counts baseline =
+    fieldWrites({ "left", "top", "width", "height" }, 400.75);
+
+  const AllocCounter::Counts counts = measure([&rect]() {
+    YAML::Node node = YAML::convert<QRectF>::encode(rect);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQSize()
+{
+  const YAML::Node node = YAML::convert<QSize>::encode(QSize(640, 480));
+  const AllocCounter::Counts reads = fieldReads<int>(node, { "width", "height" });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QSize size;
+    YAML::convert<QSize>::decode(node, size);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations);
+}
+
+void TestAllocations::encodeQSize()
+{
+  const QSize size(640, 480);
+  const AllocCounter::Counts baseline = fieldWrites({ "width", "height" }, 640);
+
+  const AllocCounter::Counts counts = measure([&size]() {
+    YAML::Node node = YAML::convert<QSize>::encode(size);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQSizeF()
+{
+  const YAML::Node node = YAML::convert<QSizeF>::encode(QSizeF(640.5, 480.25));
+  const AllocCounter::Counts reads = fieldReads<qreal>(node, { "width", "height" });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QSizeF size;
+    YAML::convert<QSizeF>::decode(node, size);
+  });
+
+  CHECK_BUDGET(counts, reads.allocations);
+}
+
+void TestAllocations::encodeQSizeF()
+{
+  const QSizeF size(640.5, 480.25);
+  const AllocCounter::Counts baseline = fieldWrites({ "width", "height" }, 640.5);
+
+  const AllocCounter::Counts counts = measure([&size]() {
+    YAML::Node node = YAML::convert<QSizeF>::encode(size);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQPixmap()
+{
+  const QByteArray data = png(sampleImage());
+  const YAML::Node node = YAML::convert<QByteArray>::encode(data);
+
+  const AllocCounter::Counts load = measure([&data]() {
+    QPixmap pixmap;
+    pixmap.loadFromData(data);
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QPixmap pixmap;
+    YAML::convert<QPixmap>::decode(node, pixmap);
+  });
+
+  // the PNG decode plus the decoded bytes, the result is shared into rhs.
+  CHECK_BUDGET(counts, load.allocations + 1);
+}
+
+void TestAllocations::encodeQPixmap()
+{
+  const QPixmap pixmap = QPixmap::fromImage(sampleImage());
+
+  const AllocCounter::Counts save = measure([&pixmap]() {
+    QByteArray array;
+    QBuffer buffer(&array);
+    buffer.open(QIODevice::WriteOnly);
+    pixmap.save(&buffer, "PNG");
+    YAML::Node node;
+    node = array;
+  });
+
+  const AllocCounter::Counts counts = measure([&pixmap]() {
+    YAML::Node node = YAML::convert<QPixmap>::encode(pixmap);
+  });
+
+  CHECK_BUDGET(counts, save.allocations);
+}
+
+void TestAllocations::decodeQImage()
+{
+  const QByteArray data = png(sampleImage());
+  const YAML::Node node = YAML::convert<QByteArray>::encode(data);
+
+  const AllocCounter::Counts load = measure([&data]() {
+    QImage image;
+    image.loadFromData(data);
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QImage image;
+    YAML::convert<QImage>::decode(node, image);
+  });
+
+  CHECK_BUDGET(counts, load.allocations + 1);
+}
+
+void TestAllocations::encodeQImage()
+{
+  const QImage image = sampleImage();
+
+  const AllocCounter::Counts save = measure([&image]() {
+    QPixmap pixmap = QPixmap::fromImage(image);
+    QByteArray array;
+    QBuffer buffer(&array);
+    buffer.open(QIODevice::WriteOnly);
+    pixmap.save(&buffer, "PNG");
+    YAML::Node node;
+    node = array;
+  });
+
+  const AllocCounter::Counts counts = measure([&image]() {
+    YAML::Node node = YAML::convert<QImage>::encode(image);
+  });
+
+  CHECK_BUDGET(counts, save.allocations);
+}
+
+void TestAllocations::decodeQVariantScalar()
+{
+  const YAML::Node node(std::string("a string that is too long for any small string buffer"));
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QVariant value;
+    YAML::convert<QVariant>::decode(node, value);
+  });
+
+  // the QString, which QVariant stores in place.
+  CHECK_BUDGET(counts, 1);
+}
+
+void TestAllocations::encodeQVariantScalar()
+{
+  const QVariant value(qint64(1234567));
+
+  const AllocCounter::Counts baseline = measure([]() {
+    YAML::Node node;
+    node = qint64(1234567);
+  });
+
+  const AllocCounter::Counts counts = measure([&value]() {
+    YAML::Node node = YAML::convert<QVariant>::encode(value);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::decodeQVariantList()
+{
+  QFETCH(int, count);
+  const YAML::Node node = intSequence(count);
+
+  const AllocCounter::Counts reads = measure([&node]() {
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      QString value = QString::fromStdString(it->Scalar());
+      Q_UNUSED(value);
+    }
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QVariant value;
+    YAML::convert<QVariant>::decode(node, value);
+  });
+
+  // QList stores each QVariant in its own node, plus the list data.
+  CHECK_BUDGET(counts, reads.allocations + quint64(count) + 2);
+}
+
+void TestAllocations::encodeQVariantList()
+{
+  QFETCH(int, count);
+  QVariantList list;
+
+  for (int i = 0; i < count; ++i) {
+    list.append(i);
+  }
+
+  const QVariant value(list);
+
+  const AllocCounter::Counts baseline = measure([count]() {
+    YAML::Node node(YAML::NodeType::Sequence);
+
+    for (int i = 0; i < count; ++i) {
+      YAML::Node item;
+      item = qint64(i);
+      node.push_back(item);
+    }
+  });
+
+  const AllocCounter::Counts counts = measure([&value]() {
+    YAML::Node node = YAML::convert<QVariant>::encode(value);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations + 1);
+}
+
+void TestAllocations::decodeQVariantMap()
+{
+  QFETCH(int, count);
+  const YAML::Node node = stringIntMap(count);
+
+  const AllocCounter::Counts reads = measure([&node]() {
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+      QString key = QString::fromStdString(it->first.Scalar());
+      QString value = QString::fromStdString(it->second.Scalar());
+      Q_UNUSED(key);
+      Q_UNUSED(value);
+    }
+  });
+
+  const AllocCounter::Counts counts = measure([&node]() {
+    QVariant value;
+    YAML::convert<QVariant>::decode(node, value);
+  });
+
+  // one map node per element, plus the map data.
+  CHECK_BUDGET(counts, reads.allocations + quint64(count) + 2);
+}
+
+void TestAllocations::encodeQVariantMap()
+{
+  QFETCH(int, count);
+  QVariantMap map;
+
+  for (int i = 0; i < count; ++i) {
+    map.insert(QStringLiteral("key%1").arg(i), i);
+  }
+
+  const QVariant value(map);
+
+  const AllocCounter::Counts baseline = measure([&map]() {
+    YAML::Node node(YAML::NodeType::Map);
+
+    for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+      YAML::Node item;
+      item = qint64(it.value().toInt());
+      node.force_insert(it.key().toStdString(), item);
+    }
+  });
+
+  const AllocCounter::Counts counts = measure([&value]() {
+    YAML::Node node = YAML::convert<QVariant>::encode(value);
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations + 1);
+}
+
+void TestAllocations::emitQStringList()
+{
+  QFETCH(int, count);
+  QStringList list;
+
+  for (int i = 0; i < count; ++i) {
+    list.append(QStringLiteral("item %1").arg(i));
+  }
+
+  const AllocCounter::Counts baseline = measure([&list]() {
+    YAML::Emitter out;
+    out << YAML::BeginSeq;
+
+    for (const QString& item : list) {
+      out << item.toStdString();
+    }
+
+    out << YAML::EndSeq;
+  });
+
+  const AllocCounter::Counts counts = measure([&list]() {
+    YAML::Emitter out;
+    out << list;
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::emitQMapStringInt()
+{
+  QFETCH(int, count);
+  QMap<QString, int> map;
+
+  for (int i = 0; i < count; ++i) {
+    map.insert(QStringLiteral("key%1").arg(i), i);
+  }
+
+  const AllocCounter::Counts baseline = measure([&map]() {
+    YAML::Emitter out;
+    out << YAML::convert<QMap<QString, int>>::encode(map);
+  });
+
+  const AllocCounter::Counts counts = measure([&map]() {
+    YAML::Emitter out;
+    out << map;
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+void TestAllocations::emitQVectorInt()
+{
+  QFETCH(int, count);
+  QVector<int> vector;
+
+  for (int i = 0; i < count; ++i) {
+    vector.append(i);
+  }
+
+  const AllocCounter::Counts baseline = measure([&vector]() {
+    YAML::Emitter out;
+    out << YAML::convert<QVector<int>>::encode(vector);
+  });
+
+  const AllocCounter::Counts counts = measure([&vector]() {
+    YAML::Emitter out;
+    out << vector;
+  });
+
+  CHECK_BUDGET(counts, baseline.allocations);
+}
+
+QTEST_MAIN(TestAllocations)
+
+#include "tst_allocations.moc"
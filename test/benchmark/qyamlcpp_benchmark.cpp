@@ -0,0 +1,925 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   Benchmarks for the encode, decode and Emitter paths of every type in
+   node.h and collection.h, for the Load/LoadFile overloads in parse.h and
+   for reusing emitters from emitterpool.h, emitting on several threads with
+   parallelemitter.h and batching documents with streamwriter.h.
+   BM_ParseQtIsoDate and BM_FormatQtIsoDate time Qt's own ISO 8601 code for
+   comparison with the QDateTime converter. The json.h benchmarks compare the
+   structural JSON and CBOR converters with a round trip through JSON text or
+   QVariant.
+
+   Sized benchmarks run from 10 to 10^6 elements, image benchmarks from 64²
+   to 4096² pixels. Unless --benchmark_out is given the results are also
+   written to qyamlcpp_benchmark.json so runs can be compared with
+   tools/compare.py from the Google Benchmark sources.
+*/
+#include <QBuffer>
+#include <QByteArray>
+#include <QCborArray>
+#include <QCborValue>
+#include <QColor>
+#include <QDate>
+#include <QDateTime>
+#include <QFile>
+#include <QFont>
+#include <QGuiApplication>
+#include <QHash>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLineF>
+#include <QList>
+#include <QMap>
+#include <QMatrix4x4>
+#include <QMultiMap>
+#include <QPixmap>
+#include <QPolygonF>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <QTime>
+#include <QTransform>
+#include <QUrl>
+#include <QUuid>
+#include <QVariant>
+#include <QVector>
+
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <yaml-cpp/yaml.h>
+
+#include <qyamlcpp/emitterpool.h>
+#include <qyamlcpp/json.h>
+#include <qyamlcpp/parallelemitter.h>
+#include <qyamlcpp/qyamlcpp.h>
+#include <qyamlcpp/streamwriter.h>
+
+typedef QList<QString> StringList;
+typedef QMap<QString, int> StringIntMap;
+typedef QHash<QString, int> StringIntHash;
+typedef QMultiMap<QString, int> StringIntMultiMap;
+typedef QVector<QPointF> PointVector;
+
+/* = Sample values
+   ==========================================================================================*/
+/*
+   Sample<T>::make(n) builds the value to convert. n is the element count for
+   containers, the byte count for QByteArray, the side length for images and
+   is ignored for fixed size types.
+*/
+template<class T>
+struct Sample;
+
+template<>
+struct Sample<QString>
+{
+  static QString make(int) {
+    return QStringLiteral("The quick brown fox jumps over the lazy dog");
+  }
+};
+
+template<>
+struct Sample<QByteArray>
+{
+  static QByteArray make(int n) {
+    QByteArray data(n, Qt::Uninitialized);
+
+    for (int i = 0; i < n; ++i) {
+      data[i] = char(i * 31 + (i >> 8));
+    }
+
+    return data;
+  }
+};
+
+template<>
+struct Sample<QColor>
+{
+  static QColor make(int) { return QColor(12, 34, 56, 78); }
+};
+
+template<>
+struct Sample<QFont>
+{
+  static QFont make(int) {
+    QFont font(QStringLiteral("Sans Serif"), 11);
+    font.setBold(true);
+    return font;
+  }
+};
+
+template<>
+struct Sample<QDateTime>
+{
+  static QDateTime make(int) {
+    return QDateTime(QDate(2020, 6, 15), QTime(13, 45, 30, 250), Qt::UTC);
+  }
+};
+
+template<>
+struct Sample<QDate>
+{
+  static QDate make(int) { return QDate(2020, 6, 15); }
+};
+
+template<>
+struct Sample<QTime>
+{
+  static QTime make(int) { return QTime(13, 45, 30, 250); }
+};
+
+template<>
+struct Sample<QUuid>
+{
+  static QUuid make(int) {
+    return QUuid(QStringLiteral("{67c8770b-44f1-410a-ab9a-f9b5446f13ee}"));
+  }
+};
+
+template<>
+struct Sample<QUrl>
+{
+  static QUrl make(int) {
+    return QUrl(QStringLiteral("https://example.com/path/file.yaml?key=value"));
+  }
+};
+
+template<>
+struct Sample<QPoint>
+{
+  static QPoint make(int) { return QPoint(120, -45); }
+};
+
+template<>
+struct Sample<QPointF>
+{
+  static QPointF make(int) { return QPointF(120.25, -45.5); }
+};
+
+template<>
+struct Sample<QLineF>
+{
+  static QLineF make(int) { return QLineF(120.25, -45.5, 300.75, 12.125); }
+};
+
+template<>
+struct Sample<QPolygonF>
+{
+  static QPolygonF make(int n) {
+    QPolygonF polygon;
+    polygon.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+      polygon.append(QPointF(i * 0.25, 1000.0 - i * 0.5));
+    }
+
+    return polygon;
+  }
+};
+
+// the same points in the map per point form, for comparison with QPolygonF.
+template<>
+struct Sample<PointVector>
+{
+  static PointVector make(int n) { return Sample<QPolygonF>::make(n); }
+};
+
+template<>
+struct Sample<QTransform>
+{
+  static QTransform make(int) { return QTransform().translate(12.5, -4).rotate(30).scale(2, 0.5); }
+};
+
+template<>
+struct Sample<QMatrix4x4>
+{
+  static QMatrix4x4 make(int) {
+    QMatrix4x4 matrix;
+    matrix.perspective(45.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    matrix.translate(1.0f, -2.0f, -10.0f);
+    return matrix;
+  }
+};
+
+template<>
+struct Sample<QRect>
+{
+  static QRect make(int) { return QRect(10, 20, 640, 480); }
+};
+
+template<>
+struct Sample<QRectF>
+{
+  static QRectF make(int) { return QRectF(10.5, 20.25, 640.75, 480.125); }
+};
+
+template<>
+struct Sample<QSize>
+{
+  static QSize make(int) { return QSize(1920, 1080); }
+};
+
+template<>
+struct Sample<QSizeF>
+{
+  static QSizeF make(int) { return QSizeF(297.0, 210.0); }
+};
+
+template<>
+struct Sample<QImage>
+{
+  // a pattern rather than a flat fill, so the PNG encoder has some work to do.
+  static QImage make(int side) {
+    QImage image(side, side, QImage::Format_ARGB32);
+
+    for (int y = 0; y < side; ++y) {
+      QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+
+      for (int x = 0; x < side; ++x) {
+        line[x] = qRgba(x * 7, y * 13, x ^ y, 255);
+      }
+    }
+
+    return image;
+  }
+};
+
+template<>
+struct Sample<QPixmap>
+{
+  static QPixmap make(int side) {
+    return QPixmap::fromImage(Sample<QImage>::make(side));
+  }
+};
+
+template<>
+struct Sample<QVariant>
+{
+  static QVariant make(int n) {
+    QVariantMap map;
+
+    for (int i = 0; i < n; ++i) {
+      map.insert(QStringLiteral("key%1").arg(i), i);
+    }
+
+    return map;
+  }
+};
+
+template<class T>
+struct Sample<QList<T>>
+{
+  static QList<T> make(int n) {
+    QList<T> list;
+    list.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+      list.append(T(i));
+    }
+
+    return list;
+  }
+};
+
+template<>
+struct Sample<QStringList>
+{
+  static QStringList make(int n) {
+    QStringList list;
+    list.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+      list.append(QStringLiteral("item %1").arg(i));
+    }
+
+    return list;
+  }
+};
+
+template<>
+struct Sample<StringList>
+{
+  static StringList make(int n) { return Sample<QStringList>::make(n); }
+};
+
+template<class T>
+struct Sample<QVector<T>>
+{
+  static QVector<T> make(int n) {
+    QVector<T> vector;
+    vector.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+      vector.append(T(i));
+    }
+
+    return vector;
+  }
+};
+
+template<class T>
+struct Sample<QSet<T>>
+{
+  static QSet<T> make(int n) {
+    QSet<T> set;
+    set.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+      set.insert(T(i));
+    }
+
+    return set;
+  }
+};
+
+template<>
+struct Sample<StringIntMap>
+{
+  static StringIntMap make(int n) {
+    StringIntMap map;
+
+    for (int i = 0; i < n; ++i) {
+      map.insert(QStringLiteral("key%1").arg(i), i);
+    }
+
+    return map;
+  }
+};
+
+template<>
+struct Sample<StringIntHash>
+{
+  static StringIntHash make(int n) {
+    StringIntHash hash;
+    hash.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+      hash.insert(QStringLiteral("key%1").arg(i), i);
+    }
+
+    return hash;
+  }
+};
+
+// n values over n / 4 keys.
+template<>
+struct Sample<StringIntMultiMap>
+{
+  static StringIntMultiMap make(int n) {
+    StringIntMultiMap map;
+
+    for (int i = 0; i < n; ++i) {
+      map.insert(QStringLiteral("key%1").arg(i / 4), i);
+    }
+
+    return map;
+  }
+};
+
+// n records of the kind a REST API returns.
+template<>
+struct Sample<QJsonArray>
+{
+  static QJsonArray make(int n) {
+    QJsonArray array;
+
+    for (int i = 0; i < n; ++i) {
+      QJsonObject record;
+      record.insert(QStringLiteral("id"), i);
+      record.insert(QStringLiteral("name"), QStringLiteral("item %1").arg(i));
+      record.insert(QStringLiteral("price"), i * 0.25);
+      record.insert(QStringLiteral("active"), (i % 2) == 0);
+      record.insert(QStringLiteral("tags"),
+                    QJsonArray{ QStringLiteral("red"), QStringLiteral("large") });
+      array.append(record);
+    }
+
+    return array;
+  }
+};
+
+template<>
+struct Sample<QCborArray>
+{
+  static QCborArray make(int n) {
+    return QCborArray::fromJsonArray(Sample<QJsonArray>::make(n));
+  }
+};
+
+/*
+   A block mapping document of n entries, each a small nested mapping.
+*/
+static QByteArray makeDocument(int n)
+{
+  QByteArray document;
+  document.reserve(n * 48);
+
+  for (int i = 0; i < n; ++i) {
+    document += "key" + QByteArray::number(i) + ":\n";
+    document += "  name: item " + QByteArray::number(i) + "\n";
+    document += "  value: " + QByteArray::number(i * 3) + "\n";
+  }
+
+  return document;
+}
+
+/* = Converter benchmarks
+   ==========================================================================================*/
+template<class T>
+static void BM_Encode(benchmark::State& state)
+{
+  const T value = Sample<T>::make(int(state.range(0)));
+
+  for (auto _ : state) {
+    YAML::Node node = YAML::convert<T>::encode(value);
+    benchmark::DoNotOptimize(node);
+  }
+}
+
+template<class T>
+static void BM_Decode(benchmark::State& state)
+{
+  const YAML::Node node =
+    YAML::convert<T>::encode(Sample<T>::make(int(state.range(0))));
+
+  for (auto _ : state) {
+    T value;
+    benchmark::DoNotOptimize(YAML::convert<T>::decode(node, value));
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+// the Emitter overloads take non const references, so value is not const.
+template<class T>
+static void BM_Emit(benchmark::State& state)
+{
+  T value = Sample<T>::make(int(state.range(0)));
+  std::size_t bytes = 0;
+
+  for (auto _ : state) {
+    YAML::Emitter out;
+    out << value;
+    bytes += out.size();
+    benchmark::DoNotOptimize(out.c_str());
+  }
+
+  state.SetBytesProcessed(int64_t(bytes));
+}
+
+// the same output as BM_Emit, from ranges emitted on a thread pool.
+template<class T>
+static void BM_EmitParallel(benchmark::State& state)
+{
+  T value = Sample<T>::make(int(state.range(0)));
+  std::size_t bytes = 0;
+
+  for (auto _ : state) {
+    QByteArray out = QYaml::emitParallel(value);
+    bytes += std::size_t(out.size());
+    benchmark::DoNotOptimize(out.constData());
+  }
+
+  state.SetBytesProcessed(int64_t(bytes));
+}
+
+// for types with no Emitter overload of their own.
+template<class T>
+static void BM_EmitNode(benchmark::State& state)
+{
+  const T value = Sample<T>::make(int(state.range(0)));
+  std::size_t bytes = 0;
+
+  for (auto _ : state) {
+    YAML::Emitter out;
+    out << YAML::Node(value);
+    bytes += out.size();
+    benchmark::DoNotOptimize(out.c_str());
+  }
+
+  state.SetBytesProcessed(int64_t(bytes));
+}
+
+/* = Message benchmarks
+   ==========================================================================================*/
+/*
+   Many small messages, each emitted with a new YAML::Emitter and copied
+   into a QByteArray, against the same messages from a ReusableEmitter.
+*/
+template<class T>
+static void BM_EmitMessage(benchmark::State& state)
+{
+  T value = Sample<T>::make(int(state.range(0)));
+
+  for (auto _ : state) {
+    YAML::Emitter out;
+    out << value;
+    QByteArray message(out.c_str(), int(out.size()));
+    benchmark::DoNotOptimize(message.constData());
+  }
+}
+
+template<class T>
+static void BM_EmitMessageReused(benchmark::State& state)
+{
+  T value = Sample<T>::make(int(state.range(0)));
+  QYaml::ReusableEmitter emitter;
+
+  for (auto _ : state) {
+    emitter.begin() << value;
+    benchmark::DoNotOptimize(emitter.data().constData());
+  }
+}
+
+/*
+   Appending events to a log file, one emitter and one flushed write per
+   event, against a StreamWriter that batches them.
+*/
+static void BM_AppendEvents(benchmark::State& state)
+{
+  QVariant value = Sample<QVariant>::make(int(state.range(0)));
+  QTemporaryFile file;
+
+  if (!file.open()) {
+    state.SkipWithError("could not open the temporary file");
+    return;
+  }
+
+  for (auto _ : state) {
+    YAML::Emitter out;
+    out << value;
+    QByteArray document("---\n");
+    document.append(out.c_str(), int(out.size()));
+    document.append('\n');
+    file.write(document);
+    file.flush();
+  }
+
+  state.SetBytesProcessed(int64_t(file.size()));
+}
+
+static void BM_AppendEventsStreamWriter(benchmark::State& state)
+{
+  QVariant value = Sample<QVariant>::make(int(state.range(0)));
+  QTemporaryFile file;
+
+  if (!file.open()) {
+    state.SkipWithError("could not open the temporary file");
+    return;
+  }
+
+  QYaml::StreamWriter writer(&file);
+
+  for (auto _ : state) {
+    writer.write(value);
+  }
+
+  writer.close();
+  state.SetBytesProcessed(int64_t(file.size()));
+}
+
+// Qt's own ISO 8601 parser and formatter, for comparison with the
+// QDateTime converter.
+static void BM_ParseQtIsoDate(benchmark::State& state)
+{
+  const YAML::Node node = YAML::convert<QDateTime>::encode(Sample<QDateTime>::make(1));
+
+  for (auto _ : state) {
+    QDateTime value =
+      QDateTime::fromString(QString::fromStdString(node.Scalar()), Qt::ISODateWithMs);
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+static void BM_FormatQtIsoDate(benchmark::State& state)
+{
+  const QDateTime value = Sample<QDateTime>::make(1);
+
+  for (auto _ : state) {
+    YAML::Node node(value.toString(Qt::ISODateWithMs).toStdString());
+    benchmark::DoNotOptimize(node);
+  }
+}
+
+/*
+   The text round trip that the JSON converters replace, JSON text parsed as
+   YAML in one direction and a QVariant tree in the other, against the bulk
+   conversions of json.h.
+*/
+static void BM_JsonToNodeText(benchmark::State& state)
+{
+  const QJsonArray value = Sample<QJsonArray>::make(int(state.range(0)));
+
+  for (auto _ : state) {
+    const QByteArray text = QJsonDocument(value).toJson(QJsonDocument::Compact);
+    YAML::Node node = YAML::Load(text.toStdString());
+    benchmark::DoNotOptimize(node);
+  }
+}
+
+static void BM_NodeToJsonVariant(benchmark::State& state)
+{
+  const YAML::Node node =
+    YAML::convert<QJsonArray>::encode(Sample<QJsonArray>::make(int(state.range(0))));
+
+  for (auto _ : state) {
+    QJsonValue value = QJsonValue::fromVariant(node.as<QVariant>());
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+static void BM_NodeToJsonBulk(benchmark::State& state)
+{
+  const YAML::Node node =
+    YAML::convert<QJsonArray>::encode(Sample<QJsonArray>::make(int(state.range(0))));
+
+  for (auto _ : state) {
+    QJsonValue value = QYaml::toJsonValue(node);
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+static void BM_NodeToCborBulk(benchmark::State& state)
+{
+  const YAML::Node node =
+    YAML::convert<QCborArray>::encode(Sample<QCborArray>::make(int(state.range(0))));
+
+  for (auto _ : state) {
+    QCborValue value = QYaml::toCborValue(node);
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+// QBuffer is a QObject, so it cannot go through Sample<T>.
+static void BM_Encode_QBuffer(benchmark::State& state)
+{
+  QBuffer buffer;
+  buffer.setData(Sample<QByteArray>::make(int(state.range(0))));
+
+  for (auto _ : state) {
+    YAML::Node node = YAML::convert<QBuffer>::encode(buffer);
+    benchmark::DoNotOptimize(node);
+  }
+}
+
+static void BM_Decode_QBuffer(benchmark::State& state)
+{
+  const YAML::Node node =
+    YAML::convert<QByteArray>::encode(Sample<QByteArray>::make(int(state.range(0))));
+
+  for (auto _ : state) {
+    QBuffer buffer;
+    benchmark::DoNotOptimize(YAML::convert<QBuffer>::decode(node, buffer));
+  }
+}
+
+static void BM_Emit_QBuffer(benchmark::State& state)
+{
+  QBuffer buffer;
+  buffer.setData(Sample<QByteArray>::make(int(state.range(0))));
+
+  for (auto _ : state) {
+    YAML::Emitter out;
+    out << buffer;
+    benchmark::DoNotOptimize(out.c_str());
+  }
+}
+
+/* = Parse benchmarks
+   ==========================================================================================*/
+static void BM_Load_QString(benchmark::State& state)
+{
+  const QString document = QString::fromUtf8(makeDocument(int(state.range(0))));
+
+  for (auto _ : state) {
+    YAML::Node node = YAML::Load(document);
+    benchmark::DoNotOptimize(node);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * document.size());
+}
+
+static void BM_Load_QByteArray(benchmark::State& state)
+{
+  const QByteArray document = makeDocument(int(state.range(0)));
+
+  for (auto _ : state) {
+    YAML::Node node = YAML::Load(document);
+    benchmark::DoNotOptimize(node);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * document.size());
+}
+
+static bool writeDocument(QTemporaryFile& file, int n)
+{
+  const QByteArray document = makeDocument(n);
+
+  if (!file.open() || file.write(document) != document.size()) {
+    return false;
+  }
+
+  file.close();
+  return true;
+}
+
+static void BM_LoadFile_QString(benchmark::State& state)
+{
+  QTemporaryFile file;
+
+  if (!writeDocument(file, int(state.range(0)))) {
+    state.SkipWithError("could not write the temporary file");
+    return;
+  }
+
+  const QString fileName = file.fileName();
+
+  for (auto _ : state) {
+    YAML::Node node = YAML::LoadFile(fileName);
+    benchmark::DoNotOptimize(node);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * file.size());
+}
+
+static void BM_LoadFile_QFile(benchmark::State& state)
+{
+  QTemporaryFile file;
+
+  if (!writeDocument(file, int(state.range(0)))) {
+    state.SkipWithError("could not write the temporary file");
+    return;
+  }
+
+  const QString fileName = file.fileName();
+
+  for (auto _ : state) {
+    // LoadFile(QFile&) leaves the file open, so use a fresh one each time.
+    QFile input(fileName);
+    YAML::Node node = YAML::LoadFile(input);
+    benchmark::DoNotOptimize(node);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * file.size());
+}
+
+/* = Registration
+   ==========================================================================================*/
+#define QYAML_BENCHMARK_FIXED(T)                                               \
+  BENCHMARK_TEMPLATE(BM_Encode, T)->Arg(1);                                    \
+  BENCHMARK_TEMPLATE(BM_Decode, T)->Arg(1);                                    \
+  BENCHMARK_TEMPLATE(BM_Emit, T)->Arg(1)
+
+#define QYAML_BENCHMARK_SIZED(T, EMIT)                                         \
+  BENCHMARK_TEMPLATE(BM_Encode, T)->RangeMultiplier(10)->Range(10, 1000000);   \
+  BENCHMARK_TEMPLATE(BM_Decode, T)->RangeMultiplier(10)->Range(10, 1000000);   \
+  BENCHMARK_TEMPLATE(EMIT, T)->RangeMultiplier(10)->Range(10, 1000000)
+
+#define QYAML_BENCHMARK_IMAGE(T, EMIT)                                         \
+  BENCHMARK_TEMPLATE(BM_Encode, T)                                             \
+    ->RangeMultiplier(2)                                                       \
+    ->Range(64, 4096)                                                          \
+    ->Unit(benchmark::kMillisecond);                                           \
+  BENCHMARK_TEMPLATE(BM_Decode, T)                                             \
+    ->RangeMultiplier(2)                                                       \
+    ->Range(64, 4096)                                                          \
+    ->Unit(benchmark::kMillisecond);                                           \
+  BENCHMARK_TEMPLATE(EMIT, T)                                                  \
+    ->RangeMultiplier(2)                                                       \
+    ->Range(64, 4096)                                                          \
+    ->Unit(benchmark::kMillisecond)
+
+// node.h
+QYAML_BENCHMARK_FIXED(QString);
+QYAML_BENCHMARK_FIXED(QColor);
+QYAML_BENCHMARK_FIXED(QFont);
+QYAML_BENCHMARK_FIXED(QPoint);
+QYAML_BENCHMARK_FIXED(QPointF);
+QYAML_BENCHMARK_FIXED(QRect);
+QYAML_BENCHMARK_FIXED(QRectF);
+QYAML_BENCHMARK_FIXED(QSize);
+QYAML_BENCHMARK_FIXED(QSizeF);
+QYAML_BENCHMARK_FIXED(QDateTime);
+QYAML_BENCHMARK_FIXED(QDate);
+QYAML_BENCHMARK_FIXED(QTime);
+QYAML_BENCHMARK_FIXED(QUuid);
+QYAML_BENCHMARK_FIXED(QUrl);
+QYAML_BENCHMARK_FIXED(QLineF);
+QYAML_BENCHMARK_FIXED(QTransform);
+QYAML_BENCHMARK_FIXED(QMatrix4x4);
+QYAML_BENCHMARK_SIZED(QPolygonF, BM_Emit);
+QYAML_BENCHMARK_SIZED(PointVector, BM_Emit);
+BENCHMARK(BM_ParseQtIsoDate);
+BENCHMARK(BM_FormatQtIsoDate);
+QYAML_BENCHMARK_SIZED(QByteArray, BM_Emit);
+QYAML_BENCHMARK_SIZED(QVariant, BM_EmitNode);
+QYAML_BENCHMARK_IMAGE(QPixmap, BM_Emit);
+QYAML_BENCHMARK_IMAGE(QImage, BM_EmitNode);
+BENCHMARK(BM_Encode_QBuffer)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_Decode_QBuffer)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_Emit_QBuffer)->RangeMultiplier(10)->Range(10, 1000000);
+
+// collection.h
+QYAML_BENCHMARK_SIZED(QList<int>, BM_Emit);
+QYAML_BENCHMARK_SIZED(StringList, BM_EmitNode);
+QYAML_BENCHMARK_SIZED(QStringList, BM_Emit);
+QYAML_BENCHMARK_SIZED(QVector<int>, BM_Emit);
+QYAML_BENCHMARK_SIZED(QSet<int>, BM_EmitNode);
+QYAML_BENCHMARK_SIZED(StringIntMap, BM_Emit);
+QYAML_BENCHMARK_SIZED(StringIntHash, BM_Emit);
+QYAML_BENCHMARK_SIZED(StringIntMultiMap, BM_Emit);
+
+// json.h
+QYAML_BENCHMARK_SIZED(QJsonArray, BM_EmitNode);
+QYAML_BENCHMARK_SIZED(QCborArray, BM_EmitNode);
+BENCHMARK(BM_JsonToNodeText)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_NodeToJsonVariant)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_NodeToJsonBulk)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_NodeToCborBulk)->RangeMultiplier(10)->Range(10, 1000000);
+
+// emitterpool.h
+BENCHMARK_TEMPLATE(BM_EmitMessage, QPointF)->Arg(1);
+BENCHMARK_TEMPLATE(BM_EmitMessageReused, QPointF)->Arg(1);
+BENCHMARK_TEMPLATE(BM_EmitMessage, QColor)->Arg(1);
+BENCHMARK_TEMPLATE(BM_EmitMessageReused, QColor)->Arg(1);
+BENCHMARK_TEMPLATE(BM_EmitMessage, QVariant)->Arg(8);
+BENCHMARK_TEMPLATE(BM_EmitMessageReused, QVariant)->Arg(8);
+
+// parallelemitter.h
+BENCHMARK_TEMPLATE(BM_EmitParallel, QVector<int>)->RangeMultiplier(10)->Range(10000, 1000000);
+BENCHMARK_TEMPLATE(BM_EmitParallel, StringIntMap)->RangeMultiplier(10)->Range(10000, 1000000);
+
+// streamwriter.h
+BENCHMARK(BM_AppendEvents)->Arg(8);
+BENCHMARK(BM_AppendEventsStreamWriter)->Arg(8);
+
+// parse.h
+BENCHMARK(BM_Load_QString)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_Load_QByteArray)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_LoadFile_QString)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_LoadFile_QFile)->RangeMultiplier(10)->Range(10, 1000000);
+
+int main(int argc, char** argv)
+{
+  // QPixmap and QFont need a gui application, but not a display.
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
+  int qtArgc = 1;
+  QGuiApplication app(qtArgc, argv);
+
+  static char outArg[] = "--benchmark_out=qyamlcpp_benchmark.json";
+  static char formatArg[] = "--benchmark_out_format=json";
+  std::vector<char*> args(argv, argv + argc);
+  bool hasOut = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0) {
+      hasOut = true;
+    }
+  }
+
+  if (!hasOut) {
+    args.push_back(outArg);
+    args.push_back(formatArg);
+  }
+
+  int count = int(args.size());
+  benchmark::Initialize(&count, args.data());
+
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Times a clean build of the same program against the header only qyamlcpp
+# target and against qyamlcpp_compiled, and prints the executable sizes.
+#
+# usage: compare.sh [build directory] [translation units] [jobs]
+set -e
+
+SOURCE=$(cd "$(dirname "$0")/../.." && pwd)
+BUILD=${1:-build-buildtime}
+UNITS=${2:-40}
+JOBS=${3:-1}
+
+cmake -S "$SOURCE" -B "$BUILD" -DCMAKE_BUILD_TYPE=Release \
+   -DQYAMLCPP_BUILD_BUILDTIME=ON -DBUILDTIME_UNITS="$UNITS" > /dev/null
+
+# the library itself is built once and is not part of the comparison.
+cmake --build "$BUILD" --target qyamlcpp_compiled -j "$JOBS" > /dev/null
+
+for TARGET in buildtime_header buildtime_compiled; do
+   rm -rf "$BUILD/test/buildtime/CMakeFiles/$TARGET.dir"
+   cmake -S "$SOURCE" -B "$BUILD" > /dev/null
+   START=$(date +%s.%N)
+   cmake --build "$BUILD" --target "$TARGET" -j "$JOBS" > /dev/null
+   END=$(date +%s.%N)
+   SIZE=$(wc -c < "$BUILD/test/buildtime/$TARGET")
+   printf "%-20s %8.2fs %12d bytes\n" "$TARGET" \
+      "$(awk "BEGIN { print $END - $START }")" "$SIZE"
+done
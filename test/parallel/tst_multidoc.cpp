@@ -0,0 +1,162 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   loadAllParallel() must load the documents YAML::LoadAll() does. A small
+   minimum batch cuts the stream at many boundaries, next to the markers
+   that are hardest to find: "---" and "..." inside block and quoted
+   scalars, directives, repeated "..." and CRLF line endings. Documents
+   after a %TAG directive use its handle without declaring it again, as
+   yaml-cpp keeps the directives of the document before.
+*/
+#include <QByteArray>
+#include <QtTest>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include <qyamlcpp/multidoc.h>
+#include <qyamlcpp/qyamlcpp.h>
+
+/* = Helpers
+   ==========================================================================================*/
+namespace {
+
+const char* const Fixture[] = {
+  "--- |\n  literal\n  --- not a marker\n\n  ... nor this\n",
+  "key: >\n  folded\n   more indented\n  ---x\n",
+  "quoted: \"first\n  --- still quoted\n  last\"\n",
+  "single: 'one\n\n  two'\n",
+  "%YAML 1.2\n%TAG !e! tag:example.com,2000:\n--- !e!thing\nname: tagged\n...\n",
+  "--- !e!inherited\nname: uses the %TAG above\n",
+  "# a comment before the marker\n---\n- a\n- b\n",
+  "plain: value\n...\n...\n",
+  "---\n...\n",
+  "--- inline scalar\n",
+  "---\n? complex\n: key\n",
+  "--- # comment\r\nwindows: line endings\r\n...\r\n",
+  "# between documents\n\n---\nlast: document\n",
+  "--- !e!later\n- still inherits the %TAG\n",
+};
+
+QByteArray fixture(int repeat)
+{
+  QByteArray data;
+
+  for (int r = 0; r < repeat; ++r) {
+    for (const char* document : Fixture) {
+      data.append(document);
+    }
+  }
+
+  return data;
+}
+
+std::vector<YAML::Node> loadAllSerial(const QByteArray& data)
+{
+  std::istringstream in(std::string(data.constData(), std::size_t(data.size())));
+  return YAML::LoadAll(in);
+}
+
+QByteArray emitDocument(const YAML::Node& document)
+{
+  YAML::Emitter out;
+  out << document;
+  return QByteArray(out.c_str(), int(out.size()));
+}
+
+} // end of anonymous namespace
+
+/* = Tests
+   ==========================================================================================*/
+class TestMultiDoc : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void documents_data() { batches(); }
+  void documents();
+  void errorMark_data() { batches(); }
+  void errorMark();
+
+private:
+  void batches() {
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("minimumBatch");
+    QTest::newRow("1 thread") << 1 << 16;
+    QTest::newRow("2 threads, 16 bytes") << 2 << 16;
+    QTest::newRow("4 threads, 64 bytes") << 4 << 64;
+    QTest::newRow("4 threads, 200 bytes") << 4 << 200;
+    QTest::newRow("8 threads, 1000 bytes") << 8 << 1000;
+  }
+};
+
+void TestMultiDoc::documents()
+{
+  QFETCH(int, threads);
+  QFETCH(int, minimumBatch);
+  const QByteArray data = fixture(50);
+  const std::vector<YAML::Node> serial = loadAllSerial(data);
+  const std::vector<YAML::Node> parallel
+    = QYaml::loadAllParallel(data, threads, std::size_t(minimumBatch));
+
+  QCOMPARE(parallel.size(), serial.size());
+
+  for (std::size_t i = 0; i < serial.size(); ++i) {
+    QCOMPARE(emitDocument(parallel[i]), emitDocument(serial[i]));
+    QCOMPARE(parallel[i].Tag(), serial[i].Tag());
+  }
+}
+
+// an error in a later batch is reported where YAML::LoadAll reports it.
+void TestMultiDoc::errorMark()
+{
+  QFETCH(int, threads);
+  QFETCH(int, minimumBatch);
+  const QByteArray data = fixture(20) + "---\nbroken: [1, 2\nnext: 3\n" + fixture(1);
+  YAML::Mark expected;
+
+  try {
+    loadAllSerial(data);
+    QFAIL("YAML::LoadAll accepted a malformed document");
+  } catch (const YAML::ParserException& e) {
+    expected = e.mark;
+  }
+
+  try {
+    QYaml::loadAllParallel(data, threads, std::size_t(minimumBatch));
+    QFAIL("loadAllParallel accepted a malformed document");
+  } catch (const YAML::ParserException& e) {
+    QCOMPARE(e.mark.pos, expected.pos);
+    QCOMPARE(e.mark.line, expected.line);
+    QCOMPARE(e.mark.column, expected.column);
+  }
+}
+
+QTEST_GUILESS_MAIN(TestMultiDoc)
+
+#include "tst_multidoc.moc"
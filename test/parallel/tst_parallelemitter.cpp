@@ -0,0 +1,206 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   emitParallel() must give byte for byte the output of a single
+   YAML::Emitter. The collections are large enough to be cut into several
+   ranges, and the elements that are hardest to join, multi-line strings,
+   empty and nested collections and long keys, fall on the range
+   boundaries.
+*/
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <QtTest>
+
+#include <yaml-cpp/yaml.h>
+
+#include <qyamlcpp/parallelemitter.h>
+#include <qyamlcpp/qyamlcpp.h>
+
+/* = Helpers
+   ==========================================================================================*/
+namespace {
+
+// emitParallel() cuts no range shorter than this.
+const int MinimumRange = 1024;
+
+template<class T>
+QByteArray emitSerial(const T& value)
+{
+  YAML::Emitter out;
+  out << value;
+  return QByteArray(out.c_str(), int(out.size()));
+}
+
+// a mix of the elements that are hardest to join.
+QVariant element(int i)
+{
+  switch (i % 7) {
+  case 0:
+    return QStringLiteral("line one\nline two\n  indented line %1\n").arg(i);
+
+  case 1:
+    return QVariantMap();
+
+  case 2:
+    return QVariantList();
+
+  case 3: {
+    QVariantMap inner;
+    inner.insert(QStringLiteral("value"), i);
+    inner.insert(QStringLiteral("empty"), QVariantMap());
+    QVariantMap outer;
+    outer.insert(QStringLiteral("inner"), inner);
+    outer.insert(QStringLiteral("list"), QVariantList{ QStringLiteral("a\nb"), i });
+    return outer;
+  }
+
+  case 4:
+    return QVariant();
+
+  case 5:
+    return QVariantList{ QVariantList(), QStringLiteral("- not a sequence") };
+
+  default:
+    return QStringLiteral(" leading and trailing: # %1 ").arg(i);
+  }
+}
+
+/*
+   Keys sort in index order. The first and last key of every range are
+   longer than the 1024 characters yaml-cpp allows for a simple key, so
+   they are written as explicit "? " keys.
+*/
+QString key(int i)
+{
+  const QString name = QStringLiteral("key %1").arg(i, 6, 10, QLatin1Char('0'));
+
+  if (i % MinimumRange == 0 || i % MinimumRange == MinimumRange - 1) {
+    return name + QString(1100, QLatin1Char('k'));
+  }
+
+  if (i % 5 == 0) {
+    return name + QStringLiteral("\nsecond line");
+  }
+
+  return name;
+}
+
+} // end of anonymous namespace
+
+/* = Tests
+   ==========================================================================================*/
+class TestParallelEmitter : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void strings_data() { threads(); }
+  void strings();
+  void variants_data() { threads(); }
+  void variants();
+  void map_data() { threads(); }
+  void map();
+  void small();
+
+private:
+  /*
+     Each count is a multiple of MinimumRange and no more than four per
+     thread, so every range is exactly MinimumRange elements long.
+  */
+  void threads() {
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("count");
+    QTest::newRow("1 thread") << 1 << 4 * MinimumRange;
+    QTest::newRow("2 threads, 4 ranges") << 2 << 4 * MinimumRange;
+    QTest::newRow("3 threads, 9 ranges") << 3 << 9 * MinimumRange;
+    QTest::newRow("4 threads, 16 ranges") << 4 << 16 * MinimumRange;
+  }
+};
+
+void TestParallelEmitter::strings()
+{
+  QFETCH(int, threads);
+  QFETCH(int, count);
+  const QStringList samples = { QStringLiteral("line one\nline two\n"),
+                                QStringLiteral("  indented\n\n  twice\n"),
+                                QString(),
+                                QStringLiteral("- not a sequence"),
+                                QStringLiteral("key: value # comment") };
+  QList<QString> list;
+
+  for (int i = 0; i < count; ++i) {
+    list.append(samples.at(i % samples.size()));
+  }
+
+  QCOMPARE(QYaml::emitParallel(list, threads), emitSerial(list));
+}
+
+void TestParallelEmitter::variants()
+{
+  QFETCH(int, threads);
+  QFETCH(int, count);
+  QVector<QVariant> vector;
+
+  for (int i = 0; i < count; ++i) {
+    vector.append(element(i));
+  }
+
+  QCOMPARE(QYaml::emitParallel(vector, threads), emitSerial(vector));
+}
+
+void TestParallelEmitter::map()
+{
+  QFETCH(int, threads);
+  QFETCH(int, count);
+  QMap<QString, QVariant> map;
+
+  for (int i = 0; i < count; ++i) {
+    map.insert(key(i), element(i));
+  }
+
+  QCOMPARE(QYaml::emitParallel(map, threads), emitSerial(map));
+}
+
+// below the range threshold everything is emitted on the calling thread.
+void TestParallelEmitter::small()
+{
+  QMap<QString, QVariant> map;
+
+  for (int i = 0; i < 10; ++i) {
+    map.insert(key(i), element(i));
+  }
+
+  QCOMPARE(QYaml::emitParallel(map, 4), emitSerial(map));
+  QCOMPARE(QYaml::emitParallel(QMap<QString, QVariant>(), 4),
+           emitSerial(QMap<QString, QVariant>()));
+}
+
+QTEST_GUILESS_MAIN(TestParallelEmitter)
+
+#include "tst_parallelemitter.moc"
@@ -0,0 +1,183 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   DocumentIndex reads the indexed key from the document text with a line
+   scan and only parses the documents the scan cannot read. Whichever path
+   it takes, the value must be the one yaml-cpp parses.
+*/
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <yaml-cpp/yaml.h>
+
+#include <qyamlcpp/docindex.h>
+
+/* = Helpers
+   ==========================================================================================*/
+namespace {
+
+bool writeFile(const QString& fileName, const QByteArray& contents)
+{
+  QFile file(fileName);
+  return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+} // end of anonymous namespace
+
+/* = Tests
+   ==========================================================================================*/
+class TestDocumentIndex : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void init();
+  void findKey_data();
+  void findKey();
+  void inheritedDirectives();
+  void keyName();
+
+private:
+  QTemporaryDir m_dir;
+  QString m_fileName;
+};
+
+void TestDocumentIndex::init()
+{
+  QVERIFY(m_dir.isValid());
+  m_fileName = m_dir.filePath(QLatin1String(QTest::currentTestFunction()) +
+                              QStringLiteral(".yaml"));
+}
+
+void TestDocumentIndex::findKey_data()
+{
+  QTest::addColumn<QByteArray>("document");
+  QTest::addColumn<bool>("hasKey");
+  QTest::addColumn<QString>("key");
+
+  QTest::newRow("plain") << QByteArray("name: x\nid: plain value\n") << true
+                         << QStringLiteral("plain value");
+  QTest::newRow("double quoted key") << QByteArray("\"id\": value\n") << true
+                                     << QStringLiteral("value");
+  QTest::newRow("single quoted key") << QByteArray("'id': value\n") << true
+                                     << QStringLiteral("value");
+  QTest::newRow("single quoted value") << QByteArray("id: 'it''s'\n") << true
+                                       << QStringLiteral("it's");
+  QTest::newRow("escaped value") << QByteArray("id: \"a\\tb\"\n") << true
+                                 << QStringLiteral("a\tb");
+  QTest::newRow("key in open double quote")
+    << QByteArray("text: \"first\nid: not a key\n  end\"\nid: real\n") << true
+    << QStringLiteral("real");
+  QTest::newRow("key in open single quote")
+    << QByteArray("text: 'first\nid: not a key\n  end'\nid: real\n") << true
+    << QStringLiteral("real");
+  QTest::newRow("apostrophe in plain value") << QByteArray("note: don't\nid: real\n") << true
+                                             << QStringLiteral("real");
+  QTest::newRow("multi-line plain value") << QByteArray("id: first\n  second\nother: x\n")
+                                          << true << QStringLiteral("first second");
+  QTest::newRow("folded after blank line") << QByteArray("id: first\n\n  second\n") << true
+                                           << QStringLiteral("first\nsecond");
+  QTest::newRow("flow document") << QByteArray("--- {name: x, id: flow}\n") << true
+                                 << QStringLiteral("flow");
+  QTest::newRow("multi-line flow document") << QByteArray("{id: 42,\n name: y}\n") << true
+                                            << QStringLiteral("42");
+  QTest::newRow("comment after value") << QByteArray("id: abc # comment\n") << true
+                                       << QStringLiteral("abc");
+  QTest::newRow("indented comment after value")
+    << QByteArray("id: abc\n  # comment\nother: x\n") << true << QStringLiteral("abc");
+  QTest::newRow("crlf") << QByteArray("id: crlf value\r\nother: 1\r\n") << true
+                        << QStringLiteral("crlf value");
+  QTest::newRow("crlf quoted") << QByteArray("id: 'quoted'\r\n") << true
+                               << QStringLiteral("quoted");
+  QTest::newRow("nested key only") << QByteArray("outer:\n  id: nested\n") << false
+                                   << QString();
+  QTest::newRow("block value") << QByteArray("id:\n  - a\n") << false << QString();
+}
+
+void TestDocumentIndex::findKey()
+{
+  QFETCH(QByteArray, document);
+  QFETCH(bool, hasKey);
+  QFETCH(QString, key);
+  QVERIFY(writeFile(m_fileName, document));
+
+  QYaml::DocumentIndex index(m_fileName);
+  QVERIFY(index.build(QStringLiteral("id")));
+  QCOMPARE(index.count(), 1);
+  QCOMPARE(index.entry(0).hasKey, hasKey);
+  QCOMPARE(index.entry(0).key, key);
+
+  if (hasKey) {
+    const YAML::Node parsed = YAML::Load(document.toStdString());
+    QCOMPARE(index.entry(0).key, QString::fromStdString(parsed["id"].Scalar()));
+  }
+}
+
+// yaml-cpp keeps the directives of the document before.
+void TestDocumentIndex::inheritedDirectives()
+{
+  QVERIFY(writeFile(m_fileName,
+                    "%TAG !e! tag:example.com,2000:\n--- !e!a\nid: 1\n--- !e!b\nid: 2\n"
+                    "...\n%YAML 1.2\n--- !e!c\nid: 3\n"));
+
+  QYaml::DocumentIndex built(m_fileName);
+  QVERIFY(built.build(QStringLiteral("id")));
+  QVERIFY(built.save());
+
+  QYaml::DocumentIndex loaded(m_fileName);
+  QVERIFY(loaded.load(QStringLiteral("id")));
+
+  for (QYaml::DocumentIndex* index : { &built, &loaded }) {
+    QCOMPARE(index->count(), 3);
+    QCOMPARE(index->loadDocument(0).Tag(), std::string("tag:example.com,2000:a"));
+    QCOMPARE(index->loadDocument(1).Tag(), std::string("tag:example.com,2000:b"));
+    QCOMPARE(index->loadDocument(2).Tag(), std::string("!e!c"));
+    QCOMPARE(index->loadByKey(QStringLiteral("2")).size(), std::size_t(1));
+  }
+}
+
+void TestDocumentIndex::keyName()
+{
+  QVERIFY(writeFile(m_fileName, "id: 1\nname: a\n---\nid: 2\nname: b\n"));
+
+  QYaml::DocumentIndex built(m_fileName);
+  QVERIFY(built.build(QStringLiteral("id")));
+  QVERIFY(built.save());
+
+  QYaml::DocumentIndex index(m_fileName);
+  QVERIFY(!index.load(QStringLiteral("name")));
+  QCOMPARE(index.count(), 0);
+  QVERIFY(index.load());
+  QCOMPARE(index.keyName(), QStringLiteral("id"));
+  QVERIFY(index.load(QStringLiteral("id")));
+  QCOMPARE(index.indicesOf(QStringLiteral("2")), QList<int>{ 1 });
+}
+
+QTEST_GUILESS_MAIN(TestDocumentIndex)
+
+#include "tst_docindex.moc"
@@ -0,0 +1,146 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   FootprintReport walks the top levels itself, so its totals must match
+   footprint() for the same value at every depth.
+*/
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QtTest>
+
+#include <yaml-cpp/yaml.h>
+
+#include <qyamlcpp/footprint.h>
+
+/* = Helpers
+   ==========================================================================================*/
+namespace {
+
+QVariant tree()
+{
+  QVariantMap point;
+  point.insert(QStringLiteral("name"), QStringLiteral("a point with a long enough name"));
+  point.insert(QStringLiteral("x"), 1.5);
+  point.insert(QStringLiteral("data"), QByteArray(64, 'b'));
+
+  QVariantList points;
+
+  for (int i = 0; i < 10; ++i) {
+    points.append(point);
+  }
+
+  QVariantList nested;
+  nested.append(QVariant(points));
+  nested.append(QStringLiteral("text"));
+
+  QVariantMap root;
+  root.insert(QStringLiteral("points"), points);
+  root.insert(QStringLiteral("nested"), nested);
+  root.insert(QStringLiteral("count"), 10);
+  return root;
+}
+
+} // end of anonymous namespace
+
+/* = Tests
+   ==========================================================================================*/
+class TestFootprint : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void variant_data();
+  void variant();
+  void node_data();
+  void node();
+};
+
+void TestFootprint::variant_data()
+{
+  QTest::addColumn<QVariant>("value");
+  QTest::addColumn<int>("depth");
+
+  const QVariant root = tree();
+  const QVariant points = root.toMap().value(QStringLiteral("points"));
+  const QVariant text = QStringLiteral("just a string");
+
+  for (int depth = 0; depth <= 4; ++depth) {
+    const QByteArray suffix = " at depth " + QByteArray::number(depth);
+    QTest::newRow(("tree" + suffix).constData()) << root << depth;
+    QTest::newRow(("list" + suffix).constData()) << points << depth;
+    QTest::newRow(("string" + suffix).constData()) << text << depth;
+  }
+}
+
+void TestFootprint::variant()
+{
+  QFETCH(QVariant, value);
+  QFETCH(int, depth);
+
+  const QYaml::Footprint expected = QYaml::footprint(value);
+  const QYaml::Footprint measured = QYaml::FootprintReport::measure(value, depth).total();
+
+  QCOMPARE(measured.nodes, expected.nodes);
+  QCOMPARE(measured.nodeBytes, expected.nodeBytes);
+  QCOMPARE(measured.stringBytes, expected.stringBytes);
+  QCOMPARE(measured.binaryBytes, expected.binaryBytes);
+}
+
+void TestFootprint::node_data()
+{
+  QTest::addColumn<QByteArray>("yaml");
+  QTest::addColumn<int>("depth");
+
+  const QByteArray document = "points:\n"
+                              "  - { name: a point with a long enough name, x: 1.5 }\n"
+                              "  - { name: another point with a long name, x: 2.5 }\n"
+                              "data: !!binary aGVsbG8gd29ybGQgaGVsbG8gd29ybGQgaGVsbG8=\n"
+                              "nested: [[1, 2, [3, 4]], text]\n";
+
+  for (int depth = 0; depth <= 4; ++depth) {
+    QTest::newRow(("depth " + QByteArray::number(depth)).constData())
+      << document << depth;
+  }
+}
+
+void TestFootprint::node()
+{
+  QFETCH(QByteArray, yaml);
+  QFETCH(int, depth);
+
+  const YAML::Node root = YAML::Load(yaml.constData());
+  const QYaml::Footprint expected = QYaml::footprint(root);
+  const QYaml::Footprint measured = QYaml::FootprintReport::measure(root, depth).total();
+
+  QCOMPARE(measured.nodes, expected.nodes);
+  QCOMPARE(measured.nodeBytes, expected.nodeBytes);
+  QCOMPARE(measured.stringBytes, expected.stringBytes);
+  QCOMPARE(measured.binaryBytes, expected.binaryBytes);
+}
+
+QTEST_MAIN(TestFootprint)
+
+#include "tst_footprint.moc"
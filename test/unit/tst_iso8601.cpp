@@ -0,0 +1,273 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   The fixed layout ISO 8601 parser and formatter in iso8601.h, which the
+   QDate, QTime and QDateTime converters use before falling back to Qt.
+*/
+#include <QDate>
+#include <QDateTime>
+#include <QTime>
+#include <QtTest>
+
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include <qyamlcpp/emitter.h>
+#include <qyamlcpp/iso8601.h>
+#include <qyamlcpp/node.h>
+
+/* = Helpers
+   ==========================================================================================*/
+namespace {
+
+bool parseDate(const QByteArray& text, QDate& date)
+{
+  return QYaml::Iso8601::parseDate(text.constData(), std::size_t(text.size()), date);
+}
+
+bool parseDateTime(const QByteArray& text, QDateTime& dateTime)
+{
+  return QYaml::Iso8601::parseDateTime(text.constData(), std::size_t(text.size()), dateTime);
+}
+
+QByteArray formatDate(const QDate& date)
+{
+  char buffer[QYaml::Iso8601::DateLength];
+  return QByteArray(buffer, QYaml::Iso8601::formatDate(date, buffer));
+}
+
+QByteArray formatDateTime(const QDateTime& dateTime)
+{
+  char buffer[QYaml::Iso8601::DateTimeLength];
+  return QByteArray(buffer, QYaml::Iso8601::formatDateTime(dateTime, buffer));
+}
+
+QDateTime offsetDateTime(const QDate& date, const QTime& time, int offset)
+{
+  return QDateTime(date, time, Qt::OffsetFromUTC, offset);
+}
+
+} // end of anonymous namespace
+
+/* = Tests
+   ==========================================================================================*/
+class TestIso8601 : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void dates_data();
+  void dates();
+  void dateTimes_data();
+  void dateTimes();
+  void fromQt_data();
+  void fromQt();
+  void roundTrip_data();
+  void roundTrip();
+  void converters();
+};
+
+void TestIso8601::dates_data()
+{
+  QTest::addColumn<QByteArray>("text");
+  QTest::addColumn<QDate>("date");
+
+  QTest::newRow("plain") << QByteArray("2020-06-01") << QDate(2020, 6, 1);
+  QTest::newRow("leap day") << QByteArray("2020-02-29") << QDate(2020, 2, 29);
+  QTest::newRow("leap day 2000") << QByteArray("2000-02-29") << QDate(2000, 2, 29);
+  QTest::newRow("no leap day 2019") << QByteArray("2019-02-29") << QDate();
+  QTest::newRow("no leap day 1900") << QByteArray("1900-02-29") << QDate();
+  QTest::newRow("month 13") << QByteArray("2020-13-01") << QDate();
+  QTest::newRow("day 0") << QByteArray("2020-01-00") << QDate();
+  QTest::newRow("year 0") << QByteArray("0000-01-01") << QDate();
+  QTest::newRow("year 1") << QByteArray("0001-01-01") << QDate(1, 1, 1);
+  QTest::newRow("1 BC") << QByteArray("+00000-01-01") << QDate(-1, 1, 1);
+  QTest::newRow("44 BC") << QByteArray("-00043-03-15") << QDate(-44, 3, 15);
+  QTest::newRow("5 BC leap day") << QByteArray("-00004-02-29") << QDate(-5, 2, 29);
+  QTest::newRow("4 BC no leap day") << QByteArray("-00003-02-29") << QDate();
+  QTest::newRow("year 12345") << QByteArray("+12345-06-07") << QDate(12345, 6, 7);
+  QTest::newRow("short expanded year") << QByteArray("+1234-01-01") << QDate();
+  QTest::newRow("trailing text") << QByteArray("2020-06-01x") << QDate();
+}
+
+void TestIso8601::dates()
+{
+  QFETCH(QByteArray, text);
+  QFETCH(QDate, date);
+  QDate parsed;
+
+  QCOMPARE(parseDate(text, parsed), date.isValid());
+
+  if (date.isValid()) {
+    QCOMPARE(parsed, date);
+    QCOMPARE(formatDate(date), text);
+  }
+}
+
+void TestIso8601::dateTimes_data()
+{
+  QTest::addColumn<QByteArray>("text");
+  QTest::addColumn<QDateTime>("dateTime");
+  const QDate date(2020, 6, 1);
+
+  QTest::newRow("utc") << QByteArray("2020-06-01T13:45:30Z")
+                       << QDateTime(date, QTime(13, 45, 30), Qt::UTC);
+  QTest::newRow("lower case") << QByteArray("2020-06-01t13:45:30z")
+                              << QDateTime(date, QTime(13, 45, 30), Qt::UTC);
+  QTest::newRow("space") << QByteArray("2020-06-01 13:45:30Z")
+                         << QDateTime(date, QTime(13, 45, 30), Qt::UTC);
+  QTest::newRow("local") << QByteArray("2020-06-01T13:45:30")
+                         << QDateTime(date, QTime(13, 45, 30));
+  QTest::newRow("date only") << QByteArray("2020-06-01") << QDateTime(date, QTime(0, 0));
+  QTest::newRow("no seconds") << QByteArray("2020-06-01T13:45Z")
+                              << QDateTime(date, QTime(13, 45), Qt::UTC);
+  QTest::newRow("+hh") << QByteArray("2020-06-01T13:45:30+02")
+                       << offsetDateTime(date, QTime(13, 45, 30), 7200);
+  QTest::newRow("+hhmm") << QByteArray("2020-06-01T13:45:30+0230")
+                         << offsetDateTime(date, QTime(13, 45, 30), 9000);
+  QTest::newRow("-hh:mm") << QByteArray("2020-06-01T13:45:30-05:30")
+                          << offsetDateTime(date, QTime(13, 45, 30), -19800);
+  QTest::newRow("+00:00") << QByteArray("2020-06-01T13:45:30+00:00")
+                          << offsetDateTime(date, QTime(13, 45, 30), 0);
+  QTest::newRow("offset past midnight") << QByteArray("2020-06-01T23:30:00-02:00")
+                                        << offsetDateTime(date, QTime(23, 30), -7200);
+  QTest::newRow("fraction 1") << QByteArray("2020-06-01T13:45:30.1Z")
+                              << QDateTime(date, QTime(13, 45, 30, 100), Qt::UTC);
+  QTest::newRow("fraction 3") << QByteArray("2020-06-01T13:45:30.250Z")
+                              << QDateTime(date, QTime(13, 45, 30, 250), Qt::UTC);
+  QTest::newRow("fraction 6") << QByteArray("2020-06-01T13:45:30.123456Z")
+                              << QDateTime(date, QTime(13, 45, 30, 123), Qt::UTC);
+  QTest::newRow("comma fraction") << QByteArray("2020-06-01T13:45:30,5Z")
+                                  << QDateTime(date, QTime(13, 45, 30, 500), Qt::UTC);
+  QTest::newRow("leap day") << QByteArray("2024-02-29T12:00:00Z")
+                            << QDateTime(QDate(2024, 2, 29), QTime(12, 0), Qt::UTC);
+  QTest::newRow("44 BC") << QByteArray("-00043-03-15T12:00:00Z")
+                         << QDateTime(QDate(-44, 3, 15), QTime(12, 0), Qt::UTC);
+  QTest::newRow("year 10000") << QByteArray("+10000-01-01T00:00:00+01:00")
+                              << offsetDateTime(QDate(10000, 1, 1), QTime(0, 0), 3600);
+  QTest::newRow("year 0") << QByteArray("0000-01-01T00:00:00Z") << QDateTime();
+  QTest::newRow("hour 24") << QByteArray("2020-06-01T24:00:00Z") << QDateTime();
+  QTest::newRow("offset hour 24") << QByteArray("2020-06-01T12:00:00+24:00") << QDateTime();
+  QTest::newRow("empty fraction") << QByteArray("2020-06-01T12:00:00.Z") << QDateTime();
+  QTest::newRow("bad separator") << QByteArray("2020-06-01X12:00:00Z") << QDateTime();
+}
+
+void TestIso8601::dateTimes()
+{
+  QFETCH(QByteArray, text);
+  QFETCH(QDateTime, dateTime);
+  QDateTime parsed;
+
+  QCOMPARE(parseDateTime(text, parsed), dateTime.isValid());
+
+  if (dateTime.isValid()) {
+    QCOMPARE(parsed, dateTime);
+    QCOMPARE(parsed.timeSpec(), dateTime.timeSpec());
+    QCOMPARE(parsed.offsetFromUtc(), dateTime.offsetFromUtc());
+  }
+}
+
+// the layouts both accept must give the same result as Qt::ISODate.
+void TestIso8601::fromQt_data()
+{
+  QTest::addColumn<QByteArray>("text");
+
+  QTest::newRow("utc") << QByteArray("2020-06-01T13:45:30Z");
+  QTest::newRow("local") << QByteArray("2020-06-01T13:45:30");
+  QTest::newRow("date only") << QByteArray("2020-06-01");
+  QTest::newRow("no seconds") << QByteArray("2020-06-01T13:45");
+  QTest::newRow("milliseconds") << QByteArray("2020-06-01T13:45:30.250Z");
+  QTest::newRow("+hh:mm") << QByteArray("2020-06-01T13:45:30.250+02:00");
+  QTest::newRow("-hhmm") << QByteArray("1999-12-31T23:59:59-0530");
+  QTest::newRow("leap day") << QByteArray("2000-02-29T00:00:00Z");
+  QTest::newRow("year 1") << QByteArray("0001-01-01T00:00:00Z");
+  QTest::newRow("year 9999") << QByteArray("9999-12-31T23:59:59.999Z");
+}
+
+void TestIso8601::fromQt()
+{
+  QFETCH(QByteArray, text);
+  const QDateTime expected = QDateTime::fromString(QString::fromLatin1(text), Qt::ISODate);
+  QDateTime parsed;
+
+  QVERIFY(expected.isValid());
+  QVERIFY(parseDateTime(text, parsed));
+  QCOMPARE(parsed, expected);
+  QCOMPARE(parsed.offsetFromUtc(), expected.offsetFromUtc());
+}
+
+void TestIso8601::roundTrip_data()
+{
+  QTest::addColumn<QDateTime>("dateTime");
+
+  QTest::newRow("utc") << QDateTime(QDate(2020, 6, 1), QTime(13, 45, 30, 250), Qt::UTC);
+  QTest::newRow("local") << QDateTime(QDate(2020, 6, 1), QTime(13, 45, 30));
+  QTest::newRow("offset") << offsetDateTime(QDate(2020, 6, 1), QTime(13, 45), -12600);
+  QTest::newRow("1 BC") << QDateTime(QDate(-1, 12, 31), QTime(23, 59, 59), Qt::UTC);
+  QTest::newRow("4714 BC") << QDateTime(QDate(-4714, 11, 24), QTime(12, 0), Qt::UTC);
+  QTest::newRow("year 10000") << offsetDateTime(QDate(10000, 1, 1), QTime(0, 0), 3600);
+  QTest::newRow("year 123456") << QDateTime(QDate(123456, 7, 8), QTime(9, 10), Qt::UTC);
+}
+
+void TestIso8601::roundTrip()
+{
+  QFETCH(QDateTime, dateTime);
+  const QByteArray text = formatDateTime(dateTime);
+  QDateTime parsed;
+
+  QVERIFY(!text.isEmpty());
+  QVERIFY2(parseDateTime(text, parsed), text.constData());
+  QCOMPARE(parsed, dateTime);
+  QCOMPARE(parsed.offsetFromUtc(), dateTime.offsetFromUtc());
+
+  QDate date;
+  QVERIFY(parseDate(formatDate(dateTime.date()), date));
+  QCOMPARE(date, dateTime.date());
+}
+
+// years Qt::ISODate cannot write survive the converters and the Emitter.
+void TestIso8601::converters()
+{
+  const QDate date(-44, 3, 15);
+  const QDateTime dateTime(QDate(12345, 6, 7), QTime(8, 9, 10), Qt::UTC);
+
+  YAML::Node node;
+  node["date"] = date;
+  node["dateTime"] = dateTime;
+  QCOMPARE(node["date"].Scalar(), std::string("-00043-03-15"));
+  QCOMPARE(node["date"].as<QDate>(), date);
+  QCOMPARE(node["dateTime"].as<QDateTime>(), dateTime);
+
+  YAML::Emitter out;
+  out << YAML::BeginSeq << date << dateTime << YAML::EndSeq;
+  const YAML::Node loaded = YAML::Load(out.c_str());
+  QCOMPARE(loaded[0].as<QDate>(), date);
+  QCOMPARE(loaded[1].as<QDateTime>(), dateTime);
+}
+
+QTEST_GUILESS_MAIN(TestIso8601)
+
+#include "tst_iso8601.moc"
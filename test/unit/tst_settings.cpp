@@ -0,0 +1,132 @@
+/*
+  Copyright 2013-2020 Simon Meaden
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+                                                of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+                                                          copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    @author: Simon Meaden
+
+*/
+/*
+   Values written by SettingsFormat and SettingsFile must read back as the
+   same QVariant type where the format keeps it, in particular the
+   QByteArray that QWidget::saveGeometry() and saveState() return.
+*/
+#include <QByteArray>
+#include <QColor>
+#include <QString>
+#include <QTemporaryDir>
+#include <QVariant>
+#include <QtTest>
+
+#include <qyamlcpp/settings.h>
+
+/* = Helpers
+   ==========================================================================================*/
+namespace {
+
+// every byte value, as saveGeometry() output may contain any of them.
+QByteArray allBytes()
+{
+  QByteArray bytes;
+
+  for (int i = 0; i < 256; ++i) {
+    bytes.append(char(i));
+  }
+
+  return bytes;
+}
+
+} // end of anonymous namespace
+
+/* = Tests
+   ==========================================================================================*/
+class TestSettings : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void byteArray_data();
+  void byteArray();
+  void settingsFile();
+  void binaryTag();
+};
+
+void TestSettings::byteArray_data()
+{
+  QTest::addColumn<QByteArray>("bytes");
+  QTest::newRow("empty") << QByteArray("");
+  QTest::newRow("text") << QByteArray("window state");
+  QTest::newRow("all bytes") << allBytes();
+}
+
+void TestSettings::byteArray()
+{
+  QFETCH(QByteArray, bytes);
+  QSettings::SettingsMap written;
+  written.insert(QStringLiteral("window/geometry"), bytes);
+  written.insert(QStringLiteral("window/title"), QStringLiteral("main"));
+
+  QSettings::SettingsMap read;
+  QVERIFY(QYaml::SettingsFormat::parse(QYaml::SettingsFormat::serialize(written), read));
+
+  const QVariant geometry = read.value(QStringLiteral("window/geometry"));
+  QCOMPARE(geometry.userType(), int(QMetaType::QByteArray));
+  QCOMPARE(geometry.toByteArray(), bytes);
+  QCOMPARE(read.value(QStringLiteral("window/title")).toString(), QStringLiteral("main"));
+}
+
+void TestSettings::settingsFile()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath(QStringLiteral("settings.yaml"));
+  const QByteArray state = allBytes();
+
+  {
+    QYaml::SettingsFile settings(fileName);
+    settings.setValue(QStringLiteral("window/state"), state);
+    settings.setValue(QStringLiteral("window/color"), QColor(200, 100, 50));
+    QVERIFY(settings.sync());
+  }
+
+  QYaml::SettingsFile settings(fileName);
+  const QVariant value = settings.value(QStringLiteral("window/state"));
+  QCOMPARE(value.userType(), int(QMetaType::QByteArray));
+  QCOMPARE(value.toByteArray(), state);
+  QCOMPARE(settings.value(QStringLiteral("window/color")).value<QColor>(), QColor(200, 100, 50));
+}
+
+// untagged base64 text is a string like any other scalar.
+void TestSettings::binaryTag()
+{
+  QVariant value;
+
+  QVERIFY(YAML::convert<QVariant>::decode(YAML::Load("d2luZG93"), value));
+  QCOMPARE(value.userType(), int(QMetaType::QString));
+
+  QVERIFY(YAML::convert<QVariant>::decode(YAML::Load("!!binary d2luZG93"), value));
+  QCOMPARE(value.userType(), int(QMetaType::QByteArray));
+  QCOMPARE(value.toByteArray(), QByteArray("window"));
+
+  QVERIFY(!YAML::convert<QVariant>::decode(YAML::Load("!!binary not*base64"), value));
+}
+
+QTEST_MAIN(TestSettings)
+
+#include "tst_settings.moc"